@@ -0,0 +1,18 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_BUFFERED_VTAB_INCLUDED
+#define HEADER_SQLITEPP_BUFFERED_VTAB_INCLUDED
+
+#include <thinsqlitepp/impl/buffered_vtab_iface.hpp>
+
+#include <thinsqlitepp/impl/vtab_impl.hpp>
+#include <thinsqlitepp/impl/buffered_vtab_impl.hpp>
+#include <thinsqlitepp/impl/exception_impl.hpp>
+
+#endif
@@ -0,0 +1,16 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_BUSY_POLICY_INCLUDED
+#define HEADER_SQLITEPP_BUSY_POLICY_INCLUDED
+
+#include <thinsqlitepp/impl/busy_policy_iface.hpp>
+
+#include <thinsqlitepp/impl/busy_policy_impl.hpp>
+
+#endif
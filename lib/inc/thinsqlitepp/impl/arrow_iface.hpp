@@ -0,0 +1,339 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_ARROW_IFACE_INCLUDED
+#define HEADER_SQLITEPP_ARROW_IFACE_INCLUDED
+
+#include "vtab_iface.hpp"
+#include "statement_iface.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+/** @cond PRIVATE */
+
+/*
+ Arrow C Data Interface and C Stream Interface ABI as defined in
+ https://arrow.apache.org/docs/format/CDataInterface.html and
+ https://arrow.apache.org/docs/format/CStreamInterface.html
+
+ The guards are the ones mandated by the specification so these definitions
+ co-exist with any other copy, such as the one in Arrow's own abi.h
+*/
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+    // Callbacks providing stream functionality
+    int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+    int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+    const char* (*get_last_error)(struct ArrowArrayStream*);
+
+    // Release callback
+    void (*release)(struct ArrowArrayStream*);
+
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#endif  // ARROW_C_STREAM_INTERFACE
+
+/** @endcond */
+
+namespace thinsqlitepp
+{
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Exports statement results in [Arrow C Data Interface](https://arrow.apache.org/docs/format/CDataInterface.html)
+     * format
+     *
+     * Rows are stepped in batches directly into Arrow columnar buffers, producing one record batch
+     * (a struct array with one child per result column) per call to export_batch(). No Arrow library is
+     * needed: the produced `ArrowSchema` and `ArrowArray` structures can be handed to any Arrow
+     * implementation (pyarrow, arrow-cpp, DuckDB, Polars etc.) which takes ownership of them.
+     * ```
+     * auto stmt = statement::create(*db, "SELECT id, price, name FROM items");
+     * arrow_exporter exporter(*stmt);
+     * ArrowSchema schema;
+     * exporter.export_schema(&schema);
+     * ArrowArray batch;
+     * while (exporter.export_batch(&batch))
+     *     consume(&batch);
+     * ```
+     * Alternatively export_stream() wraps the whole statement into an `ArrowArrayStream`.
+     *
+     * Arrow columns have a single type while SQLite values do not. The type of each column is taken from
+     * the declared type of the result column, following SQLite affinity rules: `INTEGER` affinity produces
+     * `int64`, `REAL` `float64`, `TEXT` `large_utf8` and a `BLOB` declared type `large_binary`. For columns
+     * with `NUMERIC` or no affinity (e.g. expressions) the type of the value in the first row is used, with
+     * `NULL` treated as text. A value of a different type is not converted: export_batch() fails with
+     * #SQLITE_MISMATCH instead. Use `CAST` in the query to force the type of such columns. All columns are
+     * nullable.
+     *
+     * The exporter does not reset the statement. It must not be used concurrently with other uses of the
+     * statement and the statement must outlive it.
+     *
+     * `#include <thinsqlitepp/arrow.hpp>`
+     */
+    class arrow_exporter
+    {
+    public:
+        /// Default maximum number of rows in a batch
+        static constexpr size_t default_batch_size = 65536;
+    public:
+        /**
+         * Create an exporter for a statement
+         *
+         * @param stmt statement to export. It should be prepared and bound but not stepped yet.
+         * @param batch_size maximum number of rows in each batch
+         */
+        arrow_exporter(statement & stmt, size_t batch_size = default_batch_size) noexcept:
+            _stmt(stmt),
+            _batch_size(batch_size ? batch_size : 1)
+        {}
+
+        /**
+         * Fill the schema of the produced batches
+         *
+         * This may step the statement to determine column types. The caller owns the output
+         * and must release it.
+         */
+        void export_schema(ArrowSchema * out);
+
+        /**
+         * Produce the next batch
+         *
+         * @returns true if a batch has been produced, false if there are no more rows. In the later case
+         * @p out is not touched. The caller owns the output and must release it.
+         */
+        bool export_batch(ArrowArray * out);
+
+        /**
+         * Export a statement as an `ArrowArrayStream`
+         *
+         * The stream takes ownership of the statement. Errors are reported via the stream's
+         * `get_last_error` callback. The consumer must release the stream before the database is closed.
+         */
+        static void export_stream(std::unique_ptr<statement> stmt, ArrowArrayStream * out,
+                                  size_t batch_size = default_batch_size);
+    private:
+        struct column_data;
+        struct batch_data;
+        struct schema_data;
+        struct stream_data;
+
+        void resolve_formats();
+        char format_from_value(int idx) const noexcept;
+        static int storage_class(char format) noexcept;
+        void append_row(std::vector<column_data> & columns, size_t row);
+
+        static void release_schema(ArrowSchema * schema) noexcept;
+        static void release_column(ArrowArray * array) noexcept;
+        static void release_batch(ArrowArray * array) noexcept;
+    private:
+        statement & _stmt;
+        size_t _batch_size;
+        //one Arrow format character per column
+        std::string _formats;
+        bool _resolved = false;
+        //the statement is positioned on a row that has not been exported yet
+        bool _pending = false;
+        bool _done = false;
+    };
+
+    /**
+     * A source of Arrow record batches for @ref arrow_table
+     *
+     * Takes ownership of an [Arrow C Stream](https://arrow.apache.org/docs/format/CStreamInterface.html),
+     * validates its schema and pulls batches from it lazily as they are needed. Batches are retained so
+     * that the data can be scanned more than once and all values are read directly from the Arrow buffers.
+     *
+     * Supported column types are: boolean, signed and unsigned integers (exposed as `INTEGER`, with `uint64`
+     * values above `INT64_MAX` becoming `REAL`), `float32`/`float64` (`REAL`), `utf8`/`large_utf8` (`TEXT`),
+     * `binary`/`large_binary` (`BLOB`) and `null`. Dictionary encoded and nested columns are not supported.
+     *
+     * `#include <thinsqlitepp/arrow.hpp>`
+     */
+    class arrow_source
+    {
+    public:
+        /**
+         * Take ownership of a stream
+         *
+         * On success the stream is moved into this object and @p stream is marked released.
+         *
+         * @throws exception if the stream cannot be read or its schema is not supported
+         */
+        arrow_source(ArrowArrayStream * stream);
+        ~arrow_source() noexcept;
+
+        arrow_source(const arrow_source &) = delete;
+        arrow_source & operator=(const arrow_source &) = delete;
+
+        /// Number of columns
+        size_t columns() const noexcept
+            { return size_t(_schema.n_children); }
+
+        /// Name of a column
+        const char * column_name(size_t idx) const noexcept
+            { return _schema.children[idx]->name; }
+
+        /// Arrow format string of a column
+        const char * column_format(size_t idx) const noexcept
+            { return _schema.children[idx]->format; }
+
+        /// Returns `CREATE TABLE` statement describing the columns suitable for database::declare_vtab
+        std::string declaration() const;
+
+        /**
+         * Make sure the batch containing a row has been read
+         *
+         * @returns false if there is no such row
+         * @throws exception if reading the stream fails
+         */
+        bool fetch(int64_t row);
+
+        /// Number of rows read so far
+        int64_t rows() const noexcept
+            { return _starts.back(); }
+
+        /// Whether the whole stream has been read
+        bool complete() const noexcept
+            { return !_stream.release; }
+
+        /// Index of the batch containing a row that has already been read
+        size_t batch_of(int64_t row) const noexcept;
+
+        /// First row of a batch
+        int64_t batch_start(size_t idx) const noexcept
+            { return _starts[idx]; }
+
+        /// Set the result of a function to a value in a batch that has been read
+        void result(context & ctxt, size_t batch, int64_t row_in_batch, size_t column) const noexcept;
+    private:
+        void fail(int code, const char * what);
+        void close_stream() noexcept;
+    private:
+        ArrowArrayStream _stream;
+        ArrowSchema _schema;
+        std::vector<ArrowArray> _batches;
+        //first row of each batch followed by total number of rows read
+        std::vector<int64_t> _starts{0};
+    };
+
+    /**
+     * A read-only virtual table over Arrow record batches
+     *
+     * The data comes from an @ref arrow_source passed to create_module(). Values are produced directly
+     * from the Arrow buffers without copying. The table rowid is the row's 0-based index in the stream.
+     * ```
+     * ArrowArrayStream stream = ...; //obtained from any Arrow producer
+     * arrow_source source(&stream);
+     * arrow_table::create_module(*db, "trades", &source);
+     *
+     * db->exec("SELECT symbol, sum(qty) FROM trades GROUP BY symbol", ...);
+     * ```
+     * With SQLite 3.9 or above the module is eponymous and can be queried directly. With older versions
+     * use `CREATE VIRTUAL TABLE temp.name USING module_name` first. The source must outlive the module.
+     *
+     * `#include <thinsqlitepp/arrow.hpp>`
+     */
+    class arrow_table : public vtab<arrow_table>
+    {
+    public:
+        using constructor_data_type = arrow_source *;
+    public:
+        arrow_table(
+        #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 9, 0)
+            connect_t,
+        #endif
+            database * db, arrow_source * source, int argc, const char * const * argv);
+
+        bool best_index(index_info<> & info) const;
+
+        class cursor : public vtab::cursor
+        {
+        public:
+            using vtab::cursor::cursor;
+
+            void filter(int idx, int argc, value ** argv);
+
+            bool eof() const noexcept
+                { return _row >= _last; }
+
+            void next();
+
+            int64_t rowid() const
+                { return _row; }
+
+            void column(context & ctxt, int idx) const;
+        private:
+            void load_row();
+        private:
+            int64_t _row = 0;
+            int64_t _last = 0;
+            size_t _batch = 0;
+        };
+    private:
+        arrow_source * _source;
+    };
+
+    /** @} */
+}
+
+#endif
@@ -0,0 +1,741 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_ARROW_IMPL_INCLUDED
+#define HEADER_SQLITEPP_ARROW_IMPL_INCLUDED
+
+#include "arrow_iface.hpp"
+#include "constraint_bound.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <new>
+
+#include <ctype.h>
+#include <errno.h>
+#include <string.h>
+
+namespace thinsqlitepp
+{
+    //MARK: - arrow_exporter
+
+    /** @cond PRIVATE */
+
+    struct arrow_exporter::column_data
+    {
+        char format;
+        std::vector<uint8_t> validity;
+        int64_t null_count = 0;
+        //values for 'l' columns or offsets for 'U' and 'Z' ones
+        std::vector<int64_t> integers;
+        std::vector<double> reals;
+        std::vector<char> bytes;
+        const void * buffers[3] = {};
+
+        column_data(char fmt, size_t reserve): format(fmt)
+        {
+            validity.reserve((reserve + 7) / 8);
+            switch(format)
+            {
+                case 'l':
+                    integers.reserve(reserve);
+                    break;
+                case 'g':
+                    reals.reserve(reserve);
+                    break;
+                default:
+                    integers.reserve(reserve + 1);
+                    integers.push_back(0);
+                    //buffers must not be null even when empty
+                    bytes.reserve(1);
+            }
+        }
+    };
+
+    struct arrow_exporter::batch_data
+    {
+        std::vector<ArrowArray> children;
+        std::vector<ArrowArray *> child_ptrs;
+        const void * buffers[1] = {nullptr};
+    };
+
+    struct arrow_exporter::schema_data
+    {
+        std::string name;
+        std::vector<ArrowSchema> children;
+        std::vector<ArrowSchema *> child_ptrs;
+    };
+
+    struct arrow_exporter::stream_data
+    {
+        std::unique_ptr<statement> stmt;
+        arrow_exporter exporter;
+        std::string error;
+
+        stream_data(std::unique_ptr<statement> s, size_t batch_size):
+            stmt(std::move(s)),
+            exporter(*stmt, batch_size)
+        {}
+
+        template<class Func>
+        int invoke(Func func) noexcept
+        {
+            try
+            {
+                error.clear();
+                func();
+                return 0;
+            }
+            catch(std::bad_alloc &)
+            {
+                return ENOMEM;
+            }
+            catch(std::exception & ex)
+            {
+                try { error = ex.what(); } catch(...) {}
+                return EIO;
+            }
+        }
+    };
+
+    /** @endcond */
+
+    inline void arrow_exporter::resolve_formats()
+    {
+        if (_resolved)
+            return;
+
+        //the first row is needed to guess types that are not declared
+        if (!_pending && !_done)
+        {
+            _pending = _stmt.step();
+            _done = !_pending;
+        }
+
+        const int count = _stmt.column_count();
+        _formats.assign(size_t(count), 'U');
+        for (int i = 0; i < count; ++i)
+        {
+            std::string declared;
+            if (const char * decl = _stmt.column_declared_type(i))
+                declared = decl;
+            std::transform(declared.begin(), declared.end(), declared.begin(), [](char c) {
+                return char(toupper((unsigned char)c));
+            });
+
+            //same rules SQLite uses to determine column affinity
+            char format = 0;
+            if (declared.find("INT") != declared.npos)
+                format = 'l';
+            else if (declared.find("CHAR") != declared.npos ||
+                     declared.find("CLOB") != declared.npos ||
+                     declared.find("TEXT") != declared.npos)
+                format = 'U';
+            else if (declared.find("BLOB") != declared.npos)
+                format = 'Z';
+            else if (declared.find("REAL") != declared.npos ||
+                     declared.find("FLOA") != declared.npos ||
+                     declared.find("DOUB") != declared.npos)
+                format = 'g';
+
+            _formats[size_t(i)] = format ? format : format_from_value(i);
+        }
+        _resolved = true;
+    }
+
+    inline int arrow_exporter::storage_class(char format) noexcept
+    {
+        switch(format)
+        {
+            case 'l': return SQLITE_INTEGER;
+            case 'g': return SQLITE_FLOAT;
+            case 'Z': return SQLITE_BLOB;
+            default:  return SQLITE_TEXT;
+        }
+    }
+
+    inline char arrow_exporter::format_from_value(int idx) const noexcept
+    {
+        if (!_pending)
+            return 'U';
+        switch(_stmt.column_type(idx))
+        {
+            case SQLITE_INTEGER: return 'l';
+            case SQLITE_FLOAT:   return 'g';
+            case SQLITE_BLOB:    return 'Z';
+            default:             return 'U';
+        }
+    }
+
+    inline void arrow_exporter::export_schema(ArrowSchema * out)
+    {
+        resolve_formats();
+
+        const size_t count = _formats.size();
+        auto data = std::make_unique<schema_data>();
+        data->children.resize(count);
+        data->child_ptrs.resize(count);
+
+        std::vector<std::unique_ptr<schema_data>> child_data(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            child_data[i] = std::make_unique<schema_data>();
+            child_data[i]->name = _stmt.column_name(int(i));
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto & child = data->children[i];
+            switch(_formats[i])
+            {
+                case 'l': child.format = "l"; break;
+                case 'g': child.format = "g"; break;
+                case 'Z': child.format = "Z"; break;
+                default:  child.format = "U"; break;
+            }
+            child.name = child_data[i]->name.c_str();
+            child.metadata = nullptr;
+            child.flags = ARROW_FLAG_NULLABLE;
+            child.n_children = 0;
+            child.children = nullptr;
+            child.dictionary = nullptr;
+            child.release = release_schema;
+            child.private_data = child_data[i].release();
+            data->child_ptrs[i] = &child;
+        }
+
+        out->format = "+s";
+        out->name = "";
+        out->metadata = nullptr;
+        out->flags = 0;
+        out->n_children = int64_t(count);
+        out->children = data->child_ptrs.data();
+        out->dictionary = nullptr;
+        out->release = release_schema;
+        out->private_data = data.release();
+    }
+
+    inline bool arrow_exporter::export_batch(ArrowArray * out)
+    {
+        resolve_formats();
+
+        const size_t count = _formats.size();
+        std::vector<column_data> columns;
+        columns.reserve(count);
+        for (char format: _formats)
+            columns.emplace_back(format, _batch_size);
+
+        size_t rows = 0;
+        while (rows < _batch_size)
+        {
+            if (!_pending)
+            {
+                if (_done)
+                    break;
+                _pending = _stmt.step();
+                if (!_pending)
+                {
+                    _done = true;
+                    break;
+                }
+            }
+            append_row(columns, rows);
+            _pending = false;
+            ++rows;
+        }
+        if (rows == 0)
+            return false;
+
+        auto data = std::make_unique<batch_data>();
+        data->children.resize(count);
+        data->child_ptrs.resize(count);
+        std::vector<std::unique_ptr<column_data>> owned(count);
+        for (size_t i = 0; i < count; ++i)
+            owned[i] = std::make_unique<column_data>(std::move(columns[i]));
+        for (size_t i = 0; i < count; ++i)
+        {
+            column_data * col = owned[i].release();
+            auto & child = data->children[i];
+            col->buffers[0] = col->null_count ? col->validity.data() : nullptr;
+            switch(col->format)
+            {
+                case 'l':
+                    col->buffers[1] = col->integers.data();
+                    child.n_buffers = 2;
+                    break;
+                case 'g':
+                    col->buffers[1] = col->reals.data();
+                    child.n_buffers = 2;
+                    break;
+                default:
+                    col->buffers[1] = col->integers.data();
+                    col->buffers[2] = col->bytes.data();
+                    child.n_buffers = 3;
+            }
+            child.length = int64_t(rows);
+            child.null_count = col->null_count;
+            child.offset = 0;
+            child.buffers = col->buffers;
+            child.n_children = 0;
+            child.children = nullptr;
+            child.dictionary = nullptr;
+            child.release = release_column;
+            child.private_data = col;
+            data->child_ptrs[i] = &child;
+        }
+
+        out->length = int64_t(rows);
+        out->null_count = 0;
+        out->offset = 0;
+        out->n_buffers = 1;
+        out->n_children = int64_t(count);
+        out->buffers = data->buffers;
+        out->children = data->child_ptrs.data();
+        out->dictionary = nullptr;
+        out->release = release_batch;
+        out->private_data = data.release();
+        return true;
+    }
+
+    inline void arrow_exporter::append_row(std::vector<column_data> & columns, size_t row)
+    {
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            auto & col = columns[i];
+            const int idx = int(i);
+            const int type = _stmt.column_type(idx);
+            const bool valid = type != SQLITE_NULL;
+            if (valid && type != storage_class(col.format))
+            {
+                static constexpr const char * type_names[] = {"", "INTEGER", "REAL", "TEXT", "BLOB"};
+                throw exception(SQLITE_MISMATCH, error::message_ptr(
+                    sqlite3_mprintf("%s value in column '%s' does not match its Arrow type '%c'",
+                                    type_names[type], _stmt.column_name(idx), col.format), sqlite3_free));
+            }
+
+            if (row % 8 == 0)
+                col.validity.push_back(0);
+            if (valid)
+                col.validity.back() |= uint8_t(1u << (row % 8));
+            else
+                ++col.null_count;
+
+            switch(col.format)
+            {
+                case 'l':
+                    col.integers.push_back(valid ? _stmt.column_value<int64_t>(idx) : 0);
+                    break;
+                case 'g':
+                    col.reals.push_back(valid ? _stmt.column_value<double>(idx) : 0);
+                    break;
+                case 'Z':
+                    if (valid)
+                    {
+                        auto val = _stmt.column_value<blob_view>(idx);
+                        col.bytes.insert(col.bytes.end(), (const char *)val.data(), (const char *)val.data() + val.size());
+                    }
+                    col.integers.push_back(int64_t(col.bytes.size()));
+                    break;
+                default:
+                    if (valid)
+                    {
+                        auto val = _stmt.column_value<std::string_view>(idx);
+                        col.bytes.insert(col.bytes.end(), val.begin(), val.end());
+                    }
+                    col.integers.push_back(int64_t(col.bytes.size()));
+            }
+        }
+    }
+
+    inline void arrow_exporter::release_schema(ArrowSchema * schema) noexcept
+    {
+        auto data = static_cast<schema_data *>(schema->private_data);
+        for (ArrowSchema * child: data->child_ptrs)
+        {
+            //children that have been moved out are marked released
+            if (child->release)
+                child->release(child);
+        }
+        delete data;
+        schema->release = nullptr;
+    }
+
+    inline void arrow_exporter::release_column(ArrowArray * array) noexcept
+    {
+        delete static_cast<column_data *>(array->private_data);
+        array->release = nullptr;
+    }
+
+    inline void arrow_exporter::release_batch(ArrowArray * array) noexcept
+    {
+        auto data = static_cast<batch_data *>(array->private_data);
+        for (ArrowArray * child: data->child_ptrs)
+        {
+            if (child->release)
+                child->release(child);
+        }
+        delete data;
+        array->release = nullptr;
+    }
+
+    inline void arrow_exporter::export_stream(std::unique_ptr<statement> stmt, ArrowArrayStream * out, size_t batch_size)
+    {
+        if (!stmt)
+            throw exception(SQLITE_MISUSE, error::message_ptr("cannot export a null statement"));
+
+        //allocate first so nothing is written to out if this fails
+        auto data = std::make_unique<stream_data>(std::move(stmt), batch_size);
+
+        out->get_schema = [](ArrowArrayStream * stream, ArrowSchema * schema) noexcept {
+            auto data = static_cast<stream_data *>(stream->private_data);
+            return data->invoke([&]() {
+                data->exporter.export_schema(schema);
+            });
+        };
+        out->get_next = [](ArrowArrayStream * stream, ArrowArray * array) noexcept {
+            auto data = static_cast<stream_data *>(stream->private_data);
+            return data->invoke([&]() {
+                if (!data->exporter.export_batch(array))
+                    array->release = nullptr;
+            });
+        };
+        out->get_last_error = [](ArrowArrayStream * stream) noexcept {
+            auto data = static_cast<stream_data *>(stream->private_data);
+            return data->error.empty() ? nullptr : data->error.c_str();
+        };
+        out->release = [](ArrowArrayStream * stream) noexcept {
+            delete static_cast<stream_data *>(stream->private_data);
+            stream->release = nullptr;
+        };
+        out->private_data = data.release();
+    }
+
+    //MARK: - arrow_source
+
+    inline arrow_source::arrow_source(ArrowArrayStream * stream):
+        _stream(*stream)
+    {
+        stream->release = nullptr;
+        _schema.release = nullptr;
+        try
+        {
+            if (int res = _stream.get_schema(&_stream, &_schema))
+                fail(res, "cannot obtain Arrow stream schema");
+
+            if (strcmp(_schema.format, "+s") != 0)
+                throw exception(SQLITE_MISMATCH, error::message_ptr("Arrow stream must produce struct arrays"));
+            if (_schema.n_children == 0)
+                throw exception(SQLITE_MISMATCH, error::message_ptr("Arrow stream has no columns"));
+            for (size_t i = 0; i < columns(); ++i)
+            {
+                const ArrowSchema * child = _schema.children[i];
+                if (child->dictionary || child->format[0] == 0 || child->format[1] != 0 ||
+                    !strchr("bcCsSiIlLfgnuUzZ", child->format[0]))
+                {
+                    throw exception(SQLITE_MISMATCH, error::message_ptr(
+                        sqlite3_mprintf("unsupported Arrow format '%s' of column '%s'",
+                                        child->format, child->name ? child->name : ""), sqlite3_free));
+                }
+            }
+        }
+        catch(...)
+        {
+            if (_schema.release)
+                _schema.release(&_schema);
+            close_stream();
+            throw;
+        }
+    }
+
+    inline arrow_source::~arrow_source() noexcept
+    {
+        for (auto & batch: _batches)
+        {
+            if (batch.release)
+                batch.release(&batch);
+        }
+        if (_schema.release)
+            _schema.release(&_schema);
+        close_stream();
+    }
+
+    inline void arrow_source::close_stream() noexcept
+    {
+        if (_stream.release)
+        {
+            _stream.release(&_stream);
+            _stream.release = nullptr;
+        }
+    }
+
+    inline void arrow_source::fail(int code, const char * what)
+    {
+        const char * detail = _stream.get_last_error(&_stream);
+        throw exception(SQLITE_ERROR, error::message_ptr(
+            sqlite3_mprintf("%s: %s", what, detail ? detail : strerror(code)), sqlite3_free));
+    }
+
+    inline std::string arrow_source::declaration() const
+    {
+        std::string ret = "CREATE TABLE x(";
+        for (size_t i = 0; i < columns(); ++i)
+        {
+            if (i != 0)
+                ret += ", ";
+            ret += '"';
+            for (const char * c = column_name(i); c && *c; ++c)
+            {
+                if (*c == '"')
+                    ret += '"';
+                ret += *c;
+            }
+            ret += '"';
+            switch(column_format(i)[0])
+            {
+                case 'f': case 'g':
+                    ret += " REAL"; break;
+                case 'u': case 'U':
+                    ret += " TEXT"; break;
+                case 'z': case 'Z':
+                    ret += " BLOB"; break;
+                case 'n':
+                    break;
+                default:
+                    ret += " INTEGER"; break;
+            }
+        }
+        ret += ')';
+        return ret;
+    }
+
+    inline bool arrow_source::fetch(int64_t row)
+    {
+        while (row >= rows())
+        {
+            if (complete())
+                return false;
+
+            ArrowArray batch;
+            batch.release = nullptr;
+            if (int res = _stream.get_next(&_stream, &batch))
+                fail(res, "cannot read Arrow stream");
+            if (!batch.release)
+            {
+                close_stream();
+                return false;
+            }
+            if (batch.n_children != _schema.n_children || batch.length == 0)
+            {
+                const bool empty = batch.length == 0;
+                batch.release(&batch);
+                if (empty)
+                    continue;
+                throw exception(SQLITE_MISMATCH, error::message_ptr("Arrow batch does not match the stream schema"));
+            }
+            _batches.reserve(_batches.size() + 1);
+            _starts.reserve(_starts.size() + 1);
+            _batches.push_back(batch);
+            _starts.push_back(_starts.back() + batch.length);
+        }
+        return true;
+    }
+
+    inline size_t arrow_source::batch_of(int64_t row) const noexcept
+    {
+        auto it = std::upper_bound(_starts.begin(), _starts.end(), row);
+        return size_t(it - _starts.begin()) - 1;
+    }
+
+    inline void arrow_source::result(context & ctxt, size_t batch, int64_t row_in_batch, size_t column) const noexcept
+    {
+        const ArrowArray & parent = _batches[batch];
+        const ArrowArray * array = parent.children[column];
+        const char format = column_format(column)[0];
+        const int64_t idx = parent.offset + row_in_batch + array->offset;
+
+        if (format == 'n')
+        {
+            ctxt.result(nullptr);
+            return;
+        }
+        if (auto validity = static_cast<const uint8_t *>(array->buffers[0]))
+        {
+            if (!(validity[idx >> 3] & (1u << (idx & 7))))
+            {
+                ctxt.result(nullptr);
+                return;
+            }
+        }
+
+        auto get = [&](auto * type_tag) {
+            using T = std::remove_pointer_t<decltype(type_tag)>;
+            return static_cast<const T *>(array->buffers[1])[idx];
+        };
+        auto get_bytes = [&](auto * type_tag) {
+            using T = std::remove_pointer_t<decltype(type_tag)>;
+            auto offsets = static_cast<const T *>(array->buffers[1]);
+            auto data = static_cast<const char *>(array->buffers[2]);
+            return std::string_view(data + offsets[idx], size_t(offsets[idx + 1] - offsets[idx]));
+        };
+
+        switch(format)
+        {
+            case 'b':
+            {
+                auto bits = static_cast<const uint8_t *>(array->buffers[1]);
+                ctxt.result(int((bits[idx >> 3] >> (idx & 7)) & 1));
+                break;
+            }
+            case 'c': ctxt.result(int64_t(get((int8_t *)nullptr)));   break;
+            case 'C': ctxt.result(int64_t(get((uint8_t *)nullptr)));  break;
+            case 's': ctxt.result(int64_t(get((int16_t *)nullptr)));  break;
+            case 'S': ctxt.result(int64_t(get((uint16_t *)nullptr))); break;
+            case 'i': ctxt.result(int64_t(get((int32_t *)nullptr)));  break;
+            case 'I': ctxt.result(int64_t(get((uint32_t *)nullptr))); break;
+            case 'l': ctxt.result(int64_t(get((int64_t *)nullptr)));  break;
+            case 'L':
+            {
+                const uint64_t val = get((uint64_t *)nullptr);
+                if (val > uint64_t(std::numeric_limits<int64_t>::max()))
+                    ctxt.result(double(val));
+                else
+                    ctxt.result(int64_t(val));
+                break;
+            }
+            case 'f': ctxt.result(double(get((float *)nullptr))); break;
+            case 'g': ctxt.result(get((double *)nullptr));        break;
+            //batches are retained for the lifetime of the source so values can be referenced
+            case 'u': ctxt.result_reference(get_bytes((int32_t *)nullptr)); break;
+            case 'U': ctxt.result_reference(get_bytes((int64_t *)nullptr)); break;
+            case 'z':
+            {
+                auto bytes = get_bytes((int32_t *)nullptr);
+                ctxt.result_reference(blob_view((const std::byte *)bytes.data(), bytes.size()));
+                break;
+            }
+            case 'Z':
+            {
+                auto bytes = get_bytes((int64_t *)nullptr);
+                ctxt.result_reference(blob_view((const std::byte *)bytes.data(), bytes.size()));
+                break;
+            }
+        }
+    }
+
+    //MARK: - arrow_table
+
+    inline arrow_table::arrow_table(
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 9, 0)
+        connect_t,
+    #endif
+        database * db, arrow_source * source, int /*argc*/, const char * const * /*argv*/):
+        _source(source)
+    {
+        if (!source)
+            throw exception(SQLITE_MISUSE, error::message_ptr("arrow_table requires an arrow_source"));
+        db->declare_vtab(source->declaration());
+    }
+
+    inline bool arrow_table::best_index(index_info<> & info) const
+    {
+        const auto constraints = info.constraints();
+        auto usages = info.constraints_usage();
+
+        bool lookup = false;
+        for (size_t i = 0; i < constraints.size(); ++i)
+        {
+            auto & constraint = constraints[i];
+            if (constraint.usable && constraint.iColumn < 0 && constraint.op == SQLITE_INDEX_CONSTRAINT_EQ)
+            {
+                //SQLite still checks the constraint since the argument may need conversion
+                usages[i].argvIndex = 1;
+                lookup = true;
+                break;
+            }
+        }
+
+        //until the stream has been read its size is unknown
+        double rows = double(_source->rows());
+        if (!_source->complete())
+            rows = std::max(rows * 2, 1000000.);
+        const double estimated = lookup ? 1 : rows;
+
+        size_t used_columns = _source->columns();
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 10, 0)
+        const uint64_t used_mask = info.columns_used();
+        used_columns = 0;
+        for (size_t i = 0; i < _source->columns(); ++i)
+            used_columns += (used_mask & (uint64_t(1) << std::min(i, size_t(63)))) != 0;
+    #endif
+        info.set_estimated_cost(estimated * double(1 + used_columns));
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 8, 2)
+        info.set_estimated_rows(int64_t(estimated));
+    #endif
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 9, 0)
+        if (lookup)
+            info.set_index_flags(info.index_flags() | SQLITE_INDEX_SCAN_UNIQUE);
+    #endif
+
+        //rows are produced in rowid order
+        auto orderbys = info.orderbys();
+        if (orderbys.size() == 1 && orderbys[0].iColumn < 0 && !orderbys[0].desc)
+            info.set_order_by_consumed(true);
+
+        info.set_index_number(lookup);
+        return true;
+    }
+
+    inline void arrow_table::cursor::filter(int idx, int /*argc*/, value ** argv)
+    {
+        _row = 0;
+        _last = std::numeric_limits<int64_t>::max();
+        _batch = 0;
+        if (idx)
+        {
+            auto bound = make_constraint_bound<int64_t>(SQLITE_INDEX_CONSTRAINT_EQ, *argv[0]);
+            if (bound.match == constraint_match::none || (bound.match == constraint_match::compare && bound.value < 0))
+            {
+                _last = 0;
+            }
+            else if (bound.match == constraint_match::compare)
+            {
+                _row = bound.value;
+                _last = bound.value + 1;
+            }
+        }
+        load_row();
+    }
+
+    inline void arrow_table::cursor::next()
+    {
+        ++_row;
+        load_row();
+    }
+
+    inline void arrow_table::cursor::load_row()
+    {
+        if (_row >= _last)
+            return;
+        arrow_source * source = owner()->_source;
+        if (!source->fetch(_row))
+        {
+            _last = _row;
+            return;
+        }
+        //sequential scans simply move to the next batch
+        if (_row < source->batch_start(_batch) || _row >= source->batch_start(_batch + 1))
+            _batch = source->batch_of(_row);
+    }
+
+    inline void arrow_table::cursor::column(context & ctxt, int idx) const
+    {
+        arrow_source * source = owner()->_source;
+        source->result(ctxt, _batch, _row - source->batch_start(_batch), size_t(idx));
+    }
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_BUFFERED_VTAB_IFACE_INCLUDED
+#define HEADER_SQLITEPP_BUFFERED_VTAB_IFACE_INCLUDED
+
+#include "vtab_iface.hpp"
+#include "owned_value.hpp"
+
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace thinsqlitepp
+{
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Base class for writable virtual tables that apply changes in batches
+     *
+     * This class is a @ref vtab that implements `update()` and the transaction methods for you.
+     * Instead of being applied to your backing store one row at a time, inserts, updates and
+     * deletes are accumulated for the duration of a transaction and handed to your class
+     * all at once when SQLite syncs or commits it. A rollback simply discards them. Rolling
+     * back to a savepoint (including the implicit per-statement ones SQLite uses)
+     * undoes only the changes made after it.
+     *
+     * Derive your class from it passing your class. In addition to the usual @ref vtab requirements
+     * your class needs to define the following public methods:
+     * ```
+     * //Apply the changes to your backing store. They are sorted by rowid and there is at most
+     * //one change per rowid. Throw an exception to fail the transaction.
+     * void apply_batch(span<const buffered_vtab::change> changes);
+     *
+     * //Generate a rowid for an inserted row when SQL does not specify one. It must not collide with
+     * //existing rows or previously generated ones in this transaction.
+     * int64_t new_rowid();
+     * ```
+     *
+     * Changes are not visible in the backing store until applied. To let statements in the same
+     * transaction see them (read-your-writes) your cursors need to overlay them on the store rows:
+     * - For each store row consult find_pending(). If it returns a row without values the row has
+     *   been deleted and must be skipped. If it returns a row with values, use those instead of
+     *   the stored ones.
+     * - Once store rows are exhausted produce the rows from pending() that are not `in_store`.
+     *
+     * Column values passed to `apply_batch()` and returned from pending rows are in the order of
+     * the declared table schema. Note that `INSERT` into a rowid that SQLite does not know to exist
+     * is always reported as change_kind::insert.
+     *
+     * If your class re-defines any of the transaction methods it must call the ones of this class.
+     *
+     * `#include <thinsqlitepp/buffered_vtab.hpp>`
+     *
+     * @tparam Derived Your derived class
+     */
+    template<class Derived>
+    class buffered_vtab : public vtab<Derived>
+    {
+    public:
+        /// Kind of a buffered change
+        enum class change_kind
+        {
+            insert, ///< A new row
+            update, ///< Replacement of all values of an existing row
+            remove  ///< Deletion of an existing row
+        };
+
+        /// A change passed to `apply_batch()`
+        struct change
+        {
+            change_kind kind;               ///< What kind of change this is
+            int64_t rowid;                  ///< Row the change applies to
+            span<const owned_value> values; ///< New column values. Empty for change_kind::remove
+        };
+
+        /// State of a row modified in the current transaction
+        struct pending_row
+        {
+            /// Whether the row existed in the backing store before this transaction
+            bool in_store;
+            /// New column values or nothing if the row has been deleted
+            std::optional<std::vector<owned_value>> values;
+        };
+
+        /// Rows modified in the current transaction keyed by rowid
+        using pending_map = std::map<int64_t, pending_row>;
+
+    public:
+        /// Equivalent to @ref xUpdate
+        int64_t update(int argc, value ** argv);
+
+        /// Equivalent to @ref xBegin
+        void begin();
+        /// Equivalent to @ref xSync. Calls `apply_batch()` with buffered changes.
+        void sync();
+        /// Equivalent to @ref xCommit. Calls `apply_batch()` if sync() has not done so.
+        void commit();
+        /// Equivalent to @ref xRollback
+        void rollback() noexcept;
+
+        /// Equivalent to @ref xSavepoint
+        void savepoint(int point);
+        /// Equivalent to @ref xRelease
+        void release(int point);
+        /// Equivalent to @ref xRollbackTo
+        void rollback_to(int point);
+
+        /**
+         * Returns the pending state of a given row
+         *
+         * @returns `nullptr` if the row has not been modified in the current transaction
+         */
+        const pending_row * find_pending(int64_t rowid) const noexcept
+        {
+            auto it = _pending.find(rowid);
+            return it != _pending.end() ? &it->second : nullptr;
+        }
+
+        /// All rows modified in the current transaction
+        const pending_map & pending() const noexcept
+            { return _pending; }
+
+    protected:
+        /// This class is default constructible only by derived classes
+        buffered_vtab() = default;
+
+        /// Sets an SQLite function result from an owned_value
+        static void result(context & ctxt, const owned_value & val) noexcept;
+
+    private:
+        void set_pending(int64_t rowid, bool in_store, std::optional<std::vector<owned_value>> values);
+        void remove_pending(int64_t rowid);
+        void undo(size_t mark) noexcept;
+        void apply();
+        void clear() noexcept;
+
+    private:
+        pending_map _pending;
+        //previous states of modified rows, recorded only while there are active savepoints
+        std::vector<std::pair<int64_t, std::optional<pending_row>>> _undo;
+        //savepoint level and the size of undo log when it was established
+        std::vector<std::pair<int, size_t>> _savepoints;
+        bool _applied = false;
+    };
+
+    /** @} */
+}
+
+#endif
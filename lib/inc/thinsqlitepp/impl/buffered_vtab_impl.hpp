@@ -0,0 +1,203 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_BUFFERED_VTAB_IMPL_INCLUDED
+#define HEADER_SQLITEPP_BUFFERED_VTAB_IMPL_INCLUDED
+
+#include "buffered_vtab_iface.hpp"
+
+namespace thinsqlitepp
+{
+    template<class Derived>
+    int64_t buffered_vtab<Derived>::update(int argc, value ** argv)
+    {
+        if (argc == 1)
+        {
+            remove_pending(argv[0]->get<int64_t>());
+            return 0;
+        }
+
+        std::vector<owned_value> values;
+        values.reserve(size_t(argc - 2));
+        for (int i = 2; i < argc; ++i)
+            values.emplace_back(*argv[i]);
+
+        if (argv[0]->type() == SQLITE_NULL)
+        {
+            int64_t rowid = argv[1]->type() == SQLITE_NULL ?
+                                static_cast<Derived *>(this)->new_rowid() :
+                                argv[1]->get<int64_t>();
+            set_pending(rowid, false, std::move(values));
+            return rowid;
+        }
+
+        const int64_t old_rowid = argv[0]->get<int64_t>();
+        const int64_t rowid = argv[1]->get<int64_t>();
+        if (rowid == old_rowid)
+        {
+            set_pending(rowid, true, std::move(values));
+        }
+        else
+        {
+            remove_pending(old_rowid);
+            set_pending(rowid, false, std::move(values));
+        }
+        return rowid;
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::set_pending(int64_t rowid, bool in_store, std::optional<std::vector<owned_value>> values)
+    {
+        auto it = _pending.find(rowid);
+        if (!_savepoints.empty())
+        {
+            if (it != _pending.end())
+                _undo.emplace_back(rowid, it->second);
+            else
+                _undo.emplace_back(rowid, std::nullopt);
+        }
+        if (it != _pending.end())
+            it->second.values = std::move(values);
+        else
+            _pending.emplace(rowid, pending_row{in_store, std::move(values)});
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::remove_pending(int64_t rowid)
+    {
+        auto it = _pending.find(rowid);
+        if (it == _pending.end())
+        {
+            set_pending(rowid, true, std::nullopt);
+            return;
+        }
+        if (!_savepoints.empty())
+            _undo.emplace_back(rowid, it->second);
+        //a row inserted in this transaction simply disappears
+        if (it->second.in_store)
+            it->second.values.reset();
+        else
+            _pending.erase(it);
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::undo(size_t mark) noexcept
+    {
+        while (_undo.size() > mark)
+        {
+            auto & [rowid, previous] = _undo.back();
+            if (previous)
+                _pending.insert_or_assign(rowid, std::move(*previous));
+            else
+                _pending.erase(rowid);
+            _undo.pop_back();
+        }
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::apply()
+    {
+        std::vector<change> changes;
+        changes.reserve(_pending.size());
+        for (auto & [rowid, row]: _pending)
+        {
+            if (row.values)
+                changes.push_back({row.in_store ? change_kind::update : change_kind::insert, rowid, *row.values});
+            else
+                changes.push_back({change_kind::remove, rowid, {}});
+        }
+        if (!changes.empty())
+            static_cast<Derived *>(this)->apply_batch(span<const change>(changes));
+        _applied = true;
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::clear() noexcept
+    {
+        _pending.clear();
+        _undo.clear();
+        _savepoints.clear();
+        _applied = false;
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::begin()
+    {
+        clear();
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::sync()
+    {
+        apply();
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::commit()
+    {
+        if (!_applied)
+            apply();
+        clear();
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::rollback() noexcept
+    {
+        clear();
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::savepoint(int point)
+    {
+        release(point);
+        _savepoints.emplace_back(point, _undo.size());
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::release(int point)
+    {
+        while (!_savepoints.empty() && _savepoints.back().first >= point)
+            _savepoints.pop_back();
+        //nobody can roll back past this point anymore
+        if (_savepoints.empty())
+            _undo.clear();
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::rollback_to(int point)
+    {
+        //the savepoint stays active after rolling back to it
+        size_t mark = 0;
+        for (auto it = _savepoints.rbegin(); it != _savepoints.rend(); ++it)
+        {
+            if (it->first <= point)
+            {
+                mark = it->second;
+                break;
+            }
+        }
+        undo(mark);
+        while (!_savepoints.empty() && _savepoints.back().first > point)
+            _savepoints.pop_back();
+    }
+
+    template<class Derived>
+    void buffered_vtab<Derived>::result(context & ctxt, const owned_value & val) noexcept
+    {
+        switch(val.type())
+        {
+            case SQLITE_INTEGER: ctxt.result(val.get<int64_t>());          break;
+            case SQLITE_FLOAT:   ctxt.result(val.get<double>());           break;
+            case SQLITE_TEXT:    ctxt.result(val.get<std::string_view>()); break;
+            case SQLITE_BLOB:    ctxt.result(val.get<blob_view>());        break;
+            default:             ctxt.result(nullptr);
+        }
+    }
+}
+
+#endif
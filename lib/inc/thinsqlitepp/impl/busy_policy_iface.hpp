@@ -0,0 +1,179 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_BUSY_POLICY_IFACE_INCLUDED
+#define HEADER_SQLITEPP_BUSY_POLICY_IFACE_INCLUDED
+
+#include "config.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+#include <stdint.h>
+
+namespace thinsqlitepp
+{
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Lock contention statistics collected by @ref busy_policy
+     *
+     * A "wait" is one episode of #SQLITE_BUSY handling: from the first busy handler invocation for
+     * an operation until the lock is obtained or the handler gives up. Histograms use power of 2
+     * buckets: bucket `i` counts values `v` such that `2^(i-1) <= v < 2^i` with bucket 0 counting zeroes
+     * and the last bucket also counting everything larger.
+     *
+     * All methods are thread safe, so one object can aggregate statistics of many connections
+     * and be read from any thread.
+     *
+     * `#include <thinsqlitepp/busy_policy.hpp>`
+     */
+    class busy_metrics
+    {
+    public:
+        /// Number of histogram buckets
+        static constexpr size_t bucket_count = 32;
+
+        /// A histogram with power of 2 buckets
+        using histogram = std::array<uint64_t, bucket_count>;
+
+        /// A point in time copy of the statistics
+        struct snapshot_type
+        {
+            uint64_t waits = 0;             ///< Number of completed waits
+            uint64_t timeouts = 0;          ///< Number of waits that ended by giving up
+            uint64_t retries = 0;           ///< Total number of retries in all waits
+            uint64_t wait_us = 0;           ///< Total time spent waiting, in microseconds
+            histogram retry_histogram{};    ///< Histogram of retries per wait
+            histogram wait_histogram{};     ///< Histogram of wait durations in microseconds
+        };
+    public:
+        busy_metrics() noexcept = default;
+        busy_metrics(const busy_metrics &) = delete;
+        busy_metrics & operator=(const busy_metrics &) = delete;
+
+        /// Record a completed wait
+        void record(uint64_t retries, std::chrono::microseconds waited, bool timed_out) noexcept;
+
+        /// Retrieve the statistics collected so far
+        snapshot_type snapshot() const noexcept;
+
+        /// Reset all statistics to zero
+        void reset() noexcept;
+
+        /// Returns histogram bucket index for a value
+        static size_t bucket(uint64_t val) noexcept;
+    private:
+        using atomic_histogram = std::array<std::atomic<uint64_t>, bucket_count>;
+
+        std::atomic<uint64_t> _waits{0};
+        std::atomic<uint64_t> _timeouts{0};
+        std::atomic<uint64_t> _retries{0};
+        std::atomic<uint64_t> _wait_us{0};
+        atomic_histogram _retry_histogram{};
+        atomic_histogram _wait_histogram{};
+    };
+
+    /**
+     * Adaptive busy handler
+     *
+     * A busy handler policy to use with database::busy_handler() instead of busy_timeout(). When a
+     * lock is busy it first yields the thread a few times, which is enough for the short waits typical
+     * of WAL mode, then sleeps with exponentially growing, jittered intervals until the lock becomes
+     * available or the deadline for the wait expires.
+     * ```
+     * busy_policy::settings settings;
+     * settings.deadline = 2s;
+     * busy_policy policy(settings);
+     * db->busy_handler(&policy);
+     * ...
+     * auto stats = policy.metrics().snapshot();
+     * ```
+     * Every wait is recorded in a @ref busy_metrics object which can be private to the policy or
+     * shared between policies of many connections.
+     *
+     * SQLite does not notify the handler when a wait succeeds, so the duration and retry count of a
+     * successful wait are recorded when the next wait starts or flush() is called. Like the connection
+     * it is attached to, a policy object must be used from one thread at a time. The policy must outlive
+     * its registration.
+     *
+     * `#include <thinsqlitepp/busy_policy.hpp>`
+     */
+    class busy_policy
+    {
+    public:
+        /// Policy parameters
+        struct settings
+        {
+            /// Number of initial retries that only yield the thread without sleeping
+            unsigned spins = 8;
+            /// Sleep interval of the first retry after spinning
+            std::chrono::microseconds initial_backoff{50};
+            /// Maximum sleep interval
+            std::chrono::microseconds max_backoff{20000};
+            /// Maximum total duration of a single wait before giving up with #SQLITE_BUSY
+            std::chrono::microseconds deadline{5000000};
+        };
+    public:
+        /// Construct a policy with default settings and private metrics
+        busy_policy() noexcept;
+
+        /**
+         * Construct a policy
+         *
+         * @param s policy parameters
+         * @param metrics shared metrics object to record waits to or nullptr to use a private one.
+         * The shared object must outlive the policy.
+         */
+        explicit busy_policy(const settings & s, busy_metrics * metrics = nullptr) noexcept;
+
+        busy_policy(const busy_policy &) = delete;
+        busy_policy & operator=(const busy_policy &) = delete;
+
+        /**
+         * Busy handler callback
+         *
+         * @param count_invoked number of times the handler has been invoked for the current wait
+         * @returns true to retry, false to give up
+         */
+        bool operator()(int count_invoked) noexcept;
+
+        /// Record the current wait, if any, as successful
+        void flush() noexcept;
+
+        /// Metrics this policy records to
+        busy_metrics & metrics() const noexcept
+            { return *_metrics; }
+
+        /// Policy parameters
+        const settings & parameters() const noexcept
+            { return _settings; }
+    private:
+        using clock = std::chrono::steady_clock;
+
+        std::chrono::microseconds next_sleep(int count_invoked) noexcept;
+        void finish(bool timed_out) noexcept;
+    private:
+        settings _settings;
+        busy_metrics _own_metrics;
+        busy_metrics * _metrics;
+        uint64_t _random;
+        clock::time_point _wait_start;
+        clock::time_point _wait_end;
+        uint64_t _wait_retries = 0;
+        bool _waiting = false;
+    };
+
+    /** @} */
+}
+
+#endif
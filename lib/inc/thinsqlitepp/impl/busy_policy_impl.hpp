@@ -0,0 +1,156 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_BUSY_POLICY_IMPL_INCLUDED
+#define HEADER_SQLITEPP_BUSY_POLICY_IMPL_INCLUDED
+
+#include "busy_policy_iface.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace thinsqlitepp
+{
+    //MARK: - busy_metrics
+
+    inline size_t busy_metrics::bucket(uint64_t val) noexcept
+    {
+        size_t ret = 0;
+        while (val && ret < bucket_count - 1)
+        {
+            val >>= 1;
+            ++ret;
+        }
+        return ret;
+    }
+
+    inline void busy_metrics::record(uint64_t retries, std::chrono::microseconds waited, bool timed_out) noexcept
+    {
+        const auto wait_us = uint64_t(std::max(waited.count(), decltype(waited.count())(0)));
+        _waits.fetch_add(1, std::memory_order_relaxed);
+        if (timed_out)
+            _timeouts.fetch_add(1, std::memory_order_relaxed);
+        _retries.fetch_add(retries, std::memory_order_relaxed);
+        _wait_us.fetch_add(wait_us, std::memory_order_relaxed);
+        _retry_histogram[bucket(retries)].fetch_add(1, std::memory_order_relaxed);
+        _wait_histogram[bucket(wait_us)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline busy_metrics::snapshot_type busy_metrics::snapshot() const noexcept
+    {
+        snapshot_type ret;
+        ret.waits = _waits.load(std::memory_order_relaxed);
+        ret.timeouts = _timeouts.load(std::memory_order_relaxed);
+        ret.retries = _retries.load(std::memory_order_relaxed);
+        ret.wait_us = _wait_us.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < bucket_count; ++i)
+        {
+            ret.retry_histogram[i] = _retry_histogram[i].load(std::memory_order_relaxed);
+            ret.wait_histogram[i] = _wait_histogram[i].load(std::memory_order_relaxed);
+        }
+        return ret;
+    }
+
+    inline void busy_metrics::reset() noexcept
+    {
+        _waits.store(0, std::memory_order_relaxed);
+        _timeouts.store(0, std::memory_order_relaxed);
+        _retries.store(0, std::memory_order_relaxed);
+        _wait_us.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < bucket_count; ++i)
+        {
+            _retry_histogram[i].store(0, std::memory_order_relaxed);
+            _wait_histogram[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    //MARK: - busy_policy
+
+    inline busy_policy::busy_policy() noexcept:
+        busy_policy(settings())
+    {}
+
+    inline busy_policy::busy_policy(const settings & s, busy_metrics * metrics) noexcept:
+        _settings(s),
+        _metrics(metrics ? metrics : &_own_metrics),
+        //any distinct non-zero seed will do: jitter only needs to decorrelate competing connections
+        _random(uint64_t(clock::now().time_since_epoch().count()) ^ uint64_t(uintptr_t(this)) ^ 0x9E3779B97F4A7C15ull)
+    {
+        if (!_random)
+            _random = 1;
+    }
+
+    inline bool busy_policy::operator()(int count_invoked) noexcept
+    {
+        const auto now = clock::now();
+        if (count_invoked == 0 || !_waiting)
+        {
+            //a new wait: the previous one, if any, must have succeeded
+            flush();
+            _waiting = true;
+            _wait_start = now;
+            _wait_retries = 0;
+        }
+
+        const auto deadline = _wait_start + _settings.deadline;
+        if (now >= deadline)
+        {
+            _wait_end = now;
+            finish(true);
+            return false;
+        }
+
+        ++_wait_retries;
+        if (unsigned(count_invoked) < _settings.spins)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now);
+            std::this_thread::sleep_for(std::min(next_sleep(count_invoked), remaining));
+        }
+        _wait_end = clock::now();
+        return true;
+    }
+
+    inline void busy_policy::flush() noexcept
+    {
+        if (_waiting)
+            finish(false);
+    }
+
+    inline std::chrono::microseconds busy_policy::next_sleep(int count_invoked) noexcept
+    {
+        const unsigned step = unsigned(count_invoked) - _settings.spins;
+        const auto max_backoff = std::max(_settings.max_backoff, _settings.initial_backoff);
+        auto backoff = _settings.initial_backoff;
+        for (unsigned i = 0; i < step && backoff < max_backoff; ++i)
+            backoff *= 2;
+        backoff = std::min(backoff, max_backoff);
+
+        //xorshift64
+        _random ^= _random << 13;
+        _random ^= _random >> 7;
+        _random ^= _random << 17;
+
+        //"equal jitter": half of the interval is fixed, the other half random
+        const auto half = uint64_t(backoff.count() / 2);
+        return std::chrono::microseconds(half + (_random % (uint64_t(backoff.count()) - half + 1)));
+    }
+
+    inline void busy_policy::finish(bool timed_out) noexcept
+    {
+        _waiting = false;
+        _metrics->record(_wait_retries,
+                         std::chrono::duration_cast<std::chrono::microseconds>(_wait_end - _wait_start),
+                         timed_out);
+    }
+}
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_CARRAY_IFACE_INCLUDED
+#define HEADER_SQLITEPP_CARRAY_IFACE_INCLUDED
+
+#include "vtab_iface.hpp"
+#include "statement_iface.hpp"
+
+#include <string_view>
+
+namespace thinsqlitepp
+{
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * An eponymous table-valued function over C++ arrays bound to statement parameters
+     *
+     * This is similar to SQLite's [carray](https://sqlite.org/carray.html) extension. It allows passing
+     * an arbitrary list of values to a single statement parameter, most commonly to implement `IN` lists
+     * without generating a different statement for every list size:
+     * ```
+     * carray::create_module(*db, "carray");
+     *
+     * auto stmt = statement::create(*db, "SELECT name FROM items WHERE id IN carray(?)");
+     * std::vector<int64_t> ids = ...;
+     * carray::bind(*stmt, 1, ids);
+     * while (stmt->step()) ...
+     * ```
+     * The table has a single `value` column and a hidden `pointer` one which receives the function
+     * argument. The rowid is the 1-based index of the element. Arrays of `int64_t`, `double` and
+     * `std::string_view` are supported.
+     *
+     * The elements are never copied: the array must remain valid until the statement is reset, re-bound
+     * or destroyed. Only a small descriptor is allocated by bind() and it is passed to the table via
+     * SQLite's [pointer passing interface](https://sqlite.org/bindptr.html) so it cannot be forged from SQL.
+     * Querying the table without an argument fails with "no query solution" error while passing `NULL` or
+     * any other value that is not a bound array produces no rows.
+     *
+     * `#include <thinsqlitepp/carray.hpp>`
+     *
+     * @since SQLite 3.20
+     */
+    class carray : public vtab<carray>
+    {
+    public:
+        /**
+         * Description of the bound array
+         *
+         * This is the object passed through ::sqlite3_bind_pointer with the #pointer_type type.
+         */
+        class array
+        {
+        public:
+            /// The "type" string used with ::sqlite3_bind_pointer
+            static constexpr const char * pointer_type = "thinsqlitepp::carray::array";
+
+            /// Describe an array of `INTEGER`s
+            array(span<const int64_t> data) noexcept:
+                _data(data.data()), _size(data.size()), _type(SQLITE_INTEGER)
+            {}
+            /// Describe an array of `REAL`s
+            array(span<const double> data) noexcept:
+                _data(data.data()), _size(data.size()), _type(SQLITE_FLOAT)
+            {}
+            /// Describe an array of `TEXT`s
+            array(span<const std::string_view> data) noexcept:
+                _data(data.data()), _size(data.size()), _type(SQLITE_TEXT)
+            {}
+
+            /// One of SQLITE_INTEGER, SQLITE_FLOAT or SQLITE_TEXT
+            int type() const noexcept
+                { return _type; }
+            /// Pointer to the first element
+            const void * data() const noexcept
+                { return _data; }
+            /// Number of elements
+            size_t size() const noexcept
+                { return _size; }
+        private:
+            const void * _data;
+            size_t _size;
+            int _type;
+        };
+    public:
+        carray(connect_t, database * db, int argc, const char * const * argv);
+
+        /**
+         * Bind an array to a statement parameter
+         *
+         * @throws exception if the binding fails
+         */
+        static void bind(statement & stmt, int idx, span<const int64_t> data)
+            { bind(stmt, idx, array(data)); }
+        /// @overload
+        static void bind(statement & stmt, int idx, span<const double> data)
+            { bind(stmt, idx, array(data)); }
+        /// @overload
+        static void bind(statement & stmt, int idx, span<const std::string_view> data)
+            { bind(stmt, idx, array(data)); }
+
+        bool best_index(index_info<> & info) const;
+
+        class cursor : public vtab::cursor
+        {
+        public:
+            using vtab::cursor::cursor;
+
+            void filter(int idx, int argc, value ** argv);
+
+            bool eof() const noexcept
+                { return _pos >= _end; }
+
+            void next()
+                { ++_pos; }
+
+            int64_t rowid() const
+                { return int64_t(_pos) + 1; }
+
+            void column(context & ctxt, int idx) const;
+        private:
+            const array * _array = nullptr;
+            size_t _pos = 0;
+            size_t _end = 0;
+        };
+
+    private:
+        static void bind(statement & stmt, int idx, const array & arr);
+    };
+
+    /** @} */
+
+#endif
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_CARRAY_IMPL_INCLUDED
+#define HEADER_SQLITEPP_CARRAY_IMPL_INCLUDED
+
+#include "carray_iface.hpp"
+
+#include <algorithm>
+#include <memory>
+
+namespace thinsqlitepp
+{
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+
+    inline carray::carray(connect_t, database * db, int /*argc*/, const char * const * /*argv*/)
+    {
+        db->declare_vtab("CREATE TABLE x(value, pointer HIDDEN)");
+    }
+
+    inline void carray::bind(statement & stmt, int idx, const array & arr)
+    {
+        //SQLite calls the destructor if binding fails
+        auto ptr = std::make_unique<array>(arr);
+        stmt.bind<array>(idx, ptr.release(), array::pointer_type, [](array * p) { delete p; });
+    }
+
+    inline bool carray::best_index(index_info<> & info) const
+    {
+        const auto constraints = info.constraints();
+        auto usages = info.constraints_usage();
+
+        bool found = false;
+        for (size_t i = 0; i < constraints.size(); ++i)
+        {
+            auto & constraint = constraints[i];
+            if (constraint.iColumn == 1 && constraint.op == SQLITE_INDEX_CONSTRAINT_EQ && constraint.usable)
+            {
+                usages[i].argvIndex = 1;
+                usages[i].omit = true;
+                found = true;
+                break;
+            }
+        }
+        //without the array argument there is nothing to produce
+        if (!found)
+            return false;
+
+        //elements are produced in rowid order
+        auto orderbys = info.orderbys();
+        if (orderbys.size() == 1 && orderbys[0].iColumn < 0 && !orderbys[0].desc)
+            info.set_order_by_consumed(true);
+
+        /*
+         The array size is not known until filter so assume a typical IN list. Producing an element
+         is much cheaper than reading a row from a real table so let the planner prefer driving
+         lookups from the array.
+        */
+        constexpr double expected_rows = 100;
+        info.set_estimated_cost(expected_rows / 10);
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 8, 2)
+        info.set_estimated_rows(int64_t(expected_rows));
+    #endif
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+        info.set_index_number(info.forward_limit_offset());
+    #endif
+        return true;
+    }
+
+    inline void carray::cursor::filter([[maybe_unused]] int idx, int argc, value ** argv)
+    {
+        _pos = 0;
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+        auto limits = limit_offset::extract(idx, argc, argv);
+    #endif
+        //a NULL or foreign pointer simply produces no rows
+        _array = argc > 0 ? argv[0]->get<const array *>(array::pointer_type) : nullptr;
+        _end = _array ? _array->size() : 0;
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+        _pos = size_t(std::min(uint64_t(limits.offset), uint64_t(_end)));
+        if (limits.limit >= 0)
+            _end = _pos + size_t(std::min(uint64_t(limits.limit), uint64_t(_end - _pos)));
+    #endif
+    }
+
+    inline void carray::cursor::column(context & ctxt, int idx) const
+    {
+        if (idx != 0)
+        {
+            ctxt.result(nullptr);
+            return;
+        }
+        switch(_array->type())
+        {
+            case SQLITE_INTEGER:
+                ctxt.result(static_cast<const int64_t *>(_array->data())[_pos]);
+                break;
+            case SQLITE_FLOAT:
+                ctxt.result(static_cast<const double *>(_array->data())[_pos]);
+                break;
+            default:
+                //the data is owned by the caller and outlives the statement
+                ctxt.result_reference(static_cast<const std::string_view *>(_array->data())[_pos]);
+        }
+    }
+
+#endif
+}
+
+#endif
@@ -0,0 +1,345 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_CHANGE_CAPTURE_IFACE_INCLUDED
+#define HEADER_SQLITEPP_CHANGE_CAPTURE_IFACE_INCLUDED
+
+#include "database_iface.hpp"
+#include "owned_value.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace thinsqlitepp
+{
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Bounded single-producer, multi-consumer lock-free ring buffer
+     *
+     * Only one thread may call the producer methods (try_push(), can_push()) at a time.
+     * Any number of threads may call the consumer methods (try_pop(), pop()) concurrently.
+     * Neither side ever blocks or allocates memory after construction.
+     *
+     * The implementation is a bounded queue where each slot carries a sequence number
+     * indicating whether it is free or holds a published item.
+     *
+     * `#include <thinsqlitepp/change_capture.hpp>`
+     *
+     * @tparam T Type of items. Must be nothrow move constructible.
+     */
+    template<class T>
+    class spmc_ring
+    {
+        static_assert(std::is_nothrow_move_constructible_v<T>, "ring items must be nothrow move constructible");
+    public:
+        /**
+         * Constructs a ring able to hold at least @p capacity items
+         *
+         * The actual capacity is rounded up to the next power of 2
+         */
+        explicit spmc_ring(size_t capacity):
+            _mask(round_capacity(capacity) - 1),
+            _cells(new cell[_mask + 1])
+        {
+            for(size_t i = 0; i <= _mask; ++i)
+                _cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+        spmc_ring(const spmc_ring &) = delete;
+        spmc_ring & operator=(const spmc_ring &) = delete;
+
+        /// Maximum number of items the ring can hold
+        size_t capacity() const noexcept
+            { return _mask + 1; }
+
+        /**
+         * Whether the next @p count items can be pushed without failure
+         *
+         * Producer side only. A `true` result stays valid until the next push since
+         * consumers can only make more room.
+         */
+        bool can_push(size_t count) const noexcept
+        {
+            if (count > capacity())
+                return false;
+            size_t tail = _tail.value.load(std::memory_order_relaxed);
+            for(size_t pos = tail; pos != tail + count; ++pos)
+            {
+                if (_cells[pos & _mask].seq.load(std::memory_order_acquire) != pos)
+                    return false;
+            }
+            return true;
+        }
+
+        /**
+         * Attempt to add an item to the ring
+         *
+         * Producer side only.
+         * @returns `false` if the ring is full. In this case @p item is not moved from.
+         */
+        bool try_push(T && item) noexcept
+        {
+            size_t pos = _tail.value.load(std::memory_order_relaxed);
+            cell & c = _cells[pos & _mask];
+            if (c.seq.load(std::memory_order_acquire) != pos)
+                return false;
+            c.item.emplace(std::move(item));
+            c.seq.store(pos + 1, std::memory_order_release);
+            _tail.value.store(pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+         * Attempt to remove an item from the ring
+         *
+         * Can be called concurrently from any number of threads.
+         * @returns The removed item or std::nullopt if the ring is empty
+         */
+        std::optional<T> try_pop() noexcept
+        {
+            std::optional<T> ret;
+            pop([&](T && item) noexcept { ret.emplace(std::move(item)); }, 1);
+            return ret;
+        }
+
+        /**
+         * Remove up to @p max_count items from the ring in one batch
+         *
+         * The batch is claimed atomically so items from one batch are never interleaved with
+         * items taken by other consumers. Can be called concurrently from any number of threads.
+         *
+         * @param sink A callable invocable as `sink(T &&)` that receives the items in order.
+         * It must not throw.
+         * @param max_count Maximum number of items to remove
+         * @returns Number of items removed
+         */
+        template<class Sink>
+        size_t pop(Sink && sink, size_t max_count) noexcept
+        {
+            size_t head = _head.value.load(std::memory_order_relaxed);
+            size_t count;
+            for ( ; ; )
+            {
+                count = 0;
+                while (count < max_count && count <= _mask &&
+                       _cells[(head + count) & _mask].seq.load(std::memory_order_acquire) == head + count + 1)
+                {
+                    ++count;
+                }
+                if (count == 0)
+                {
+                    size_t current = _head.value.load(std::memory_order_relaxed);
+                    if (current == head)
+                        return 0;
+                    head = current;
+                    continue;
+                }
+                if (_head.value.compare_exchange_weak(head, head + count, std::memory_order_relaxed))
+                    break;
+            }
+            for(size_t pos = head; pos != head + count; ++pos)
+            {
+                cell & c = _cells[pos & _mask];
+                sink(std::move(*c.item));
+                c.item.reset();
+                c.seq.store(pos + _mask + 1, std::memory_order_release);
+            }
+            return count;
+        }
+    private:
+        static size_t round_capacity(size_t capacity)
+        {
+            size_t ret = 1;
+            while (ret < capacity)
+                ret <<= 1;
+            return ret;
+        }
+    private:
+        struct cell
+        {
+            std::atomic<size_t> seq;
+            std::optional<T> item;
+        };
+        //keeps producer and consumer indices on separate cache lines
+        struct padded_index
+        {
+            std::atomic<size_t> value{0};
+            char padding[64 - sizeof(std::atomic<size_t>)];
+        };
+
+        const size_t _mask;
+        std::unique_ptr<cell[]> _cells;
+        padded_index _head;
+        padded_index _tail;
+    };
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 16, 0) && defined(SQLITE_ENABLE_PREUPDATE_HOOK)
+
+    /**
+     * A single row change captured by @ref change_capture
+     *
+     * `#include <thinsqlitepp/change_capture.hpp>`
+     */
+    struct change_event
+    {
+        /// Sequence number of the committed transaction this change belongs to. Starts at 1.
+        uint64_t transaction;
+        /// One of `SQLITE_INSERT`, `SQLITE_UPDATE` or `SQLITE_DELETE`
+        int op;
+        /// Name of the database (`main`, `temp` or attached name)
+        std::string db_name;
+        /// Name of the table
+        std::string table;
+        /// Rowid of the row before the change. Undefined for `SQLITE_INSERT`
+        int64_t old_rowid;
+        /// Rowid of the row after the change. Undefined for `SQLITE_DELETE`
+        int64_t new_rowid;
+        /// Column values before the change. Empty for `SQLITE_INSERT`
+        std::vector<owned_value> old_values;
+        /// Column values after the change. Empty for `SQLITE_DELETE`
+        std::vector<owned_value> new_values;
+    };
+
+    /**
+     * Change data capture stream for a @ref database
+     *
+     * This class installs a preupdate, commit, rollback and trace hooks on a database and records
+     * every row change made through it, including the full old and new column values.
+     * Changes are staged per transaction: they are published into a bounded lock-free
+     * @ref spmc_ring when the transaction commits and discarded if it rolls back. Changes undone
+     * by `ROLLBACK TO` or by a statement that fails inside an explicit transaction are
+     * discarded from the staged transaction too. Any number of consumer threads can drain the
+     * published changes in batches via consume() without ever taking a lock or touching SQLite.
+     *
+     * The hooks are owned by this object while it exists: do not set preupdate, commit,
+     * rollback or trace hooks on the same database yourself. The database must outlive this
+     * object and the producer side (the database connection) must be used from one thread at
+     * a time, as usual.
+     *
+     * Statement boundaries are observed via ::sqlite3_trace_v2 with #SQLITE_TRACE_STMT and
+     * #SQLITE_TRACE_PROFILE. SQLite does not report whether a statement failed to its hooks,
+     * so a statement that changed rows directly is considered undone if ::sqlite3_changes
+     * is 0 once it ends. A failing statement that changed rows _only_ through triggers,
+     * such as an `INSERT` into a view with an `INSTEAD OF` trigger, cannot be told apart from
+     * a successful one this way and its changes are kept.
+     *
+     * Changes made to virtual tables and `WITHOUT ROWID` tables follow the rules of
+     * ::sqlite3_preupdate_hook
+     *
+     * Available only if #SQLITE_ENABLE_PREUPDATE_HOOK is defined during compilation
+     *
+     * `#include <thinsqlitepp/change_capture.hpp>`
+     *
+     * @since SQLite 3.16
+     */
+    class change_capture
+    {
+    public:
+        /// What to do when a committing transaction does not fit into the ring
+        enum class overflow_policy
+        {
+            /// Fail the commit. It becomes a rollback and reports `SQLITE_CONSTRAINT_COMMITHOOK`
+            abort_commit,
+            /// Let the commit through and drop the transaction changes. See dropped()
+            drop
+        };
+    public:
+        /**
+         * Start capturing changes on a database
+         *
+         * @param db Database to capture. Must outlive this object
+         * @param capacity Maximum number of published changes waiting for consumers
+         * @param policy What to do if a transaction's changes do not fit
+         */
+        change_capture(database & db, size_t capacity, overflow_policy policy = overflow_policy::abort_commit);
+        /// Stops capturing and removes the hooks
+        ~change_capture() noexcept;
+
+        change_capture(const change_capture &) = delete;
+        change_capture & operator=(const change_capture &) = delete;
+
+        /**
+         * Remove up to @p max_count published changes in one batch
+         *
+         * Thread safe: can be called concurrently from any number of threads. Changes of a
+         * single transaction are published together but a batch boundary can fall anywhere.
+         * Use change_event::transaction to group them.
+         *
+         * @param out An output iterator accepting `change_event &&`. Assigning through it must not throw.
+         * @param max_count Maximum number of changes to remove
+         * @returns Number of changes removed
+         */
+        template<class OutIt>
+        size_t consume(OutIt out, size_t max_count) noexcept
+        {
+            return _ring.pop([&](change_event && event) noexcept { *out++ = std::move(event); }, max_count);
+        }
+
+        /// @overload
+        size_t consume(std::vector<change_event> & batch, size_t max_count)
+        {
+            batch.reserve(batch.size() + std::min(max_count, _ring.capacity()));
+            return consume(std::back_inserter(batch), max_count);
+        }
+
+        /// Number of committed changes that were dropped due to overflow_policy::drop
+        uint64_t dropped() const noexcept
+            { return _dropped.load(std::memory_order_relaxed); }
+
+        /// Maximum number of published changes waiting for consumers
+        size_t capacity() const noexcept
+            { return _ring.capacity(); }
+
+    private:
+        void on_change(database * db, int op, const char * db_name, const char * table,
+                       int64_t rowid_old, int64_t rowid_new) noexcept;
+        bool on_commit() noexcept;
+        void on_rollback() noexcept;
+        void on_statement_start(sqlite3_stmt * stmt) noexcept;
+        void on_statement_end(sqlite3_stmt * stmt) noexcept;
+        void on_savepoint(const char * sql);
+        void discard_from(size_t mark) noexcept;
+        void reset_boundaries() noexcept;
+    private:
+        //a running top-level statement
+        struct statement_frame
+        {
+            sqlite3_stmt * stmt;
+            size_t mark;    //size of _pending when it started
+            bool direct;    //changed rows itself rather than only via triggers
+        };
+        struct savepoint
+        {
+            std::string name;
+            size_t mark;    //size of _pending when it was created
+        };
+    private:
+        database & _db;
+        overflow_policy _policy;
+        spmc_ring<change_event> _ring;
+        std::vector<change_event> _pending;
+        std::vector<statement_frame> _statements;
+        std::vector<savepoint> _savepoints;
+        uint64_t _transaction = 0;
+        bool _failed = false;
+        std::atomic<uint64_t> _dropped{0};
+    };
+
+#endif
+
+    /** @} */
+}
+
+#endif
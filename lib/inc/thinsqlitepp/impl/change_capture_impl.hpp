@@ -0,0 +1,335 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_CHANGE_CAPTURE_IMPL_INCLUDED
+#define HEADER_SQLITEPP_CHANGE_CAPTURE_IMPL_INCLUDED
+
+#include "change_capture_iface.hpp"
+#include "database_impl.hpp"
+
+namespace thinsqlitepp
+{
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 16, 0) && defined(SQLITE_ENABLE_PREUPDATE_HOOK)
+
+    namespace internal
+    {
+        //Just enough of SQL tokenizer to recognize SAVEPOINT name, RELEASE [SAVEPOINT] name
+        //and ROLLBACK [TRANSACTION] TO [SAVEPOINT] name statements
+        class savepoint_sql_scanner
+        {
+        public:
+            savepoint_sql_scanner(const char * sql) noexcept:
+                _cur(sql)
+            {}
+
+            //consumes the next token if it is the given (uppercase) keyword
+            bool keyword(const char * word) noexcept
+            {
+                skip_space();
+                const char * p = _cur;
+                for ( ; *word; ++word, ++p)
+                {
+                    if (to_upper(*p) != *word)
+                        return false;
+                }
+                if (is_identifier_char(*p))
+                    return false;
+                _cur = p;
+                return true;
+            }
+
+            //consumes the next token as an identifier, uppercased since savepoint names
+            //are compared case-insensitively
+            bool identifier(std::string & name)
+            {
+                skip_space();
+                name.clear();
+                char close;
+                switch (*_cur)
+                {
+                    case '"':  close = '"';  break;
+                    case '\'': close = '\''; break;
+                    case '`':  close = '`';  break;
+                    case '[':  close = ']';  break;
+                    default:
+                        while (is_identifier_char(*_cur))
+                            name += to_upper(*_cur++);
+                        return !name.empty();
+                }
+                for (++_cur; *_cur; ++_cur)
+                {
+                    if (*_cur == close)
+                    {
+                        if (close == ']' || _cur[1] != close)
+                        {
+                            ++_cur;
+                            return true;
+                        }
+                        ++_cur;
+                    }
+                    name += to_upper(*_cur);
+                }
+                return false;
+            }
+        private:
+            void skip_space() noexcept
+            {
+                for ( ; ; )
+                {
+                    if (*_cur == ' ' || *_cur == '\t' || *_cur == '\n' || *_cur == '\f' || *_cur == '\r')
+                    {
+                        ++_cur;
+                    }
+                    else if (_cur[0] == '-' && _cur[1] == '-')
+                    {
+                        while (*_cur && *_cur != '\n')
+                            ++_cur;
+                    }
+                    else if (_cur[0] == '/' && _cur[1] == '*')
+                    {
+                        for (_cur += 2; *_cur && !(_cur[0] == '*' && _cur[1] == '/'); ++_cur)
+                        {}
+                        if (*_cur)
+                            _cur += 2;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+            }
+
+            static bool is_identifier_char(char c) noexcept
+            {
+                return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                        c == '_' || c == '$' || (unsigned char)c >= 0x80;
+            }
+
+            static char to_upper(char c) noexcept
+                { return c >= 'a' && c <= 'z' ? char(c - 'a' + 'A') : c; }
+        private:
+            const char * _cur;
+        };
+    }
+
+    inline change_capture::change_capture(database & db, size_t capacity, overflow_policy policy):
+        _db(db),
+        _policy(policy),
+        _ring(capacity)
+    {
+        _db.preupdate_hook([](change_capture * me, database * db, int op, const char * db_name, const char * table,
+                              sqlite3_int64 rowid_old, sqlite3_int64 rowid_new) noexcept {
+            me->on_change(db, op, db_name, table, rowid_old, rowid_new);
+        }, this);
+        _db.commit_hook([](change_capture * me) noexcept -> int {
+            return me->on_commit();
+        }, this);
+        _db.rollback_hook([](change_capture * me) noexcept {
+            me->on_rollback();
+        }, this);
+        sqlite3_trace_v2(_db.c_ptr(), SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE,
+                         [](unsigned type, void * data, void * stmt, void *) noexcept -> int {
+            auto me = static_cast<change_capture *>(data);
+            if (type == SQLITE_TRACE_STMT)
+                me->on_statement_start(static_cast<sqlite3_stmt *>(stmt));
+            else
+                me->on_statement_end(static_cast<sqlite3_stmt *>(stmt));
+            return 0;
+        }, this);
+    }
+
+    inline change_capture::~change_capture() noexcept
+    {
+        _db.preupdate_hook(nullptr, nullptr);
+        _db.commit_hook(nullptr, nullptr);
+        _db.rollback_hook(nullptr, nullptr);
+        sqlite3_trace_v2(_db.c_ptr(), 0, nullptr, nullptr);
+    }
+
+    inline void change_capture::on_change(database * db, int op, const char * db_name, const char * table,
+                                          int64_t rowid_old, int64_t rowid_new) noexcept
+    {
+        if (_failed)
+            return;
+        try
+        {
+            auto & event = _pending.emplace_back();
+            event.op = op;
+            event.db_name = db_name;
+            event.table = table;
+            event.old_rowid = rowid_old;
+            event.new_rowid = rowid_new;
+            if (!_statements.empty() && db->preupdate_depth() == 0)
+                _statements.back().direct = true;
+            int count = db->preupdate_count();
+            if (op != SQLITE_INSERT)
+            {
+                event.old_values.reserve(size_t(count));
+                for (int i = 0; i < count; ++i)
+                    event.old_values.emplace_back(*db->preupdate_old(i));
+            }
+            if (op != SQLITE_DELETE)
+            {
+                event.new_values.reserve(size_t(count));
+                for (int i = 0; i < count; ++i)
+                    event.new_values.emplace_back(*db->preupdate_new(i));
+            }
+        }
+        catch(...)
+        {
+            //we cannot report the error from here so make sure the commit fails instead
+            //of silently losing changes
+            _failed = true;
+            _pending.clear();
+        }
+    }
+
+    inline bool change_capture::on_commit() noexcept
+    {
+        //an aborted commit turns into a rollback which resets the rest
+        if (_failed)
+            return true;
+        if (!_pending.empty())
+        {
+            if (!_ring.can_push(_pending.size()))
+            {
+                if (_policy == overflow_policy::abort_commit)
+                    return true;
+                _dropped.fetch_add(_pending.size(), std::memory_order_relaxed);
+            }
+            else
+            {
+                ++_transaction;
+                for(auto & event: _pending)
+                {
+                    event.transaction = _transaction;
+                    _ring.try_push(std::move(event));
+                }
+            }
+            _pending.clear();
+        }
+        reset_boundaries();
+        return false;
+    }
+
+    inline void change_capture::on_rollback() noexcept
+    {
+        _pending.clear();
+        _failed = false;
+        reset_boundaries();
+    }
+
+    inline void change_capture::on_statement_start(sqlite3_stmt * stmt) noexcept
+    {
+        //trigger programs of the running statement report the same statement
+        if (!_statements.empty() && _statements.back().stmt == stmt)
+            return;
+        //a transaction that changed nothing ends without calling the commit hook
+        if (_statements.empty() && _db.get_autocommit())
+            _savepoints.clear();
+        try
+        {
+            _statements.push_back({stmt, _pending.size(), false});
+        }
+        catch(...)
+        {
+            _failed = true;
+            _pending.clear();
+        }
+    }
+
+    inline void change_capture::on_statement_end(sqlite3_stmt * stmt) noexcept
+    {
+        auto it = std::find_if(_statements.rbegin(), _statements.rend(), [stmt](const statement_frame & frame) {
+            return frame.stmt == stmt;
+        });
+        if (it == _statements.rend())
+            return;
+        statement_frame frame = *it;
+        _statements.erase(std::prev(it.base()), _statements.end());
+        if (_failed)
+            return;
+        //A statement that fails with ABORT is rolled back and reports no changes. One that
+        //fails with FAIL keeps and reports the changes it made before the failure.
+        if (frame.direct && _db.changes() == 0)
+            discard_from(frame.mark);
+        try
+        {
+            if (const char * sql = sqlite3_sql(stmt))
+                on_savepoint(sql);
+        }
+        catch(...)
+        {
+            _failed = true;
+            _pending.clear();
+        }
+    }
+
+    inline void change_capture::on_savepoint(const char * sql)
+    {
+        internal::savepoint_sql_scanner scanner(sql);
+        std::string name;
+        auto find = [&]() {
+            auto it = std::find_if(_savepoints.rbegin(), _savepoints.rend(), [&](const savepoint & sp) {
+                return sp.name == name;
+            });
+            return it == _savepoints.rend() ? _savepoints.end() : std::prev(it.base());
+        };
+
+        //SQLite does not tell us whether the statement succeeded. RELEASE and ROLLBACK TO
+        //fail when there is no such savepoint and are ignored below in this case. A SAVEPOINT
+        //that succeeds always leaves a transaction open.
+        if (scanner.keyword("SAVEPOINT"))
+        {
+            if (!_db.get_autocommit() && scanner.identifier(name))
+                _savepoints.push_back({std::move(name), _pending.size()});
+        }
+        else if (scanner.keyword("RELEASE"))
+        {
+            scanner.keyword("SAVEPOINT");
+            if (scanner.identifier(name))
+                _savepoints.erase(find(), _savepoints.end());
+        }
+        else if (scanner.keyword("ROLLBACK"))
+        {
+            scanner.keyword("TRANSACTION");
+            if (scanner.keyword("TO"))
+            {
+                scanner.keyword("SAVEPOINT");
+                if (!scanner.identifier(name))
+                    return;
+                auto it = find();
+                if (it == _savepoints.end())
+                    return;
+                //the savepoint itself stays on the stack
+                discard_from(it->mark);
+                _savepoints.erase(it + 1, _savepoints.end());
+            }
+        }
+    }
+
+    inline void change_capture::discard_from(size_t mark) noexcept
+    {
+        if (mark < _pending.size())
+            _pending.erase(_pending.begin() + mark, _pending.end());
+    }
+
+    inline void change_capture::reset_boundaries() noexcept
+    {
+        _savepoints.clear();
+        for (auto & frame: _statements)
+        {
+            frame.mark = 0;
+            frame.direct = false;
+        }
+    }
+
+#endif
+}
+
+#endif
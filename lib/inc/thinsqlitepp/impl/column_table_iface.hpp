@@ -0,0 +1,215 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_COLUMN_TABLE_IFACE_INCLUDED
+#define HEADER_SQLITEPP_COLUMN_TABLE_IFACE_INCLUDED
+
+#include "vtab_iface.hpp"
+#include "constraint_bound.hpp"
+
+#include <array>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace thinsqlitepp
+{
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Description of the columns exposed by a @ref column_table
+     *
+     * Each column is a contiguous array of `int64_t`, `double` or `std::string_view` values
+     * owned by the caller. The data is referenced, never copied, so it must outlive any
+     * use of the virtual table. All columns must have the same number of elements.
+     *
+     * `#include <thinsqlitepp/column_table.hpp>`
+     */
+    class column_set
+    {
+    public:
+        /// A single column
+        struct column
+        {
+            std::string name;   ///< Column name
+            int type;           ///< One of SQLITE_INTEGER, SQLITE_FLOAT or SQLITE_TEXT
+            const void * data;  ///< Pointer to the first element
+        };
+    public:
+        /**
+         * Add an `INTEGER` column
+         *
+         * @throws exception with SQLITE_MISUSE if the size of @p data differs from the existing columns
+         */
+        column_set & add(std::string name, span<const int64_t> data)
+            { return add(std::move(name), SQLITE_INTEGER, data.data(), data.size()); }
+        /**
+         * Add a `REAL` column
+         *
+         * @throws exception with SQLITE_MISUSE if the size of @p data differs from the existing columns
+         */
+        column_set & add(std::string name, span<const double> data)
+            { return add(std::move(name), SQLITE_FLOAT, data.data(), data.size()); }
+        /**
+         * Add a `TEXT` column
+         *
+         * @throws exception with SQLITE_MISUSE if the size of @p data differs from the existing columns
+         */
+        column_set & add(std::string name, span<const std::string_view> data)
+            { return add(std::move(name), SQLITE_TEXT, data.data(), data.size()); }
+
+        /// Number of columns
+        size_t size() const noexcept
+            { return _columns.size(); }
+        /// Number of rows
+        size_t rows() const noexcept
+            { return _rows; }
+        /// Access a column by index
+        const column & operator[](size_t idx) const noexcept
+            { return _columns[idx]; }
+
+        /// Returns `CREATE TABLE` statement describing the columns suitable for database::declare_vtab
+        std::string declaration() const;
+    private:
+        column_set & add(std::string name, int type, const void * data, size_t size);
+    private:
+        std::vector<column> _columns;
+        size_t _rows = 0;
+    };
+
+    /**
+     * A read-only virtual table over columns of in-memory data
+     *
+     * This allows querying large in-memory datasets with SQL without copying them into real tables first.
+     * The data is described by a @ref column_set passed to create_module(). The table rowid is the row's index.
+     * ```
+     * std::vector<int64_t> ids = ...;
+     * std::vector<double> prices = ...;
+     * column_set columns;
+     * columns.add("id", ids).add("price", prices);
+     * column_table::create_module(*db, "orders", &columns);
+     *
+     * db->exec("SELECT sum(price) FROM orders WHERE id BETWEEN 100 AND 200", ...);
+     * ```
+     * With SQLite 3.9 or above the module is eponymous and can be queried directly. With older versions
+     * use `CREATE VIRTUAL TABLE temp.name USING module_name` first.
+     *
+     * Comparison (`=`, `<`, `<=`, `>`, `>=`) and, with SQLite 3.38 or above, `IN` constraints on the columns and
+     * rowid are evaluated by the table itself over the column arrays. Rowid constraints narrow the range of rows
+     * scanned. Column constraints are evaluated over fixed-size chunks of that range, producing a small selection
+     * vector of matching rows for one chunk at a time. Text constraints are only handled when they use the `BINARY`
+     * collation. SQLite still double checks the constraints on the rows returned so the results are always the same
+     * as with a full scan. Column values are only produced for the columns the statement actually reads.
+     *
+     * `#include <thinsqlitepp/column_table.hpp>`
+     */
+    class column_table : public vtab<column_table>
+    {
+    public:
+        /**
+         * Data passed between best_index() and cursor::filter()
+         *
+         * The terms are in the same order as the `argv` values passed to filter
+         */
+        struct scan_plan : public sqlite_allocated
+        {
+            /// A single constraint
+            struct term
+            {
+                int column;     ///< Column index or -1 for rowid
+                int op;         ///< SQLITE_INDEX_CONSTRAINT_ value
+                bool in;        ///< Whether this is an IN constraint processed all-at-once
+            };
+
+            size_t count;
+            term terms[1];
+        };
+        static_assert(std::is_trivially_destructible_v<scan_plan>);
+
+        using constructor_data_type = const column_set *;
+        using index_data_type = scan_plan *;
+    public:
+        column_table(
+        #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 9, 0)
+            connect_t,
+        #endif
+            database * db, const column_set * columns, int argc, const char * const * argv);
+
+        bool best_index(index_info<index_data_type> & info) const;
+
+        class cursor : public vtab::cursor
+        {
+        public:
+            using vtab::cursor::cursor;
+
+            void filter(int idx, scan_plan * plan, int argc, value ** argv);
+
+            bool eof() const noexcept
+                { return _pos == _end; }
+
+            void next()
+            {
+                if (++_pos == _end && !_selectors.empty())
+                    load_chunk();
+            }
+
+            int64_t rowid() const
+                { return int64_t(row()); }
+
+            void column(context & ctxt, int idx) const;
+        private:
+            //rows are filtered this many at a time
+            static constexpr size_t chunk_size = 1024;
+
+            //filters a chunk of rows starting at base. On the first call for a chunk (initial == true)
+            //produces the selection from all rows, otherwise narrows the existing one. Returns the new
+            //selection size
+            using selector = std::function<size_t (size_t base, size_t size, uint16_t * selection,
+                                                   size_t count, bool initial)>;
+
+            size_t row() const noexcept
+                { return _selectors.empty() ? _pos : _base + _selection[_pos]; }
+
+            void load_chunk();
+
+            bool restrict_rowid(const scan_plan::term & term, const value & arg, size_t & first, size_t & last) const noexcept;
+            bool restrict_column(const scan_plan::term & term, const value & arg);
+            template<class T>
+            bool restrict_compare(const T * data, int op, const value & arg);
+        #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+            template<class T>
+            bool restrict_in(const T * data, const value & arg);
+        #endif
+            template<class T, class Pred>
+            void add_selector(const T * data, Pred pred);
+            template<class T, class Pred>
+            static size_t select(const T * block, size_t size, uint16_t * selection, size_t count, bool initial,
+                                 const Pred & pred) noexcept;
+        private:
+            std::vector<selector> _selectors;
+            std::array<uint16_t, chunk_size> _selection;
+            size_t _base = 0;   //first row of the current chunk
+            size_t _next = 0;   //first row of the next chunk
+            size_t _last = 0;   //end of the range to scan
+            size_t _pos = 0;
+            size_t _end = 0;
+        };
+    private:
+        static scan_plan * allocate_plan(size_t count);
+    private:
+        const column_set * _columns;
+    };
+
+    /** @} */
+}
+
+#endif
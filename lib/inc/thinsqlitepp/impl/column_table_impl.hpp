@@ -0,0 +1,444 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_COLUMN_TABLE_IMPL_INCLUDED
+#define HEADER_SQLITEPP_COLUMN_TABLE_IMPL_INCLUDED
+
+#include "column_table_iface.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stddef.h>
+
+namespace thinsqlitepp
+{
+    //MARK: - column_set
+
+    inline column_set & column_set::add(std::string name, int type, const void * data, size_t size)
+    {
+        if (!_columns.empty() && size != _rows)
+            throw exception(SQLITE_MISUSE, error::message_ptr("all columns in a column_set must have the same size"));
+        _columns.push_back(column{std::move(name), type, data});
+        _rows = size;
+        return *this;
+    }
+
+    inline std::string column_set::declaration() const
+    {
+        std::string ret = "CREATE TABLE x(";
+        for (size_t i = 0; i < _columns.size(); ++i)
+        {
+            if (i != 0)
+                ret += ", ";
+            ret += '"';
+            for (char c: _columns[i].name)
+            {
+                if (c == '"')
+                    ret += '"';
+                ret += c;
+            }
+            ret += '"';
+            switch(_columns[i].type)
+            {
+                case SQLITE_INTEGER: ret += " INTEGER"; break;
+                case SQLITE_FLOAT:   ret += " REAL"; break;
+                default:             ret += " TEXT"; break;
+            }
+        }
+        ret += ')';
+        return ret;
+    }
+
+    //MARK: - column_table
+
+    inline column_table::column_table(
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 9, 0)
+        connect_t,
+    #endif
+        database * db, const column_set * columns, int /*argc*/, const char * const * /*argv*/):
+        _columns(columns)
+    {
+        if (!columns || columns->size() == 0)
+            throw exception(SQLITE_MISUSE, error::message_ptr("column_table requires a non-empty column_set"));
+        db->declare_vtab(columns->declaration());
+    }
+
+    inline auto column_table::allocate_plan(size_t count) -> scan_plan *
+    {
+        size_t alloc_size = offsetof(scan_plan, terms) + sizeof(scan_plan::term) * count;
+        auto ret = (scan_plan *)scan_plan::operator new(alloc_size);
+        ret->count = 0;
+        return ret;
+    }
+
+    inline bool column_table::best_index(index_info<index_data_type> & info) const
+    {
+        const auto constraints = info.constraints();
+        auto usages = info.constraints_usage();
+        const double rows = double(_columns->rows());
+
+        std::unique_ptr<scan_plan> plan;
+        size_t column_terms = 0;
+        double estimated_rows = rows;
+        [[maybe_unused]] bool unique = false;
+
+        for (size_t i = 0; i < constraints.size(); ++i)
+        {
+            auto & constraint = constraints[i];
+            if (!constraint.usable)
+                continue;
+            switch(constraint.op)
+            {
+                case SQLITE_INDEX_CONSTRAINT_EQ:
+                case SQLITE_INDEX_CONSTRAINT_GT:
+                case SQLITE_INDEX_CONSTRAINT_GE:
+                case SQLITE_INDEX_CONSTRAINT_LT:
+                case SQLITE_INDEX_CONSTRAINT_LE:
+                    break;
+                default:
+                    continue;
+            }
+            if (constraint.iColumn >= 0 && (*_columns)[size_t(constraint.iColumn)].type == SQLITE_TEXT)
+            {
+                //we compare text bytewise so only BINARY collation can be handled
+            #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 22, 0)
+                const char * collation = info.collation(int(i));
+                if (collation && sqlite3_stricmp(collation, "BINARY") != 0)
+                    continue;
+            #else
+                continue;
+            #endif
+            }
+
+            if (!plan)
+                plan.reset(allocate_plan(constraints.size()));
+            auto & term = plan->terms[plan->count];
+            term.column = constraint.iColumn;
+            term.op = constraint.op;
+            term.in = false;
+        #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+            //rowid IN is best served one value at a time, for columns get the whole list at once
+            if (constraint.iColumn >= 0 && info.is_in(int(i)))
+            {
+                info.handle_in(int(i), true);
+                term.in = true;
+            }
+        #endif
+            //SQLite still checks the constraint so we never need to be exact
+            usages[i].argvIndex = int(++plan->count);
+
+            if (constraint.iColumn >= 0)
+                ++column_terms;
+            if (constraint.op != SQLITE_INDEX_CONSTRAINT_EQ)
+            {
+                estimated_rows /= 3;
+            }
+            else if (constraint.iColumn < 0)
+            {
+                estimated_rows = std::min(estimated_rows, 1.);
+                unique = true;
+            }
+            else
+            {
+                estimated_rows /= term.in ? 4 : 10;
+            }
+        }
+
+        size_t used_columns = _columns->size();
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 10, 0)
+        //only the columns the statement reads are ever fetched
+        const uint64_t used_mask = info.columns_used();
+        used_columns = 0;
+        for (size_t i = 0; i < _columns->size(); ++i)
+            used_columns += (used_mask & (uint64_t(1) << std::min(i, size_t(63)))) != 0;
+    #endif
+
+        //scanning a column array is much cheaper than producing a row for SQLite
+        const double scan_cost = rows * double(column_terms) / 16;
+        info.set_estimated_cost(scan_cost + estimated_rows * double(1 + used_columns));
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 8, 2)
+        info.set_estimated_rows(int64_t(std::ceil(estimated_rows)));
+    #endif
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 9, 0)
+        if (unique)
+            info.set_index_flags(info.index_flags() | SQLITE_INDEX_SCAN_UNIQUE);
+    #endif
+
+        //rows are always produced in rowid order
+        auto orderbys = info.orderbys();
+        if (orderbys.size() == 1 && orderbys[0].iColumn < 0 && !orderbys[0].desc)
+            info.set_order_by_consumed(true);
+
+        if (plan)
+        {
+            info.set_index_number(1);
+            info.set_index_data(std::move(plan));
+        }
+        return true;
+    }
+
+    //MARK: - column_table::cursor
+
+    inline void column_table::cursor::filter(int /*idx*/, scan_plan * plan, [[maybe_unused]] int argc, value ** argv)
+    {
+        size_t first = 0;
+        size_t last = owner()->_columns->rows();
+        bool any = true;
+
+        _selectors.clear();
+        if (plan)
+        {
+            assert(size_t(argc) == plan->count);
+
+            //rowid constraints narrow the range to scan so apply them first
+            for (size_t i = 0; i < plan->count && any; ++i)
+            {
+                if (plan->terms[i].column < 0)
+                    any = restrict_rowid(plan->terms[i], *argv[i], first, last);
+            }
+            for (size_t i = 0; i < plan->count && any; ++i)
+            {
+                if (plan->terms[i].column >= 0)
+                    any = restrict_column(plan->terms[i], *argv[i]);
+            }
+        }
+
+        if (!any)
+        {
+            _selectors.clear();
+            _pos = _end = 0;
+        }
+        else if (!_selectors.empty())
+        {
+            _next = first;
+            _last = last;
+            load_chunk();
+        }
+        else
+        {
+            _pos = first;
+            _end = last;
+        }
+    }
+
+    inline void column_table::cursor::load_chunk()
+    {
+        _pos = _end = 0;
+        while (_next < _last)
+        {
+            const size_t base = _next;
+            const size_t size = std::min(chunk_size, _last - base);
+            _next += size;
+
+            size_t count = 0;
+            for (size_t i = 0; i < _selectors.size(); ++i)
+            {
+                count = _selectors[i](base, size, _selection.data(), count, i == 0);
+                if (count == 0)
+                    break;
+            }
+            if (count)
+            {
+                _base = base;
+                _end = count;
+                return;
+            }
+        }
+    }
+
+    inline void column_table::cursor::column(context & ctxt, int idx) const
+    {
+        auto & col = (*owner()->_columns)[size_t(idx)];
+        const size_t current = row();
+        switch(col.type)
+        {
+            case SQLITE_INTEGER:
+                ctxt.result(static_cast<const int64_t *>(col.data)[current]);
+                break;
+            case SQLITE_FLOAT:
+                ctxt.result(static_cast<const double *>(col.data)[current]);
+                break;
+            default:
+                //the data is owned by the caller and outlives the statement
+                ctxt.result_reference(static_cast<const std::string_view *>(col.data)[current]);
+        }
+    }
+
+    inline bool column_table::cursor::restrict_rowid(const scan_plan::term & term, const value & arg,
+                                                     size_t & first, size_t & last) const noexcept
+    {
+        auto bound = make_constraint_bound<int64_t>(term.op, arg);
+        if (bound.match == constraint_match::none)
+            return false;
+        if (bound.match == constraint_match::all)
+            return true;
+
+        const size_t rows = owner()->_columns->rows();
+        auto clamp = [rows](int64_t val) -> size_t {
+            if (val <= 0)
+                return 0;
+            return uint64_t(val) >= rows ? rows : size_t(val);
+        };
+        const int64_t val = bound.value;
+        switch(bound.op)
+        {
+            case SQLITE_INDEX_CONSTRAINT_EQ:
+                if (val < 0 || uint64_t(val) >= rows)
+                    return false;
+                first = std::max(first, size_t(val));
+                last = std::min(last, size_t(val) + 1);
+                break;
+            case SQLITE_INDEX_CONSTRAINT_GT:
+                if (val == std::numeric_limits<int64_t>::max())
+                    return false;
+                first = std::max(first, clamp(val + 1));
+                break;
+            case SQLITE_INDEX_CONSTRAINT_GE:
+                first = std::max(first, clamp(val));
+                break;
+            case SQLITE_INDEX_CONSTRAINT_LT:
+                last = std::min(last, clamp(val));
+                break;
+            case SQLITE_INDEX_CONSTRAINT_LE:
+                if (val != std::numeric_limits<int64_t>::max())
+                    last = std::min(last, clamp(val + 1));
+                break;
+        }
+        return first < last;
+    }
+
+    inline bool column_table::cursor::restrict_column(const scan_plan::term & term, const value & arg)
+    {
+        auto & col = (*owner()->_columns)[size_t(term.column)];
+
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+        if (term.in)
+        {
+            switch(col.type)
+            {
+                case SQLITE_INTEGER: return restrict_in(static_cast<const int64_t *>(col.data), arg);
+                case SQLITE_FLOAT:   return restrict_in(static_cast<const double *>(col.data), arg);
+                default:             return restrict_in(static_cast<const std::string_view *>(col.data), arg);
+            }
+        }
+    #endif
+
+        switch(col.type)
+        {
+            case SQLITE_INTEGER: return restrict_compare(static_cast<const int64_t *>(col.data), term.op, arg);
+            case SQLITE_FLOAT:   return restrict_compare(static_cast<const double *>(col.data), term.op, arg);
+            default:             return restrict_compare(static_cast<const std::string_view *>(col.data), term.op, arg);
+        }
+    }
+
+    template<class T>
+    bool column_table::cursor::restrict_compare(const T * data, int op, const value & arg)
+    {
+        auto bound = make_constraint_bound<T>(op, arg);
+        if (bound.match == constraint_match::none)
+            return false;
+        if (bound.match == constraint_match::all)
+            return true;
+
+        const T val = bound.value;
+        switch(bound.op)
+        {
+            case SQLITE_INDEX_CONSTRAINT_EQ:
+                add_selector(data, [val](const T & x) { return x == val; });
+                break;
+            case SQLITE_INDEX_CONSTRAINT_GT:
+                add_selector(data, [val](const T & x) { return x > val; });
+                break;
+            case SQLITE_INDEX_CONSTRAINT_GE:
+                add_selector(data, [val](const T & x) { return x >= val; });
+                break;
+            case SQLITE_INDEX_CONSTRAINT_LT:
+                add_selector(data, [val](const T & x) { return x < val; });
+                break;
+            case SQLITE_INDEX_CONSTRAINT_LE:
+                add_selector(data, [val](const T & x) { return x <= val; });
+                break;
+        }
+        return true;
+    }
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+
+    template<class T>
+    bool column_table::cursor::restrict_in(const T * data, const value & arg)
+    {
+        using stored_type = std::conditional_t<std::is_same_v<T, std::string_view>, std::string, T>;
+
+        std::vector<stored_type> values;
+        for (value * item = arg.in_first(); item; item = arg.in_next())
+        {
+            auto bound = make_constraint_bound<T>(SQLITE_INDEX_CONSTRAINT_EQ, *item);
+            if (bound.match == constraint_match::all)
+                return true;
+            if (bound.match == constraint_match::compare)
+                values.emplace_back(bound.value);
+        }
+        if (values.empty())
+            return false;
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+
+        add_selector(data, [values = std::move(values)](const T & x) {
+            return std::binary_search(values.begin(), values.end(), x);
+        });
+        return true;
+    }
+
+#endif
+
+    template<class T, class Pred>
+    void column_table::cursor::add_selector(const T * data, Pred pred)
+    {
+        _selectors.emplace_back([data, pred = std::move(pred)](size_t base, size_t size, uint16_t * selection,
+                                                               size_t count, bool initial) noexcept {
+            return select(data + base, size, selection, count, initial, pred);
+        });
+    }
+
+    template<class T, class Pred>
+    size_t column_table::cursor::select(const T * block, size_t size, uint16_t * selection, size_t count, bool initial,
+                                        const Pred & pred) noexcept
+    {
+        if (initial)
+        {
+            /*
+             First constraint: the match mask for the chunk is computed in a separate loop that
+             compilers vectorize for numeric columns and is then compacted into the selection vector
+             without branches.
+            */
+            unsigned char mask[chunk_size];
+            for (size_t i = 0; i < size; ++i)
+                mask[i] = pred(block[i]);
+            count = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                selection[count] = uint16_t(i);
+                count += mask[i];
+            }
+            return count;
+        }
+
+        //Subsequent constraints: filter the existing selection in place
+        size_t ret = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint16_t current = selection[i];
+            selection[ret] = current;
+            ret += pred(block[current]);
+        }
+        return ret;
+    }
+}
+
+#endif
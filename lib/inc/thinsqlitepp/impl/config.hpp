@@ -32,6 +32,12 @@
 
 #endif
 
+#if __cpp_consteval >= 201811L && !defined(DOXYGEN)
+    #define SQLITEPP_CONSTEVAL consteval
+#else
+    #define SQLITEPP_CONSTEVAL constexpr
+#endif
+
 #ifdef __clang__
     #define SQLITEPP_SUPPRESS_SILLY_VARARG_WARNING_BEGIN _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wgnu-zero-variadic-macro-arguments\"")
     #define SQLITEPP_SUPPRESS_SILLY_VARARG_WARNING_END _Pragma("GCC diagnostic pop")
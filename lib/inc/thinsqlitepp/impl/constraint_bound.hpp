@@ -0,0 +1,144 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_CONSTRAINT_BOUND_INCLUDED
+#define HEADER_SQLITEPP_CONSTRAINT_BOUND_INCLUDED
+
+#include "value_iface.hpp"
+
+#include <cmath>
+#include <limits>
+#include <string_view>
+
+namespace thinsqlitepp
+{
+    /** @cond PRIVATE */
+
+    enum class constraint_match
+    {
+        all,
+        none,
+        compare
+    };
+
+    template<class T>
+    struct constraint_bound
+    {
+        constraint_match match;
+        int op;
+        T value;
+    };
+
+    /*
+     Converts a virtual table constraint argument to the C++ type of the column so that comparisons
+     can run directly on C++ data. The conversion is exact: if a value cannot be represented
+     the comparison is adjusted (e.g. `int_col > 2.5` becomes `int_col > 2`). Arguments whose
+     comparison semantics depend on an affinity we cannot see (text vs. number) match everything
+     so callers must leave such constraints for SQLite to re-check.
+    */
+
+    template<class T>
+    constraint_bound<T> make_constraint_bound(int op, const value & arg) noexcept;
+
+    template<>
+    inline constraint_bound<int64_t> make_constraint_bound<int64_t>(int op, const value & arg) noexcept
+    {
+        switch(arg.type())
+        {
+            case SQLITE_INTEGER:
+                return {constraint_match::compare, op, arg.get<int64_t>()};
+            case SQLITE_FLOAT:
+            {
+                constexpr double two_63 = 9223372036854775808.0;
+                const double val = arg.get<double>();
+                if (std::isnan(val))
+                    return {constraint_match::none, op, 0};
+                if (val >= two_63)
+                    return {(op == SQLITE_INDEX_CONSTRAINT_LT || op == SQLITE_INDEX_CONSTRAINT_LE) ?
+                                constraint_match::all : constraint_match::none, op, 0};
+                if (val < -two_63)
+                    return {(op == SQLITE_INDEX_CONSTRAINT_GT || op == SQLITE_INDEX_CONSTRAINT_GE) ?
+                                constraint_match::all : constraint_match::none, op, 0};
+                const auto lower = int64_t(std::floor(val));
+                const auto upper = int64_t(std::ceil(val));
+                switch(op)
+                {
+                    case SQLITE_INDEX_CONSTRAINT_EQ:
+                        if (lower != upper)
+                            return {constraint_match::none, op, 0};
+                        return {constraint_match::compare, op, lower};
+                    case SQLITE_INDEX_CONSTRAINT_GT: return {constraint_match::compare, op, lower};
+                    case SQLITE_INDEX_CONSTRAINT_GE: return {constraint_match::compare, op, upper};
+                    case SQLITE_INDEX_CONSTRAINT_LT: return {constraint_match::compare, op, upper};
+                    case SQLITE_INDEX_CONSTRAINT_LE: return {constraint_match::compare, op, lower};
+                }
+                return {constraint_match::all, op, 0};
+            }
+            case SQLITE_NULL:
+                return {constraint_match::none, op, 0};
+            default:
+                return {constraint_match::all, op, 0};
+        }
+    }
+
+    template<>
+    inline constraint_bound<double> make_constraint_bound<double>(int op, const value & arg) noexcept
+    {
+        switch(arg.type())
+        {
+            case SQLITE_FLOAT:
+                return {constraint_match::compare, op, arg.get<double>()};
+            case SQLITE_INTEGER:
+            {
+                constexpr double two_63 = 9223372036854775808.0;
+                const int64_t ival = arg.get<int64_t>();
+                const double val = double(ival);
+                const bool rounded_up = val >= two_63 || int64_t(val) > ival;
+                const bool rounded_down = !rounded_up && int64_t(val) < ival;
+                if (!rounded_up && !rounded_down)
+                    return {constraint_match::compare, op, val};
+
+                //ival lies strictly between two adjacent doubles
+                const double lower = rounded_up ? std::nextafter(val, -std::numeric_limits<double>::infinity()) : val;
+                const double upper = rounded_up ? val : std::nextafter(val, std::numeric_limits<double>::infinity());
+                switch(op)
+                {
+                    case SQLITE_INDEX_CONSTRAINT_GT:
+                    case SQLITE_INDEX_CONSTRAINT_GE:
+                        return {constraint_match::compare, SQLITE_INDEX_CONSTRAINT_GE, upper};
+                    case SQLITE_INDEX_CONSTRAINT_LT:
+                    case SQLITE_INDEX_CONSTRAINT_LE:
+                        return {constraint_match::compare, SQLITE_INDEX_CONSTRAINT_LE, lower};
+                }
+                return {constraint_match::none, op, 0};
+            }
+            case SQLITE_NULL:
+                return {constraint_match::none, op, 0};
+            default:
+                return {constraint_match::all, op, 0};
+        }
+    }
+
+    template<>
+    inline constraint_bound<std::string_view> make_constraint_bound<std::string_view>(int op, const value & arg) noexcept
+    {
+        switch(arg.type())
+        {
+            case SQLITE_TEXT:
+                return {constraint_match::compare, op, arg.get<std::string_view>()};
+            case SQLITE_NULL:
+                return {constraint_match::none, op, {}};
+            default:
+                return {constraint_match::all, op, {}};
+        }
+    }
+
+    /** @endcond */
+}
+
+#endif
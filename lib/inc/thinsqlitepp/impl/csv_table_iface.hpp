@@ -0,0 +1,159 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_CSV_TABLE_IFACE_INCLUDED
+#define HEADER_SQLITEPP_CSV_TABLE_IFACE_INCLUDED
+
+#include "vtab_iface.hpp"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace thinsqlitepp
+{
+    /** @cond PRIVATE */
+
+    //Read-only memory mapping of a whole file
+    class csv_file_mapping
+    {
+    public:
+        csv_file_mapping(const std::string & path);
+        ~csv_file_mapping() noexcept;
+
+        csv_file_mapping(const csv_file_mapping &) = delete;
+        csv_file_mapping & operator=(const csv_file_mapping &) = delete;
+
+        const char * data() const noexcept
+            { return _data; }
+        size_t size() const noexcept
+            { return _size; }
+    private:
+        const char * _data = nullptr;
+        size_t _size = 0;
+    #ifdef _WIN32
+        void * _file = nullptr;
+        void * _mapping = nullptr;
+    #endif
+    };
+
+    /** @endcond */
+
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * A read-only virtual table over a CSV, TSV or fixed-width text file
+     *
+     * This allows querying large delimited or fixed-width dumps directly, without importing them into
+     * a database first. Register the module and create tables pointing at files:
+     * ```
+     * csv_table::create_module(*db, "csv");
+     * db->exec("CREATE VIRTUAL TABLE temp.orders USING csv(filename='orders.csv', header=yes)");
+     * db->exec("SELECT count(*) FROM orders WHERE c2 = 'shipped'", ...);
+     * ```
+     * The following arguments are recognized:
+     * - `filename` (required) the path of the file
+     * - `header` whether the first line contains column names: `yes`/`no`, `true`/`false` or `1`/`0`.
+     *   Default is `no` in which case columns are named `c0`, `c1` etc.
+     * - `delimiter` field delimiter: a single character or `tab`. Default is `,`.
+     * - `columns` number of columns. By default it is the number of fields in the first line.
+     * - `widths` comma separated field widths for fixed-width files. Fields are trimmed of surrounding
+     *   spaces and the `delimiter` argument is ignored.
+     *
+     * All columns are `TEXT`. Delimited files follow RFC 4180: fields can be enclosed in double quotes,
+     * which can contain delimiters, newlines and doubled quotes. Missing fields are `NULL`.
+     * The rowid is the 1-based number of the record after the header.
+     *
+     * The file is memory mapped and must not change while the table exists. Records are located lazily
+     * with `memchr` as scans progress and their positions are remembered so subsequent scans and rowid
+     * lookups (`rowid = x`, ranges on rowid) go directly to the right place. Within a record fields are
+     * only split up to the highest column a statement reads and only the ones it reads are unescaped.
+     *
+     * `#include <thinsqlitepp/csv_table.hpp>`
+     */
+    class csv_table : public vtab<csv_table>
+    {
+    public:
+        csv_table(database * db, int argc, const char * const * argv);
+
+        bool best_index(index_info<> & info) const;
+
+        class cursor : public vtab::cursor
+        {
+        public:
+            using vtab::cursor::cursor;
+
+            void filter(int idx, int argc, value ** argv);
+
+            bool eof() const noexcept
+                { return _row >= _last; }
+
+            void next();
+
+            int64_t rowid() const
+                { return int64_t(_row) + 1; }
+
+            void column(context & ctxt, int idx) const;
+        private:
+            void load_row();
+        private:
+            size_t _row = 0;
+            size_t _last = 0;
+            size_t _record_end = 0;
+            //fields of the current record split so far as [start, end) offsets
+            mutable std::vector<std::pair<size_t, size_t>> _fields;
+            mutable size_t _parse_pos = 0;
+            mutable std::string _unescaped;
+        };
+
+        /// Number of columns
+        size_t columns() const noexcept
+            { return _column_count; }
+
+    private:
+        //rowid constraints passed to filter in this order
+        static constexpr int equal_flag = 1;
+        static constexpr int greater_flag = 2;
+        static constexpr int greater_equal_flag = 4;
+        static constexpr int less_flag = 8;
+        static constexpr int less_equal_flag = 16;
+
+        const char * data() const noexcept
+            { return _file->data(); }
+        size_t size() const noexcept
+            { return _file->size(); }
+
+        size_t find_record_end(size_t pos) const noexcept;
+        bool has_row(size_t row) const;
+        std::pair<size_t, size_t> row_bounds(size_t row) const noexcept;
+        std::pair<size_t, size_t> row_bounds_of(size_t start, size_t end) const noexcept;
+        size_t split_field(size_t pos, size_t end, std::pair<size_t, size_t> & field) const noexcept;
+        std::string_view field_value(std::pair<size_t, size_t> field, std::string & buffer) const;
+        std::optional<std::string_view> fixed_field_value(size_t start, size_t end, size_t idx) const noexcept;
+        size_t estimated_rows() const noexcept;
+    private:
+        std::unique_ptr<csv_file_mapping> _file;
+        char _delimiter = ',';
+        //for fixed-width files the offsets of all fields followed by the record width
+        std::vector<size_t> _offsets;
+        size_t _column_count = 0;
+        //start offsets of records found so far, followed by file size once all have been found
+        mutable std::vector<size_t> _records;
+        mutable bool _indexed = false;
+    };
+
+    /** @} */
+}
+
+#endif
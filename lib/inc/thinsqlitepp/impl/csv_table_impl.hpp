@@ -0,0 +1,618 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_CSV_TABLE_IMPL_INCLUDED
+#define HEADER_SQLITEPP_CSV_TABLE_IMPL_INCLUDED
+
+#include "csv_table_iface.hpp"
+#include "constraint_bound.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <string.h>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace thinsqlitepp
+{
+    //MARK: - csv_file_mapping
+
+    inline csv_file_mapping::csv_file_mapping(const std::string & path)
+    {
+        auto fail = [&]() {
+            throw exception(SQLITE_CANTOPEN, error::message_ptr(sqlite3_mprintf("cannot open %s", path.c_str()), sqlite3_free));
+        };
+
+    #ifdef _WIN32
+        std::wstring wpath(MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, wpath.data(), int(wpath.size()));
+        HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            fail();
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            fail();
+        }
+        _file = file;
+        _size = size_t(size.QuadPart);
+        if (_size == 0)
+            return;
+        _mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!_mapping || !(_data = (const char *)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0)))
+        {
+            if (_mapping)
+                CloseHandle(_mapping);
+            CloseHandle(file);
+            fail();
+        }
+    #else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            fail();
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            fail();
+        }
+        _size = size_t(st.st_size);
+        if (_size != 0)
+        {
+            void * data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                close(fd);
+                fail();
+            }
+        #ifdef POSIX_MADV_SEQUENTIAL
+            posix_madvise(data, _size, POSIX_MADV_SEQUENTIAL);
+        #endif
+            _data = (const char *)data;
+        }
+        //the mapping stays valid after the descriptor is closed
+        close(fd);
+    #endif
+    }
+
+    inline csv_file_mapping::~csv_file_mapping() noexcept
+    {
+    #ifdef _WIN32
+        if (_data)
+            UnmapViewOfFile(_data);
+        if (_mapping)
+            CloseHandle(_mapping);
+        if (_file)
+            CloseHandle(_file);
+    #else
+        if (_data)
+            munmap(const_cast<char *>(_data), _size);
+    #endif
+    }
+
+    //MARK: - csv_table
+
+    /** @cond PRIVATE */
+
+    struct csv_table_argument
+    {
+        std::string_view name;
+        std::string_view value;
+
+        csv_table_argument(const char * arg)
+        {
+            std::string_view str(arg);
+            auto eq = str.find('=');
+            name = trim(str.substr(0, eq));
+            value = eq == str.npos ? std::string_view() : trim(str.substr(eq + 1));
+            if (value.size() >= 2 && (value.front() == '\'' || value.front() == '"') && value.back() == value.front())
+                value = value.substr(1, value.size() - 2);
+        }
+
+        static std::string_view trim(std::string_view str) noexcept
+        {
+            while (!str.empty() && isspace((unsigned char)str.front()))
+                str.remove_prefix(1);
+            while (!str.empty() && isspace((unsigned char)str.back()))
+                str.remove_suffix(1);
+            return str;
+        }
+
+        [[noreturn]] void invalid() const
+        {
+            throw exception(SQLITE_ERROR, error::message_ptr(sqlite3_mprintf("invalid csv argument: %.*s",
+                                                                             int(name.size()), name.data()), sqlite3_free));
+        }
+
+        bool as_bool() const
+        {
+            for (const char * yes: {"yes", "true", "on", "1"})
+                if (value.size() == strlen(yes) && sqlite3_strnicmp(value.data(), yes, int(value.size())) == 0)
+                    return true;
+            for (const char * no: {"no", "false", "off", "0"})
+                if (value.size() == strlen(no) && sqlite3_strnicmp(value.data(), no, int(value.size())) == 0)
+                    return false;
+            invalid();
+        }
+
+        static bool parse_size(std::string_view str, size_t & res) noexcept
+        {
+            if (str.empty())
+                return false;
+            res = 0;
+            for (char c: str)
+            {
+                if (c < '0' || c > '9' || res > (std::numeric_limits<size_t>::max() - 9) / 10)
+                    return false;
+                res = res * 10 + size_t(c - '0');
+            }
+            return true;
+        }
+    };
+
+    /** @endcond */
+
+    inline csv_table::csv_table(database * db, int argc, const char * const * argv)
+    {
+        std::string filename;
+        bool header = false;
+        size_t column_count = 0;
+        for (int i = 3; i < argc; ++i)
+        {
+            csv_table_argument arg(argv[i]);
+            if (arg.name == "filename")
+            {
+                filename = arg.value;
+            }
+            else if (arg.name == "header")
+            {
+                header = arg.as_bool();
+            }
+            else if (arg.name == "delimiter")
+            {
+                if (arg.value == "tab" || arg.value == "\\t")
+                    _delimiter = '\t';
+                else if (arg.value.size() == 1 && arg.value[0] != '"' && arg.value[0] != '\n' && arg.value[0] != '\r')
+                    _delimiter = arg.value[0];
+                else
+                    arg.invalid();
+            }
+            else if (arg.name == "columns")
+            {
+                if (!csv_table_argument::parse_size(arg.value, column_count) || column_count == 0)
+                    arg.invalid();
+            }
+            else if (arg.name == "widths")
+            {
+                _offsets.assign(1, 0);
+                for (std::string_view rest = arg.value; ; )
+                {
+                    auto comma = rest.find(',');
+                    size_t width;
+                    if (!csv_table_argument::parse_size(csv_table_argument::trim(rest.substr(0, comma)), width) || width == 0)
+                        arg.invalid();
+                    _offsets.push_back(_offsets.back() + width);
+                    if (comma == rest.npos)
+                        break;
+                    rest.remove_prefix(comma + 1);
+                }
+            }
+            else
+            {
+                arg.invalid();
+            }
+        }
+        if (filename.empty())
+            throw exception(SQLITE_ERROR, error::message_ptr("csv: filename argument is required"));
+
+        _file = std::make_unique<csv_file_mapping>(filename);
+
+        //split the first record to find column names and count
+        std::vector<std::string> first_fields;
+        size_t data_start = 0;
+        if (size() != 0)
+        {
+            const size_t first_end = find_record_end(0);
+            auto [start, end] = row_bounds_of(0, first_end);
+            if (_offsets.empty())
+            {
+                std::string buffer;
+                for (size_t pos = start; pos <= end; )
+                {
+                    std::pair<size_t, size_t> field;
+                    pos = split_field(pos, end, field);
+                    first_fields.emplace_back(field_value(field, buffer));
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i + 1 < _offsets.size(); ++i)
+                    first_fields.emplace_back(fixed_field_value(start, end, i).value_or(std::string_view()));
+            }
+            if (header)
+                data_start = std::min(first_end + 1, size());
+        }
+
+        _column_count = !_offsets.empty() ? _offsets.size() - 1 :
+                        column_count != 0 ? column_count :
+                        std::max(first_fields.size(), size_t(1));
+
+        std::string declaration = "CREATE TABLE x(";
+        for (size_t i = 0; i < _column_count; ++i)
+        {
+            if (i != 0)
+                declaration += ", ";
+            declaration += '"';
+            if (header && i < first_fields.size() && !first_fields[i].empty())
+            {
+                for (char c: first_fields[i])
+                {
+                    if (c == '"')
+                        declaration += '"';
+                    declaration += c;
+                }
+            }
+            else
+            {
+                declaration += 'c' + std::to_string(i);
+            }
+            declaration += "\" TEXT";
+        }
+        declaration += ')';
+        db->declare_vtab(declaration);
+
+        _records.push_back(data_start);
+        _indexed = (data_start == size());
+    }
+
+    inline size_t csv_table::find_record_end(size_t pos) const noexcept
+    {
+        const char * const begin = data();
+        const char * const end = begin + size();
+        const char * current = begin + pos;
+        bool quoted = false;
+        for ( ; ; )
+        {
+            auto newline = (const char *)memchr(current, '\n', size_t(end - current));
+            if (!newline)
+                newline = end;
+            if (!_offsets.empty())
+                return size_t(newline - begin);
+            //a newline inside quotes is part of a field so count quotes to see if we are in one
+            for (auto quote = current; (quote = (const char *)memchr(quote, '"', size_t(newline - quote))) != nullptr; ++quote)
+                quoted = !quoted;
+            if (!quoted || newline == end)
+                return size_t(newline - begin);
+            current = newline + 1;
+        }
+    }
+
+    inline bool csv_table::has_row(size_t row) const
+    {
+        while (!_indexed && _records.size() <= row + 1)
+        {
+            const size_t next = std::min(find_record_end(_records.back()) + 1, size());
+            _records.push_back(next);
+            _indexed = (next == size());
+        }
+        return row + 1 < _records.size();
+    }
+
+    inline std::pair<size_t, size_t> csv_table::row_bounds(size_t row) const noexcept
+    {
+        //has_row() has been called so the next record start (or the end of file) is known
+        return row_bounds_of(_records[row], _records[row + 1]);
+    }
+
+    inline std::pair<size_t, size_t> csv_table::row_bounds_of(size_t start, size_t end) const noexcept
+    {
+        if (end > start && data()[end - 1] == '\n')
+            --end;
+        if (end > start && data()[end - 1] == '\r')
+            --end;
+        return {start, end};
+    }
+
+    inline size_t csv_table::split_field(size_t pos, size_t end, std::pair<size_t, size_t> & field) const noexcept
+    {
+        const char * const begin = data();
+        size_t value_end = pos;
+        if (pos < end && begin[pos] == '"')
+        {
+            //skip to the closing quote, passing over doubled ones
+            value_end = pos + 1;
+            for ( ; ; )
+            {
+                auto quote = (const char *)memchr(begin + value_end, '"', end - value_end);
+                if (!quote)
+                {
+                    value_end = end;
+                    break;
+                }
+                value_end = size_t(quote - begin) + 1;
+                if (value_end < end && begin[value_end] == '"')
+                    ++value_end;
+                else
+                    break;
+            }
+        }
+        auto delimiter = (const char *)memchr(begin + value_end, _delimiter, end - value_end);
+        if (!delimiter)
+        {
+            field = {pos, end};
+            return end + 1;
+        }
+        field = {pos, size_t(delimiter - begin)};
+        return field.second + 1;
+    }
+
+    inline std::string_view csv_table::field_value(std::pair<size_t, size_t> field, std::string & buffer) const
+    {
+        const char * const begin = data();
+        std::string_view raw(begin + field.first, field.second - field.first);
+        if (raw.empty() || raw.front() != '"')
+            return raw;
+
+        raw.remove_prefix(1);
+        auto quote = raw.find('"');
+        if (quote == raw.npos)
+            return raw;
+        if (quote + 1 >= raw.size() || raw[quote + 1] != '"')
+            return raw.substr(0, quote);
+
+        //there are doubled quotes inside
+        buffer.clear();
+        for (size_t i = 0; i < raw.size(); ++i)
+        {
+            if (raw[i] == '"')
+            {
+                if (i + 1 < raw.size() && raw[i + 1] == '"')
+                    ++i;
+                else
+                    break;
+            }
+            buffer += raw[i];
+        }
+        return buffer;
+    }
+
+    inline std::optional<std::string_view> csv_table::fixed_field_value(size_t start, size_t end, size_t idx) const noexcept
+    {
+        const size_t width = end - start;
+        if (_offsets[idx] >= width)
+            return std::nullopt;
+        const size_t last = std::min(_offsets[idx + 1], width);
+        return csv_table_argument::trim(std::string_view(data() + start + _offsets[idx], last - _offsets[idx]));
+    }
+
+    inline size_t csv_table::estimated_rows() const noexcept
+    {
+        if (_indexed)
+            return _records.size() - 1;
+        //extrapolate from the records found so far
+        const size_t known = _records.size() - 1;
+        if (known == 0)
+            return std::max(size() / 64, size_t(1));
+        const size_t scanned = std::max(_records.back() - _records.front(), size_t(1));
+        return size_t(double(known) * double(size() - _records.front()) / double(scanned)) + 1;
+    }
+
+    inline bool csv_table::best_index(index_info<> & info) const
+    {
+        const auto constraints = info.constraints();
+        auto usages = info.constraints_usage();
+
+        int equal = -1, lower = -1, upper = -1;
+        int flags = 0;
+        for (size_t i = 0; i < constraints.size(); ++i)
+        {
+            auto & constraint = constraints[i];
+            if (!constraint.usable || constraint.iColumn >= 0)
+                continue;
+            switch(constraint.op)
+            {
+                case SQLITE_INDEX_CONSTRAINT_EQ:
+                    if (equal < 0) { equal = int(i); flags |= equal_flag; }
+                    break;
+                case SQLITE_INDEX_CONSTRAINT_GT:
+                case SQLITE_INDEX_CONSTRAINT_GE:
+                    if (lower < 0)
+                    {
+                        lower = int(i);
+                        flags |= (constraint.op == SQLITE_INDEX_CONSTRAINT_GT ? greater_flag : greater_equal_flag);
+                    }
+                    break;
+                case SQLITE_INDEX_CONSTRAINT_LT:
+                case SQLITE_INDEX_CONSTRAINT_LE:
+                    if (upper < 0)
+                    {
+                        upper = int(i);
+                        flags |= (constraint.op == SQLITE_INDEX_CONSTRAINT_LT ? less_flag : less_equal_flag);
+                    }
+                    break;
+            }
+        }
+        //SQLite still checks the constraints since arguments may need conversion
+        int argv_index = 0;
+        for (int idx: {equal, lower, upper})
+        {
+            if (idx >= 0)
+                usages[idx].argvIndex = ++argv_index;
+        }
+
+        const double rows = double(estimated_rows());
+        double estimated = rows;
+        if (equal >= 0)
+            estimated = 1;
+        else if (lower >= 0 && upper >= 0)
+            estimated = std::ceil(rows / 16);
+        else if (lower >= 0 || upper >= 0)
+            estimated = std::ceil(rows / 4);
+
+        //splitting fields is the main cost so account for how far into each record we need to go
+        double parse_cost = 1;
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 10, 0)
+        const uint64_t used = info.columns_used();
+        size_t last_used = 0;
+        for (size_t i = 0; i < std::min(_column_count, size_t(63)); ++i)
+        {
+            if (used & (uint64_t(1) << i))
+                last_used = i + 1;
+        }
+        if (used & (uint64_t(1) << 63))
+            last_used = _column_count;
+        parse_cost += double(last_used);
+    #else
+        parse_cost += double(_column_count);
+    #endif
+        info.set_estimated_cost(estimated * parse_cost);
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 8, 2)
+        info.set_estimated_rows(int64_t(estimated));
+    #endif
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 9, 0)
+        if (equal >= 0)
+            info.set_index_flags(info.index_flags() | SQLITE_INDEX_SCAN_UNIQUE);
+    #endif
+
+        //records are produced in rowid order
+        auto orderbys = info.orderbys();
+        if (orderbys.size() == 1 && orderbys[0].iColumn < 0 && !orderbys[0].desc)
+            info.set_order_by_consumed(true);
+
+        info.set_index_number(flags);
+        return true;
+    }
+
+    //MARK: - csv_table::cursor
+
+    inline void csv_table::cursor::filter(int idx, [[maybe_unused]] int argc, value ** argv)
+    {
+        //rows are 0-based while rowids are 1-based
+        size_t first = 0;
+        size_t last = std::numeric_limits<size_t>::max();
+        auto restrict = [&](int op, const value & arg) {
+            auto bound = make_constraint_bound<int64_t>(op, arg);
+            if (bound.match == constraint_match::all)
+                return;
+            if (bound.match == constraint_match::none)
+            {
+                last = 0;
+                return;
+            }
+            const int64_t val = bound.value;
+            switch(bound.op)
+            {
+                case SQLITE_INDEX_CONSTRAINT_EQ:
+                    if (val < 1)
+                        last = 0;
+                    else
+                        first = std::max(first, size_t(val - 1)), last = std::min(last, size_t(val));
+                    break;
+                case SQLITE_INDEX_CONSTRAINT_GT:
+                    if (val >= 1)
+                        first = std::max(first, size_t(val));
+                    break;
+                case SQLITE_INDEX_CONSTRAINT_GE:
+                    if (val >= 2)
+                        first = std::max(first, size_t(val - 1));
+                    break;
+                case SQLITE_INDEX_CONSTRAINT_LT:
+                    last = val < 1 ? 0 : std::min(last, size_t(val - 1));
+                    break;
+                case SQLITE_INDEX_CONSTRAINT_LE:
+                    last = val < 0 ? 0 : std::min(last, size_t(val));
+                    break;
+            }
+        };
+
+        int arg = 0;
+        if (idx & equal_flag)
+            restrict(SQLITE_INDEX_CONSTRAINT_EQ, *argv[arg++]);
+        if (idx & greater_flag)
+            restrict(SQLITE_INDEX_CONSTRAINT_GT, *argv[arg++]);
+        if (idx & greater_equal_flag)
+            restrict(SQLITE_INDEX_CONSTRAINT_GE, *argv[arg++]);
+        if (idx & less_flag)
+            restrict(SQLITE_INDEX_CONSTRAINT_LT, *argv[arg++]);
+        if (idx & less_equal_flag)
+            restrict(SQLITE_INDEX_CONSTRAINT_LE, *argv[arg++]);
+        assert(arg == argc);
+
+        _row = first;
+        _last = last;
+        load_row();
+    }
+
+    inline void csv_table::cursor::next()
+    {
+        ++_row;
+        load_row();
+    }
+
+    inline void csv_table::cursor::load_row()
+    {
+        if (_row >= _last)
+            return;
+        const csv_table * me = owner();
+        if (!me->has_row(_row))
+        {
+            _last = _row;
+            return;
+        }
+        auto [start, end] = me->row_bounds(_row);
+        _parse_pos = start;
+        _record_end = end;
+        _fields.clear();
+    }
+
+    inline void csv_table::cursor::column(context & ctxt, int idx) const
+    {
+        const csv_table * me = owner();
+        if (!me->_offsets.empty())
+        {
+            if (auto val = me->fixed_field_value(_parse_pos, _record_end, size_t(idx)))
+                ctxt.result_reference(*val);
+            else
+                ctxt.result(nullptr);
+            return;
+        }
+
+        while (_fields.size() <= size_t(idx) && _parse_pos <= _record_end)
+        {
+            std::pair<size_t, size_t> field;
+            _parse_pos = me->split_field(_parse_pos, _record_end, field);
+            _fields.push_back(field);
+        }
+        if (_fields.size() <= size_t(idx))
+        {
+            ctxt.result(nullptr);
+            return;
+        }
+        auto val = me->field_value(_fields[size_t(idx)], _unescaped);
+        if (val.data() == _unescaped.data())
+            ctxt.result(val);
+        else
+            ctxt.result_reference(val);
+    }
+}
+
+#endif
@@ -18,6 +18,7 @@
 #include "string_param.hpp"
 #include "span.hpp"
 #include "meta.hpp"
+#include "typed_function_iface.hpp"
 
 #include <memory>
 #include <functional>
@@ -295,6 +296,62 @@ namespace thinsqlitepp
         SQLITEPP_ENABLE_IF((database_detector::is_pointer_to_callback<bool, T, int>),
         void) busy_handler(T handler_ptr);
         
+
+        //MARK: - unlock_notify
+
+    #if defined(SQLITE_ENABLE_UNLOCK_NOTIFY)
+        /**
+         * Register an unlock notification callback
+         * 
+         * Equivalent to ::sqlite3_unlock_notify
+         * 
+         * Available only if #SQLITE_ENABLE_UNLOCK_NOTIFY is defined during compilation
+         * 
+         * @param handler A callback function. SQLite may batch notifications registered with the same 
+         * function and pass all their arguments in a single call. Can be nullptr to cancel a pending 
+         * notification.
+         * @param arg Argument to pass to the callback.
+         * @throws exception with #SQLITE_LOCKED if waiting would result in a deadlock. In this case
+         * the callback is not registered.
+         */
+        void unlock_notify(void (*handler)(void ** args, int count) noexcept, void * arg);
+
+        /**
+         * Register an unlock notification callback
+         * 
+         * Equivalent to ::sqlite3_unlock_notify
+         * 
+         * Available only if #SQLITE_ENABLE_UNLOCK_NOTIFY is defined during compilation
+         * 
+         * @param handler_ptr A **pointer** to any C++ callable that can be invoked as
+         * ```
+         * (*handler_ptr)();
+         * ```
+         * This invocation must be `noexcept`. It may happen on a different thread, from within the call
+         * that concludes the blocking transaction, or immediately from this call if the blocking
+         * transaction has already concluded.
+         * This parameter can also be nullptr to cancel a pending notification.
+         * The handler object must exist until it is invoked or cancelled.
+         * @throws exception with #SQLITE_LOCKED if waiting would result in a deadlock
+         */
+        template<class T>
+        SQLITEPP_ENABLE_IF((database_detector::is_pointer_to_callback<void, T>),
+        void) unlock_notify(T handler_ptr);
+
+        /**
+         * Block until the transaction that locks this connection in shared-cache mode concludes
+         * 
+         * Call this after an operation on this connection failed with #SQLITE_LOCKED_SHAREDCACHE. 
+         * The calling thread sleeps on a condition variable until notified via unlock_notify().
+         * 
+         * Available only if #SQLITE_ENABLE_UNLOCK_NOTIFY is defined during compilation
+         * 
+         * @throws exception with #SQLITE_LOCKED if waiting would result in a deadlock. The current 
+         * transaction on this connection should be rolled back in this case.
+         */
+        void wait_for_unlock();
+    #endif
+        
         
         //MARK: - collation_needed
 
@@ -435,6 +492,52 @@ namespace thinsqlitepp
         SQLITEPP_ENABLE_IF((database_detector::is_pointer_to_callback<void, T, int, const char *, const char *, int64_t>),
         void) update_hook(T handler_ptr) noexcept;
 
+        //MARK: - authorizer
+
+        /**
+         * Register a callback to authorize actions of statements being compiled
+         * 
+         * Equivalent to ::sqlite3_set_authorizer
+         * 
+         * Setting the authorizer expires all prepared statements of the connection.
+         * create_with_dependencies() and @ref query_cache set and remove the authorizer
+         * themselves: do not use them while you have an authorizer set.
+         * 
+         * @param handler A callback function that matches the type of @p data_ptr argument. Can be
+         *  nullptr.
+         * @param data_ptr A pointer to callback data or nullptr.
+         */
+        template<class T>
+        SQLITEPP_ENABLE_IF(std::is_pointer_v<T> || std::is_null_pointer_v<T>,
+        void) authorizer(int (* handler)(type_identity_t<T> data_ptr, int action, const char * arg1, const char * arg2,
+                                         const char * db_name, const char * trigger_or_view) noexcept,
+                         T data_ptr)
+            { check_error(sqlite3_set_authorizer(this->c_ptr(), (int(*)(void*,int,const char*,const char*,const char*,const char*))(handler), data_ptr)); }
+
+        /**
+         * Register a callback to authorize actions of statements being compiled
+         * 
+         * Equivalent to ::sqlite3_set_authorizer
+         * 
+         * Setting the authorizer expires all prepared statements of the connection.
+         * create_with_dependencies() and @ref query_cache set and remove the authorizer
+         * themselves: do not use them while you have an authorizer set.
+         * 
+         * @param handler_ptr A **pointer** to any C++ callable that can be invoked as
+         * ```
+         * int result = (*handler_ptr)(int action, const char * arg1, const char * arg2, 
+         *                             const char * db_name, const char * trigger_or_view);
+         * ```
+         * The result must be #SQLITE_OK, #SQLITE_DENY or #SQLITE_IGNORE. The meaning of 
+         * `arg1` and `arg2` depends on the [action code](https://www.sqlite.org/c3ref/c_alter_table.html).
+         * This invocation must be `noexcept`. 
+         * This parameter can also be nullptr to reset the handler.
+         * The handler object must exist as long as it is set.
+         */
+        template<class T>
+        SQLITEPP_ENABLE_IF((database_detector::is_pointer_to_callback<int, T, int, const char *, const char *, const char *, const char *>),
+        void) authorizer(T handler_ptr);
+
         //MARK: - preupdate_hook
 
     #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 16, 0) && defined(SQLITE_ENABLE_PREUPDATE_HOOK)
@@ -761,6 +864,82 @@ namespace thinsqlitepp
         SQLITEPP_ENABLE_IF(database_detector::is_pointer_to_function<T>,
         void) create_function(const char * name, int arg_count, int flags, 
                               T impl_ptr, void (*destructor)(type_identity_t<T> obj) noexcept = nullptr);
+
+        /**
+         * Create or redefine a scalar SQL function from a typed C++ callable
+         * 
+         * Wraps ::sqlite3_create_function_v2
+         * 
+         * The number of SQL arguments and the conversion of each one are derived at compile time from
+         * the signature of the callable so the generated code is the same as a hand-written 
+         * `(context *, int, value **)` callback. For example
+         * ```
+         * db->create_function("scale", [](int64_t a, std::string_view b) noexcept -> double {
+         *      return a * double(b.size());
+         * }, SQLITE_UTF8 | SQLITE_DETERMINISTIC);
+         * ```
+         * 
+         * The callable may optionally take a `context *` as its first parameter. The remaining parameters
+         * can be of the following types
+         * - any type supported by value::get() (`int`, `int64_t`, `double`, `std::string_view`, 
+         *   `std::u8string_view`, blob_view). The conversion follows SQLite rules: a NULL argument 
+         *   becomes 0 or an empty view.
+         * - `std::optional` of any of the above. A NULL argument becomes `std::nullopt`.
+         * - `value *` or `value &` (possibly const) to access the raw argument
+         * 
+         * The return type can be `void` (the result is NULL unless set via the `context *` argument), 
+         * `std::nullptr_t`, any arithmetic type, `std::string_view`, `std::string`, `std::u8string_view`, 
+         * `std::u8string`, blob_view, zero_blob, owned_value or `std::optional` of any of these. Strings and 
+         * blobs are copied.
+         * 
+         * If the callable is not `noexcept`, exceptions escaping it are converted into an SQL error: 
+         * thinsqlitepp::exception preserves its error code, `std::bad_alloc` becomes an out of memory 
+         * error and any other `std::exception` reports its `what()` message.
+         * 
+         * @param name Name of the SQL function to be created or redefined
+         * @param func Either a callable object with a single non-template call operator 
+         * (e.g. a non-generic lambda) or a function pointer, in which case it is copied and the copy is 
+         * destroyed when the function is removed; or a **pointer** to such callable object which is used by 
+         * reference and must outlive the registration.
+         * @param flags Combination of
+         * - [Text encoding flags](https://www.sqlite.org/c3ref/c_any.html) that specify
+         * what encoding this SQL function prefers for its parameters
+         * - [Function flags](https://www.sqlite.org/c3ref/c_deterministic.html) such as #SQLITE_DETERMINISTIC
+         */
+        template<class F>
+        SQLITEPP_ENABLE_IF(is_typed_function<F>,
+        void) create_function(const char * name, F func, int flags = SQLITE_UTF8);
+
+        /**
+         * Create or redefine an aggregate SQL function from a C++ state type
+         * 
+         * Wraps ::sqlite3_create_function_v2
+         * 
+         * An object of type @p State is default constructed in place (in memory obtained from 
+         * context::aggregate_context()) the first time a group gets a row and destroyed after the group's 
+         * result has been produced. Unlike raw aggregate context memory the state may thus be any C++ type 
+         * with a default constructor, such as one holding containers or strings. @p State must provide
+         * ```
+         * //called for each row. Arguments follow the rules of typed create_function
+         * void step(args...);
+         * //produces the result. Called on a default constructed object for empty groups
+         * R result();
+         * ```
+         * The number of SQL arguments and their conversions are derived from the signature of `step` 
+         * and `R` can be any result type supported by 
+         * @ref create_function(const char *, F, int) "typed create_function". 
+         * Exceptions escaping these methods are converted into SQL errors.
+         * 
+         * @tparam State Type of the aggregate state
+         * @param name Name of the SQL function to be created or redefined
+         * @param flags Combination of
+         * - [Text encoding flags](https://www.sqlite.org/c3ref/c_any.html) that specify
+         * what encoding this SQL function prefers for its parameters
+         * - [Function flags](https://www.sqlite.org/c3ref/c_deterministic.html)
+         */
+        template<class State>
+        SQLITEPP_ENABLE_IF(is_typed_aggregate<State>,
+        void) create_aggregate_function(const char * name, int flags = SQLITE_UTF8);
         
         //MARK: - create_window_function
 
@@ -827,6 +1006,34 @@ namespace thinsqlitepp
         SQLITEPP_ENABLE_IF(database_detector::is_pointer_to_window_function<T>,
         void) create_window_function(const char * name, int arg_count, int flags, 
                                      T impl_ptr, void (*destructor)(type_identity_t<T> obj) noexcept = nullptr);
+
+        /**
+         * Create or redefine SQL [aggregate window function](https://www.sqlite.org/windowfunctions.html#aggwinfunc)
+         * from a C++ state type
+         * 
+         * Wraps ::sqlite3_create_window_function
+         * 
+         * This works like @ref create_aggregate_function() but, in addition, @p State must provide
+         * ```
+         * //called when the oldest row leaves the window frame with the same arguments step() got for it
+         * void inverse(args...);
+         * ```
+         * and `result()` may be called multiple times. Rows always leave the frame in the order they entered it
+         * so a state that keeps a ring buffer or a monotonic deque can answer in amortized O(1) per row.
+         * See sliding_sum, sliding_min and sliding_max for ready-made states.
+         * 
+         * @tparam State Type of the aggregate state
+         * @param name Name of the SQL function to be created or redefined
+         * @param flags Combination of
+         * - [Text encoding flags](https://www.sqlite.org/c3ref/c_any.html) that specify
+         * what encoding this SQL function prefers for its parameters
+         * - [Function flags](https://www.sqlite.org/c3ref/c_deterministic.html)
+         * 
+         * @since SQLite 3.25
+         */
+        template<class State>
+        SQLITEPP_ENABLE_IF(is_typed_window<State>,
+        void) create_window_function(const char * name, int flags = SQLITE_UTF8);
 #endif
 
         ///@}
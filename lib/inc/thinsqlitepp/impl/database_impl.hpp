@@ -13,6 +13,10 @@
 #include "context_iface.hpp"
 #include "statement_iface.hpp"
 #include "row_iterator.hpp"
+#include "typed_function_impl.hpp"
+
+#include <condition_variable>
+#include <mutex>
 
 #ifdef __GNUC__
     #pragma GCC diagnostic push
@@ -94,6 +98,60 @@ namespace thinsqlitepp
         }
     }
 
+#if defined(SQLITE_ENABLE_UNLOCK_NOTIFY)
+    inline void database::unlock_notify(void (*handler)(void ** args, int count) noexcept, void * arg)
+    {
+        if (sqlite3_unlock_notify(c_ptr(), (void (*)(void **, int))handler, arg) != SQLITE_OK)
+            throw exception(SQLITE_LOCKED, error::message_ptr("waiting for unlock would deadlock"));
+    }
+
+    template<class T>
+    SQLITEPP_ENABLE_IF((database_detector::is_pointer_to_callback<void, T>),
+    void) database::unlock_notify(T handler_ptr)
+    {
+        if constexpr (!std::is_null_pointer_v<T>)
+        {
+            if (handler_ptr)
+            {
+                //SQLite batches all ready notifications with the same callback into one call
+                this->unlock_notify([] (void ** args, int count) noexcept {
+                    for (int i = 0; i < count; ++i)
+                        (*static_cast<T>(args[i]))();
+                }, const_cast<std::remove_const_t<std::remove_pointer_t<T>> *>(handler_ptr));
+            }
+            else
+            {
+                this->unlock_notify(nullptr, nullptr);
+            }
+        }
+        else
+        {
+            this->unlock_notify(nullptr, nullptr);
+        }
+    }
+
+    inline void database::wait_for_unlock()
+    {
+        struct waiter
+        {
+            std::mutex mutex;
+            std::condition_variable notified;
+            bool fired = false;
+
+            void operator()() noexcept
+            {
+                std::lock_guard lock(mutex);
+                fired = true;
+                notified.notify_one();
+            }
+        } w;
+
+        this->unlock_notify(&w);
+        std::unique_lock lock(w.mutex);
+        w.notified.wait(lock, [&]() { return w.fired; });
+    }
+#endif
+
     template<class T>
     SQLITEPP_ENABLE_IF((database_detector::is_pointer_to_callback<void, T, database *, int, const char *>),
     void) database::collation_needed(T handler_ptr)
@@ -167,6 +225,26 @@ namespace thinsqlitepp
         }
     }
 
+    template<class T>
+    SQLITEPP_ENABLE_IF((database_detector::is_pointer_to_callback<int, T, int, const char *, const char *, const char *, const char *>),
+    void) database::authorizer(T handler_ptr)
+    {
+        if constexpr (!std::is_null_pointer_v<T>)
+        {
+            if (handler_ptr)
+                this->authorizer([] (T data, int action, const char * arg1, const char * arg2,
+                                     const char * db_name, const char * trigger_or_view) noexcept -> int {
+                    return (*data)(action, arg1, arg2, db_name, trigger_or_view);
+                }, handler_ptr);
+            else
+                this->authorizer(nullptr, nullptr);
+        }
+        else
+        {
+            this->authorizer(nullptr, nullptr);
+        }
+    }
+
 #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 16, 0) && defined(SQLITE_ENABLE_PREUPDATE_HOOK)
     template<class T>
     SQLITEPP_ENABLE_IF((database_detector::is_pointer_to_callback<void, T, database *, int, const char *, const char *, int64_t, int64_t>),
@@ -317,6 +395,41 @@ namespace thinsqlitepp
         this->create_function(name, arg_count, flags, impl, func, step, last, destroy);
     }
 
+    template<class F>
+    SQLITEPP_ENABLE_IF(is_typed_function<F>,
+    void) database::create_function(const char * name, F func, int flags)
+    {
+        using handler_t = typed_function<F>;
+        using target_t = typename handler_t::target;
+        
+        if constexpr (!std::is_same_v<target_t, F>)
+        {
+            if (!func)
+            {
+                this->create_function(name, handler_t::arg_count, flags, nullptr);
+                return;
+            }
+            this->create_function(name, handler_t::arg_count, flags, const_cast<std::remove_const_t<target_t> *>(func),
+                                  &handler_t::call, nullptr, nullptr, nullptr);
+        }
+        else
+        {
+            //on failure SQLite calls the destructor itself
+            this->create_function(name, handler_t::arg_count, flags, new F(std::move(func)),
+                                  &handler_t::call, nullptr, nullptr, 
+                                  [](F * impl) noexcept { delete impl; });
+        }
+    }
+
+    template<class State>
+    SQLITEPP_ENABLE_IF(is_typed_aggregate<State>,
+    void) database::create_aggregate_function(const char * name, int flags)
+    {
+        using handler_t = typed_aggregate<State>;
+        this->create_function(name, handler_t::arg_count, flags, nullptr,
+                              nullptr, &handler_t::step, &handler_t::last, nullptr);
+    }
+
 #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 25, 0)
     template<class T>
     SQLITEPP_ENABLE_IF(std::is_pointer_v<T> || std::is_null_pointer_v<T>,
@@ -373,6 +486,16 @@ namespace thinsqlitepp
         }
         this->create_window_function(name, arg_count, flags, impl, step, last, current, inverse, destroy);
     }
+
+    template<class State>
+    SQLITEPP_ENABLE_IF(is_typed_window<State>,
+    void) database::create_window_function(const char * name, int flags)
+    {
+        using handler_t = typed_aggregate<State>;
+        this->create_window_function(name, handler_t::arg_count, flags, nullptr,
+                                     &handler_t::step, &handler_t::last, &handler_t::current, &handler_t::inverse, 
+                                     nullptr);
+    }
 #endif
 
     inline std::optional<bool> database::readonly(const string_param & db_name) const noexcept
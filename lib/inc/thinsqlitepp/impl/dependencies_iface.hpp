@@ -0,0 +1,163 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_DEPENDENCIES_IFACE_INCLUDED
+#define HEADER_SQLITEPP_DEPENDENCIES_IFACE_INCLUDED
+
+#include "database_iface.hpp"
+#include "statement_iface.hpp"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace thinsqlitepp
+{
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Access of a statement to a table
+     *
+     * `#include <thinsqlitepp/dependencies.hpp>`
+     */
+    struct table_access
+    {
+        /// Name of the database (`main`, `temp` or attached name). Empty if SQLite does not report it.
+        std::string schema;
+        /// Name of the table
+        std::string table;
+        /// Columns read or updated. Can be empty if the table is accessed as a whole.
+        std::vector<std::string> columns;
+    };
+
+    /**
+     * Tables, columns and functions a statement depends on
+     *
+     * Produced by @ref dependency_collector. Accesses made by views and triggers a
+     * statement uses are included, so reading a view reports both the view and the
+     * tables it reads.
+     *
+     * `#include <thinsqlitepp/dependencies.hpp>`
+     */
+    struct statement_dependencies
+    {
+        /// Tables and columns read
+        std::vector<table_access> reads;
+        /// Tables inserted into, deleted from or updated, with updated columns
+        std::vector<table_access> writes;
+        /// Names of SQL functions invoked
+        std::vector<std::string> functions;
+
+        /**
+         * Whether a table is read
+         *
+         * @param table Name of the table
+         * @param schema Name of the database. Reads reported without schema match any.
+         */
+        bool reads_table(std::string_view table, std::string_view schema = "main") const noexcept
+            { return find(reads, schema, table) != nullptr; }
+
+        /**
+         * Whether a table is modified
+         *
+         * @param table Name of the table
+         * @param schema Name of the database
+         */
+        bool writes_table(std::string_view table, std::string_view schema = "main") const noexcept
+            { return find(writes, schema, table) != nullptr; }
+
+        /// Forget everything
+        void clear() noexcept
+        {
+            reads.clear();
+            writes.clear();
+            functions.clear();
+        }
+
+        /** @cond PRIVATE */
+        static const table_access * find(const std::vector<table_access> & accesses,
+                                         std::string_view schema, std::string_view table) noexcept;
+        /** @endcond */
+    };
+
+    /**
+     * Authorizer that records statement dependencies
+     *
+     * Set a pointer to this object as database::authorizer() while compiling statements
+     * to learn which tables and columns they read and write. Every action is allowed.
+     * ```
+     * dependency_collector collector;
+     * db->authorizer(&collector);
+     * auto stmt = statement::create(*db, sql);
+     * db->authorizer(nullptr);
+     * route(collector.dependencies().writes.empty() ? readers : writer, std::move(stmt));
+     * ```
+     * Note that the authorizer is also invoked when SQLite recompiles a statement after a schema
+     * change so leaving the collector set keeps accumulating dependencies of such statements too.
+     * Use create_with_dependencies() to compile a single statement.
+     *
+     * `#include <thinsqlitepp/dependencies.hpp>`
+     */
+    class dependency_collector
+    {
+    public:
+        dependency_collector() noexcept = default;
+        dependency_collector(const dependency_collector &) = delete;
+        dependency_collector & operator=(const dependency_collector &) = delete;
+
+        /**
+         * Authorizer callback
+         *
+         * @returns #SQLITE_OK or #SQLITE_DENY if memory could not be allocated to record the action
+         */
+        int operator()(int action, const char * arg1, const char * arg2,
+                       const char * db_name, const char * trigger_or_view) noexcept;
+
+        /// Dependencies recorded so far
+        const statement_dependencies & dependencies() const noexcept
+            { return _deps; }
+        /// @overload
+        statement_dependencies & dependencies() noexcept
+            { return _deps; }
+    private:
+        static void add(std::vector<table_access> & accesses, const char * db_name,
+                        const char * table, const char * column);
+    private:
+        statement_dependencies _deps;
+    };
+
+    /**
+     * Compile an SQL statement recording its dependencies
+     *
+     * Same as @ref statement::create(const database &, const string_param &, unsigned int) "statement::create"
+     * but also records what the statement depends on via @ref dependency_collector. The database
+     * authorizer is replaced for the duration of the call and removed afterwards, so do not use
+     * this function while you have an authorizer of your own set. Setting the authorizer also
+     * expires all prepared statements of the connection: each of them is recompiled on its next
+     * step. Avoid calling this function in a loop on a connection with many live statements.
+     *
+     * @param db Database to compile the statement for
+     * @param sql SQL of the statement
+     * @param deps Receives the dependencies. Its previous content is discarded.
+     * @param flags Flags for ::sqlite3_prepare_v3
+     */
+    std::unique_ptr<statement> create_with_dependencies(database & db, const string_param & sql,
+                                                        statement_dependencies & deps
+                                                    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                        , unsigned int flags = 0
+                                                    #endif
+                                                        );
+
+    /** @} */
+}
+
+#endif
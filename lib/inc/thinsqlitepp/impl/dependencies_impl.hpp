@@ -0,0 +1,98 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_DEPENDENCIES_IMPL_INCLUDED
+#define HEADER_SQLITEPP_DEPENDENCIES_IMPL_INCLUDED
+
+#include "dependencies_iface.hpp"
+
+#include <algorithm>
+
+namespace thinsqlitepp
+{
+    inline const table_access * statement_dependencies::find(const std::vector<table_access> & accesses,
+                                                             std::string_view schema, std::string_view table) noexcept
+    {
+        for (auto & access: accesses)
+        {
+            if (access.table == table && (access.schema.empty() || access.schema == schema))
+                return &access;
+        }
+        return nullptr;
+    }
+
+    inline int dependency_collector::operator()(int action, const char * arg1, const char * arg2,
+                                                const char * db_name, const char * /*trigger_or_view*/) noexcept
+    {
+        try
+        {
+            switch(action)
+            {
+                case SQLITE_READ:
+                    add(_deps.reads, db_name, arg1, arg2);
+                    break;
+                case SQLITE_INSERT:
+                case SQLITE_DELETE:
+                    add(_deps.writes, db_name, arg1, nullptr);
+                    break;
+                case SQLITE_UPDATE:
+                    add(_deps.writes, db_name, arg1, arg2);
+                    break;
+                case SQLITE_FUNCTION:
+                    if (arg2 && std::find(_deps.functions.begin(), _deps.functions.end(), arg2) == _deps.functions.end())
+                        _deps.functions.emplace_back(arg2);
+                    break;
+            }
+            return SQLITE_OK;
+        }
+        catch(...)
+        {
+            return SQLITE_DENY;
+        }
+    }
+
+    inline void dependency_collector::add(std::vector<table_access> & accesses, const char * db_name,
+                                          const char * table, const char * column)
+    {
+        if (!table)
+            return;
+        std::string_view schema = db_name ? db_name : "";
+        auto it = std::find_if(accesses.begin(), accesses.end(), [&](const table_access & access) {
+            return access.table == table && access.schema == schema;
+        });
+        if (it == accesses.end())
+        {
+            accesses.push_back(table_access{std::string(schema), table, {}});
+            it = std::prev(accesses.end());
+        }
+        if (column && *column && std::find(it->columns.begin(), it->columns.end(), column) == it->columns.end())
+            it->columns.emplace_back(column);
+    }
+
+    inline std::unique_ptr<statement> create_with_dependencies(database & db, const string_param & sql,
+                                                               statement_dependencies & deps
+                                                           #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                               , unsigned int flags
+                                                           #endif
+                                                               )
+    {
+        dependency_collector collector;
+        db.authorizer(&collector);
+        auto res = statement::try_create(db, sql
+                                    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                         , flags
+                                    #endif
+                                        );
+        db.authorizer(nullptr);
+        auto ret = std::move(res).value();
+        deps = std::move(collector.dependencies());
+        return ret;
+    }
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include <exception>
 #include <memory>
 #include <limits>
+#include <type_traits>
 
 namespace thinsqlitepp
 {
@@ -231,6 +232,135 @@ namespace thinsqlitepp
         class error _error;
     };
 
+    /**
+     * A lightweight result of a non-throwing operation
+     *
+     * Stores an SQLite result code and, optionally, the database that produced it. Unlike @ref error
+     * no message is fetched or copied until error() is called, making this type cheap to create and
+     * discard for expected failures such as #SQLITE_BUSY.
+     *
+     * Since the database only remembers its most recent error, call error() before performing
+     * other operations on the same connection if you need the full error information.
+     *
+     * `#include <thinsqlitepp/exception.hpp>`
+     */
+    class result_code
+    {
+    public:
+        /// Constructs a success result
+        constexpr result_code() noexcept = default;
+
+        /// Constructs an instance from a result code and, optionally, the database that produced it
+        constexpr explicit result_code(int code, const database * db = nullptr) noexcept:
+            _code(code),
+            _db(db)
+        {}
+
+        /// Returns the result code as returned by SQLite
+        constexpr int code() const noexcept
+            { return _code; }
+        /// Returns primary result code part
+        constexpr int primary() const noexcept
+            { return _code & 0x0FF; }
+
+        /// Whether the result is a success: #SQLITE_OK, #SQLITE_ROW or #SQLITE_DONE
+        constexpr bool ok() const noexcept
+            { return _code == SQLITE_OK || _code == SQLITE_ROW || _code == SQLITE_DONE; }
+        /// Same as ok()
+        constexpr explicit operator bool() const noexcept
+            { return ok(); }
+
+        /**
+         * Builds full error information
+         *
+         * This is where the error message is obtained. See error::error(int, const database *) and
+         * error::error(int) for details.
+         */
+        class error error() const noexcept
+        {
+            using error_t = class error;
+            return _db ? error_t(_code, _db) : error_t(_code);
+        }
+
+        /// Throws @ref exception if the result is not a success
+        void check() const
+        {
+            if (!ok())
+                throw exception(error());
+        }
+    private:
+        int _code = SQLITE_OK;
+        const database * _db = nullptr;
+    };
+
+    /**
+     * Either a value or a failed @ref result_code
+     *
+     * This is a minimal `std::expected`-like type returned from non-throwing operations such as
+     * statement::try_create(). On failure the stored value is default constructed and value()
+     * throws @ref exception.
+     *
+     * `#include <thinsqlitepp/exception.hpp>`
+     *
+     * @tparam T type of the value. Must be default constructible.
+     */
+    template<class T>
+    class outcome
+    {
+    public:
+        /// Constructs a successful outcome
+        outcome(T val) noexcept(std::is_nothrow_move_constructible_v<T>):
+            _value(std::move(val))
+        {}
+        /// Constructs a failed outcome
+        outcome(result_code code) noexcept(std::is_nothrow_default_constructible_v<T>):
+            _code(code)
+        {}
+
+        /// Whether the outcome holds a value
+        bool has_value() const noexcept
+            { return _code.ok(); }
+        /// Same as has_value()
+        explicit operator bool() const noexcept
+            { return _code.ok(); }
+
+        /// Returns the value or throws @ref exception on failure
+        T & value() &
+            { _code.check(); return _value; }
+        /// @overload
+        const T & value() const &
+            { _code.check(); return _value; }
+        /// @overload
+        T && value() &&
+            { _code.check(); return std::move(_value); }
+
+        /// Unchecked access to the value
+        T & operator*() & noexcept
+            { return _value; }
+        /// @overload
+        const T & operator*() const & noexcept
+            { return _value; }
+        /// @overload
+        T && operator*() && noexcept
+            { return std::move(_value); }
+        /// Unchecked access to the value
+        T * operator->() noexcept
+            { return &_value; }
+        /// @overload
+        const T * operator->() const noexcept
+            { return &_value; }
+
+        /// Returns the result code. For a successful outcome it is #SQLITE_OK
+        const result_code & code() const noexcept
+            { return _code; }
+        /// Builds full error information. See result_code::error()
+        class error error() const noexcept
+            { return _code.error(); }
+    private:
+        T _value{};
+        result_code _code;
+    };
+
     /// @cond PRIVATE
 
     inline int int_size(size_t size)
@@ -0,0 +1,390 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_FTS5_IFACE_INCLUDED
+#define HEADER_SQLITEPP_FTS5_IFACE_INCLUDED
+
+#include "database_iface.hpp"
+#include "statement_iface.hpp"
+#include "exception_iface.hpp"
+#include "typed_function_iface.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace thinsqlitepp
+{
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Obtain the FTS5 extension API of a database connection
+     *
+     * Uses the `SELECT fts5(?)` pointer passing protocol described in
+     * [Extending FTS5](https://sqlite.org/fts5.html#extending_fts5).
+     *
+     * `#include <thinsqlitepp/fts5.hpp>`
+     *
+     * @throws exception if FTS5 is not available in this SQLite build
+     *
+     * @since SQLite 3.20
+     */
+    fts5_api * get_fts5_api(database & db);
+
+    /**
+     * Base class for FTS5 tokenizers
+     *
+     * This works similarly to @ref vtab. Derive your tokenizer from this class using
+     * [CRTP](https://en.cppreference.com/w/cpp/language/crtp) and register it with create_tokenizer().
+     * Each `CREATE VIRTUAL TABLE ... USING fts5(..., tokenize = 'name args...')` creates a new
+     * instance of your class. The derived class must provide:
+     * ```
+     * //if constructor_data_type is void
+     * Derived(int argc, const char * const * argv);
+     * //otherwise
+     * Derived(constructor_data_type data, int argc, const char * const * argv);
+     *
+     * void tokenize(int flags, std::string_view text, const token_sink & sink);
+     * ```
+     * The constructor receives the tokenizer arguments. `flags` is one of the `FTS5_TOKENIZE_` values.
+     * `tokenize` must call the sink for every token it finds.
+     *
+     * Exceptions thrown from the constructor or `tokenize` are reported to SQLite as errors:
+     * thinsqlitepp::exception preserves its error code, `std::bad_alloc` becomes #SQLITE_NOMEM and
+     * anything else #SQLITE_ERROR. In particular, errors returned by FTS5 from the sink are thrown as
+     * exceptions and so propagate back to SQLite unless you catch them.
+     *
+     * The `_base` suffix avoids a clash with SQLite's own `fts5_tokenizer` struct in code that uses
+     * `using namespace thinsqlitepp`.
+     *
+     * `#include <thinsqlitepp/fts5.hpp>`
+     *
+     * @since SQLite 3.20
+     */
+    template<class Derived>
+    class fts5_tokenizer_base
+    {
+    public:
+        /**
+         * Type of data passed via create_tokenizer to the constructor
+         *
+         * You can override this default by declaring a different pointer typedef in your
+         * derived class. The default is `void`, meaning no data is stored and passed.
+         */
+        using constructor_data_type = void;
+
+        /// Receives tokens produced by @ref fts5_tokenizer_base derived classes
+        class token_sink
+        {
+        friend fts5_tokenizer_base;
+        public:
+            /**
+             * Report a token
+             *
+             * @param token the token text. It does not need to point into the input
+             * @param start byte offset of the token start in the input
+             * @param end byte offset one past the token end in the input
+             * @param flags 0 or `FTS5_TOKEN_COLOCATED` for synonyms of the previous token
+             *
+             * @throws exception if FTS5 reports an error
+             */
+            void operator()(std::string_view token, int start, int end, int flags = 0) const
+            {
+                int res = _callback(_ctx, flags, token.data(), int(token.size()), start, end);
+                if (res != SQLITE_OK)
+                    throw exception(res);
+            }
+        private:
+            token_sink(void * ctx, int (*callback)(void *, int, const char *, int, int, int)) noexcept:
+                _ctx(ctx),
+                _callback(callback)
+            {}
+        private:
+            void * _ctx;
+            int (*_callback)(void *, int, const char *, int, int, int);
+        };
+    public:
+        /**
+         * Register the tokenizer with a database connection
+         *
+         * Wraps `fts5_api::xCreateTokenizer`. If @ref constructor_data_type is not void
+         * `nullptr` is passed to the derived class constructor.
+         *
+         * @throws exception if FTS5 is not available or registration fails
+         */
+        static void create_tokenizer(database & db, const char * name)
+            { create_tokenizer_impl(db, name, nullptr, nullptr); }
+
+        /**
+         * Register the tokenizer with a database connection
+         *
+         * Wraps `fts5_api::xCreateTokenizer`. This overload is available if @ref constructor_data_type
+         * is not `void`.
+         *
+         * @tparam D Defers resolution of nested data types declared in derived class. This is an
+         * internal implementation detail - never specify it explicitly.
+         *
+         * @param db database to register the tokenizer with
+         * @param name tokenizer name
+         * @param data data to be passed to your derived class constructor. Can be nullptr.
+         * @param destructor an optional destructor function for the data pointer. Can be nullptr.
+         *
+         * @throws exception if FTS5 is not available or registration fails
+         */
+        template<class D=Derived>
+        static
+        SQLITEPP_ENABLE_IF((std::is_pointer_v<typename D::constructor_data_type>),
+        void) create_tokenizer(database & db, const char * name,
+                               typename D::constructor_data_type data,
+                               void(*destructor)(typename D::constructor_data_type) = nullptr)
+        {
+            static_assert(std::is_same_v<D, Derived>, "please invoke this function only with default template parameter");
+            create_tokenizer_impl(db, name, (void *)data, (void(*)(void *))destructor);
+        }
+
+    protected:
+        fts5_tokenizer_base() noexcept = default;
+        ~fts5_tokenizer_base() noexcept = default;
+        fts5_tokenizer_base(const fts5_tokenizer_base &) = delete;
+        fts5_tokenizer_base & operator=(const fts5_tokenizer_base &) = delete;
+
+    private:
+        static void create_tokenizer_impl(database & db, const char * name, void * data, void(*destructor)(void *));
+
+        static int create_impl(void * data, const char ** argv, int argc, Fts5Tokenizer ** out) noexcept;
+        static void delete_impl(Fts5Tokenizer * tokenizer) noexcept;
+        static int tokenize_impl(Fts5Tokenizer * tokenizer, void * ctx, int flags, const char * text, int size,
+                                 int (*callback)(void *, int, const char *, int, int, int)) noexcept;
+        static int error_code() noexcept;
+    };
+
+    /**
+     * A fast tokenizer for ASCII and UTF-8 text
+     *
+     * Tokens are maximal runs of ASCII letters, digits and non-ASCII bytes. Non-ASCII characters are
+     * thus always part of tokens and are indexed as-is while ASCII letters are folded to lower case.
+     * Unlike `unicode61` no Unicode character classification, case folding or diacritic removal is
+     * performed which makes it considerably faster for mostly ASCII data such as logs, identifiers or code.
+     * Tokens that need no folding are passed to FTS5 directly from the input without copying.
+     *
+     * It accepts the following arguments (the same as the built-in `ascii` tokenizer):
+     * - `tokenchars 'chars'` additional ASCII characters to treat as parts of tokens
+     * - `separators 'chars'` ASCII characters to treat as separators
+     *
+     * ```
+     * fts5_ascii_tokenizer::create_tokenizer(*db, "fastascii");
+     * db->exec("CREATE VIRTUAL TABLE logs USING fts5(line, tokenize = \"fastascii tokenchars '_.'\")");
+     * ```
+     *
+     * `#include <thinsqlitepp/fts5.hpp>`
+     *
+     * @since SQLite 3.20
+     */
+    class fts5_ascii_tokenizer : public fts5_tokenizer_base<fts5_ascii_tokenizer>
+    {
+    public:
+        fts5_ascii_tokenizer(int argc, const char * const * argv);
+
+        void tokenize(int flags, std::string_view text, const token_sink & sink);
+    private:
+        enum char_class : unsigned char
+        {
+            separator,
+            token,
+            upper
+        };
+        char_class _classes[256];
+        std::string _folded;
+    };
+
+    /**
+     * Context of an FTS5 auxiliary function invocation
+     *
+     * Wraps `Fts5ExtensionApi` and `Fts5Context` passed to auxiliary functions registered with
+     * create_fts5_function(). Methods throw exception if FTS5 reports an error.
+     *
+     * `#include <thinsqlitepp/fts5.hpp>`
+     *
+     * @since SQLite 3.20
+     */
+    class fts5_context
+    {
+    public:
+        /// Location of a phrase match
+        struct instance
+        {
+            int phrase;     ///< Index of the phrase in the query
+            int column;     ///< Column of the match
+            int offset;     ///< Token offset of the match within the column
+        };
+    public:
+        fts5_context(const Fts5ExtensionApi * api, Fts5Context * ctx) noexcept:
+            _api(api),
+            _ctx(ctx)
+        {}
+
+        /// The underlying `Fts5ExtensionApi`
+        const Fts5ExtensionApi * api() const noexcept
+            { return _api; }
+        /// The underlying `Fts5Context`
+        Fts5Context * c_ptr() const noexcept
+            { return _ctx; }
+
+        /// Rowid of the current row. Wraps `xRowid`
+        int64_t rowid() const noexcept
+            { return _api->xRowid(_ctx); }
+        /// Number of columns in the table. Wraps `xColumnCount`
+        int column_count() const noexcept
+            { return _api->xColumnCount(_ctx); }
+        /// Number of rows in the table. Wraps `xRowCount`
+        int64_t row_count() const
+        {
+            sqlite3_int64 ret;
+            check(_api->xRowCount(_ctx, &ret));
+            return ret;
+        }
+        /// Total number of tokens in a column over all rows or in all columns if @p col is negative. Wraps `xColumnTotalSize`
+        int64_t column_total_size(int col) const
+        {
+            sqlite3_int64 ret;
+            check(_api->xColumnTotalSize(_ctx, col, &ret));
+            return ret;
+        }
+        /// Number of tokens in a column of the current row or in all columns if @p col is negative. Wraps `xColumnSize`
+        int column_size(int col) const
+        {
+            int ret;
+            check(_api->xColumnSize(_ctx, col, &ret));
+            return ret;
+        }
+        /// Text of a column of the current row. Wraps `xColumnText`
+        std::string_view column_text(int col) const
+        {
+            const char * text;
+            int size;
+            check(_api->xColumnText(_ctx, col, &text, &size));
+            return text ? std::string_view(text, size_t(size)) : std::string_view();
+        }
+        /// Number of phrases in the query. Wraps `xPhraseCount`
+        int phrase_count() const noexcept
+            { return _api->xPhraseCount(_ctx); }
+        /// Number of tokens in a query phrase. Wraps `xPhraseSize`
+        int phrase_size(int phrase) const noexcept
+            { return _api->xPhraseSize(_ctx, phrase); }
+        /// Number of phrase matches in the current row. Wraps `xInstCount`
+        int inst_count() const
+        {
+            int ret;
+            check(_api->xInstCount(_ctx, &ret));
+            return ret;
+        }
+        /// Details of a phrase match in the current row. Wraps `xInst`
+        instance inst(int idx) const
+        {
+            instance ret;
+            check(_api->xInst(_ctx, idx, &ret.phrase, &ret.column, &ret.offset));
+            return ret;
+        }
+    private:
+        static void check(int res)
+        {
+            if (res != SQLITE_OK)
+                throw exception(res);
+        }
+    private:
+        const Fts5ExtensionApi * _api;
+        Fts5Context * _ctx;
+    };
+
+    /** @} */
+
+    /** @cond PRIVATE */
+
+    template<class F, bool Callable = callable_traits<typed_function_target<F>>::is_callable>
+    struct fts5_function_detector
+    {
+        static constexpr bool value = false;
+    };
+
+    template<class F>
+    struct fts5_function_detector<F, true>
+    {
+    private:
+        using traits = callable_traits<typed_function_target<F>>;
+
+        template<class Args> struct signature_of
+        {
+            using type = typed_function_signature<void, void>;
+        };
+        template<class First, class... Args> struct signature_of<std::tuple<First, Args...>>
+        {
+            using type = std::conditional_t<std::is_same_v<std::remove_cv_t<std::remove_reference_t<First>>, fts5_context> &&
+                                                (std::is_const_v<std::remove_reference_t<First>> || !std::is_reference_v<First>),
+                                            typed_function_signature<typename traits::result_type, std::tuple<Args...>>,
+                                            typed_function_signature<void, void>>;
+        };
+    public:
+        using signature = typename signature_of<typename traits::arguments>::type;
+
+        static constexpr bool value = signature::valid;
+    };
+
+    template<class F>
+    constexpr bool is_fts5_function = fts5_function_detector<std::decay_t<F>>::value;
+
+    /** @endcond */
+
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Create or redefine an FTS5 auxiliary function from a C++ callable
+     *
+     * Wraps `fts5_api::xCreateFunction`
+     *
+     * The callable must take `const fts5_context &` as its first parameter. The remaining parameters
+     * correspond to the SQL arguments following the table name (e.g. `rank_fn(tbl, 1.5)`) and, together
+     * with the return type, follow the rules of @ref database::create_function(const char *, F, int)
+     * "typed create_function". Calling the function with a wrong number of arguments is an error.
+     * Exceptions escaping the callable are converted into SQL errors.
+     * ```
+     * create_fts5_function(*db, "hits", [](const fts5_context & ctxt) {
+     *     return ctxt.inst_count();
+     * });
+     * db->exec("SELECT rowid, hits(docs) FROM docs WHERE docs MATCH 'error'", ...);
+     * ```
+     *
+     * @param db database to register the function with
+     * @param name name of the function
+     * @param func Either a callable object or a function pointer, in which case it is copied and the copy is
+     * destroyed when the function is removed; or a **pointer** to such callable object which is used by
+     * reference and must outlive the registration.
+     *
+     * @throws exception if FTS5 is not available or registration fails
+     *
+     * `#include <thinsqlitepp/fts5.hpp>`
+     *
+     * @since SQLite 3.20
+     */
+    template<class F>
+    SQLITEPP_ENABLE_IF(is_fts5_function<F>,
+    void) create_fts5_function(database & db, const char * name, F func);
+
+    /** @} */
+
+#endif
+}
+
+#endif
@@ -0,0 +1,261 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_FTS5_IMPL_INCLUDED
+#define HEADER_SQLITEPP_FTS5_IMPL_INCLUDED
+
+#include "fts5_iface.hpp"
+#include "typed_function_impl.hpp"
+
+#include <new>
+
+#include <string.h>
+
+namespace thinsqlitepp
+{
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+
+    inline fts5_api * get_fts5_api(database & db)
+    {
+        fts5_api * ret = nullptr;
+        auto stmt = statement::create(db, "SELECT fts5(?1)");
+        stmt->bind<fts5_api *>(1, &ret, "fts5_api_ptr", nullptr);
+        stmt->step();
+        if (!ret)
+            throw exception(SQLITE_ERROR, error::message_ptr("FTS5 API is not available"));
+        return ret;
+    }
+
+    //MARK: - fts5_tokenizer_base
+
+    template<class Derived>
+    void fts5_tokenizer_base<Derived>::create_tokenizer_impl(database & db, const char * name, void * data, void(*destructor)(void *))
+    {
+        static ::fts5_tokenizer tokenizer = {
+            create_impl,
+            delete_impl,
+            tokenize_impl
+        };
+
+        fts5_api * api;
+        try
+        {
+            api = get_fts5_api(db);
+        }
+        catch(...)
+        {
+            if (destructor)
+                destructor(data);
+            throw;
+        }
+        int res = api->xCreateTokenizer(api, name, data, &tokenizer, destructor);
+        if (res != SQLITE_OK)
+        {
+            //FTS5 does not take ownership of the data on failure
+            if (destructor)
+                destructor(data);
+            throw exception(res);
+        }
+    }
+
+    template<class Derived>
+    int fts5_tokenizer_base<Derived>::error_code() noexcept
+    {
+        //Must be called from within a catch block
+        try
+        {
+            throw;
+        }
+        catch(exception & ex)
+        {
+            return ex.extended_error_code();
+        }
+        catch(std::bad_alloc &)
+        {
+            return SQLITE_NOMEM;
+        }
+        catch(...)
+        {
+            return SQLITE_ERROR;
+        }
+    }
+
+    template<class Derived>
+    int fts5_tokenizer_base<Derived>::create_impl([[maybe_unused]] void * data, const char ** argv, int argc, Fts5Tokenizer ** out) noexcept
+    {
+        try
+        {
+            Derived * ret;
+            if constexpr (std::is_void_v<typename Derived::constructor_data_type>)
+                ret = new Derived(argc, argv);
+            else
+                ret = new Derived((typename Derived::constructor_data_type)data, argc, argv);
+            *out = reinterpret_cast<Fts5Tokenizer *>(ret);
+            return SQLITE_OK;
+        }
+        catch(...)
+        {
+            return error_code();
+        }
+    }
+
+    template<class Derived>
+    void fts5_tokenizer_base<Derived>::delete_impl(Fts5Tokenizer * tokenizer) noexcept
+    {
+        delete reinterpret_cast<Derived *>(tokenizer);
+    }
+
+    template<class Derived>
+    int fts5_tokenizer_base<Derived>::tokenize_impl(Fts5Tokenizer * tokenizer, void * ctx, int flags, const char * text, int size,
+                                               int (*callback)(void *, int, const char *, int, int, int)) noexcept
+    {
+        try
+        {
+            auto me = reinterpret_cast<Derived *>(tokenizer);
+            me->tokenize(flags, std::string_view(text, size_t(size)), token_sink(ctx, callback));
+            return SQLITE_OK;
+        }
+        catch(...)
+        {
+            return error_code();
+        }
+    }
+
+    //MARK: - fts5_ascii_tokenizer
+
+    inline fts5_ascii_tokenizer::fts5_ascii_tokenizer(int argc, const char * const * argv)
+    {
+        for (unsigned i = 0; i < 256; ++i)
+        {
+            if (i >= 0x80 || (i >= 'a' && i <= 'z') || (i >= '0' && i <= '9'))
+                _classes[i] = token;
+            else if (i >= 'A' && i <= 'Z')
+                _classes[i] = upper;
+            else
+                _classes[i] = separator;
+        }
+
+        for (int i = 0; i < argc; i += 2)
+        {
+            const bool tokenchars = sqlite3_stricmp(argv[i], "tokenchars") == 0;
+            if ((!tokenchars && sqlite3_stricmp(argv[i], "separators") != 0) || i + 1 >= argc)
+                throw exception(SQLITE_ERROR, error::message_ptr("invalid fts5_ascii_tokenizer arguments"));
+            for (const char * c = argv[i + 1]; *c; ++c)
+            {
+                const auto byte = (unsigned char)*c;
+                //only ASCII characters can be reclassified
+                if (byte < 0x80)
+                    _classes[byte] = !tokenchars ? separator : (byte >= 'A' && byte <= 'Z' ? upper : token);
+            }
+        }
+    }
+
+    inline void fts5_ascii_tokenizer::tokenize(int /*flags*/, std::string_view text, const token_sink & sink)
+    {
+        const auto * const data = (const unsigned char *)text.data();
+        const size_t size = text.size();
+        const char_class * const classes = _classes;
+
+        size_t pos = 0;
+        for ( ; ; )
+        {
+            while (pos < size && classes[data[pos]] == separator)
+                ++pos;
+            if (pos == size)
+                break;
+
+            const size_t start = pos;
+            unsigned kinds = 0;
+            for (char_class cls; pos < size && (cls = classes[data[pos]]) != separator; ++pos)
+                kinds |= cls;
+
+            const std::string_view word(text.data() + start, pos - start);
+            if (kinds & upper)
+            {
+                _folded.assign(word);
+                for (char & c: _folded)
+                {
+                    if (classes[(unsigned char)c] == upper)
+                        c = char(c + ('a' - 'A'));
+                }
+                sink(_folded, int(start), int(pos));
+            }
+            else
+            {
+                sink(word, int(start), int(pos));
+            }
+        }
+    }
+
+    //MARK: - create_fts5_function
+
+    /** @cond PRIVATE */
+
+    template<class F>
+    struct fts5_function
+    {
+        using target = typed_function_target<F>;
+        using signature = typename fts5_function_detector<F>::signature;
+
+        static void call(const Fts5ExtensionApi * api, Fts5Context * fts, sqlite3_context * ctx,
+                         int count, sqlite3_value ** values) noexcept
+        {
+            auto ctxt = context::from(ctx);
+            if (count != signature::arg_count)
+            {
+                ctxt->error("wrong number of arguments to FTS5 auxiliary function");
+                return;
+            }
+            target & func = *static_cast<target *>(api->xUserData(fts));
+            const fts5_context fctxt(api, fts);
+            try
+            {
+                typed_function_call_and_store<signature>([&](auto && ... args) {
+                    return func(fctxt, std::forward<decltype(args)>(args)...);
+                }, ctxt, (value **)values);
+            }
+            catch(...)
+            {
+                typed_function_report_exception(ctxt);
+            }
+        }
+    };
+
+    /** @endcond */
+
+    template<class F>
+    SQLITEPP_ENABLE_IF(is_fts5_function<F>,
+    void) create_fts5_function(database & db, const char * name, F func)
+    {
+        using handler_t = fts5_function<F>;
+        using target_t = typename handler_t::target;
+
+        fts5_api * api = get_fts5_api(db);
+        int res;
+        if constexpr (!std::is_same_v<target_t, F>)
+        {
+            res = api->xCreateFunction(api, name, const_cast<std::remove_const_t<target_t> *>(func),
+                                       &handler_t::call, nullptr);
+        }
+        else
+        {
+            auto impl = new F(std::move(func));
+            res = api->xCreateFunction(api, name, impl, &handler_t::call, [](void * p) { delete static_cast<F *>(p); });
+            //FTS5 does not take ownership of the data on failure
+            if (res != SQLITE_OK)
+                delete impl;
+        }
+        if (res != SQLITE_OK)
+            throw exception(res);
+    }
+
+#endif
+}
+
+#endif
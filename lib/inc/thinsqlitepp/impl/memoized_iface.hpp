@@ -0,0 +1,333 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_MEMOIZED_IFACE_INCLUDED
+#define HEADER_SQLITEPP_MEMOIZED_IFACE_INCLUDED
+
+#include "typed_function_iface.hpp"
+#include "owned_value.hpp"
+
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace thinsqlitepp
+{
+    /** @cond PRIVATE */
+
+    template<class T>
+    owned_value memoized_key_from(const T & arg)
+    {
+        if constexpr (std::is_same_v<T, value>)
+            return owned_value(arg);
+        else if constexpr (std::is_pointer_v<T>)
+            return owned_value(*arg);
+    #if __cpp_char8_t >= 201811
+        else if constexpr (std::is_same_v<T, std::u8string_view>)
+            return owned_value(std::string_view((const char *)arg.data(), arg.size()));
+    #endif
+        else if constexpr (is_typed_function_scalar<T>)
+            return owned_value(arg);
+        else
+            return arg ? memoized_key_from(*arg) : owned_value();
+    }
+
+    //Must produce the same result as owned_value::hash() of memoized_key_from(arg) without allocating
+    template<class T>
+    size_t memoized_key_hash(const T & arg) noexcept
+    {
+        if constexpr (std::is_same_v<T, value>)
+        {
+            switch(arg.type())
+            {
+                case SQLITE_INTEGER: return memoized_key_hash(arg.template get<int64_t>());
+                case SQLITE_FLOAT:   return memoized_key_hash(arg.template get<double>());
+                case SQLITE_TEXT:    return memoized_key_hash(arg.template get<std::string_view>());
+                case SQLITE_BLOB:    return memoized_key_hash(arg.template get<blob_view>());
+                default:             return 0;
+            }
+        }
+        else if constexpr (std::is_pointer_v<T>)
+            return memoized_key_hash(*arg);
+        else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, int64_t>)
+            return std::hash<int64_t>()(arg);
+        else if constexpr (std::is_same_v<T, double>)
+            return std::hash<double>()(arg);
+        else if constexpr (std::is_same_v<T, std::string_view>)
+            return std::hash<std::string_view>()(arg);
+    #if __cpp_char8_t >= 201811
+        else if constexpr (std::is_same_v<T, std::u8string_view>)
+            return std::hash<std::string_view>()(std::string_view((const char *)arg.data(), arg.size()));
+    #endif
+        else if constexpr (std::is_same_v<T, blob_view>)
+            return std::hash<std::string_view>()(std::string_view((const char *)arg.data(), arg.size())) ^ 0x5bd1e995;
+        else
+            return arg ? memoized_key_hash(*arg) : 0;
+    }
+
+    template<class T>
+    bool memoized_key_equal(const owned_value & key, const T & arg) noexcept
+    {
+        if constexpr (std::is_same_v<T, value>)
+        {
+            if (key.type() != arg.type())
+                return false;
+            switch(arg.type())
+            {
+                case SQLITE_INTEGER: return key.get<int64_t>() == arg.template get<int64_t>();
+                case SQLITE_FLOAT:   return key.get<double>() == arg.template get<double>();
+                case SQLITE_TEXT:    return key.get<std::string_view>() == arg.template get<std::string_view>();
+                case SQLITE_BLOB:    return memoized_key_equal(key, arg.template get<blob_view>());
+                default:             return true;
+            }
+        }
+        else if constexpr (std::is_pointer_v<T>)
+            return memoized_key_equal(key, *arg);
+        else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, int64_t>)
+            return key.type() == SQLITE_INTEGER && key.get<int64_t>() == arg;
+        else if constexpr (std::is_same_v<T, double>)
+            return key.type() == SQLITE_FLOAT && key.get<double>() == arg;
+        else if constexpr (std::is_same_v<T, std::string_view>)
+            return key.type() == SQLITE_TEXT && key.get<std::string_view>() == arg;
+    #if __cpp_char8_t >= 201811
+        else if constexpr (std::is_same_v<T, std::u8string_view>)
+            return memoized_key_equal(key, std::string_view((const char *)arg.data(), arg.size()));
+    #endif
+        else if constexpr (std::is_same_v<T, blob_view>)
+        {
+            if (key.type() != SQLITE_BLOB)
+                return false;
+            auto bytes = key.get<blob_view>();
+            return std::equal(bytes.begin(), bytes.end(), arg.begin(), arg.end());
+        }
+        else
+            return arg ? memoized_key_equal(key, *arg) : key.is_null();
+    }
+
+    template<class T>
+    owned_value memoized_result_from(T && ret)
+    {
+        using result_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+        if constexpr (std::is_same_v<result_t, owned_value> || std::is_null_pointer_v<result_t> ||
+                      std::is_same_v<result_t, std::string> || std::is_same_v<result_t, std::string_view> ||
+                      std::is_same_v<result_t, blob_view>)
+            return owned_value(std::forward<T>(ret));
+        else if constexpr (std::is_integral_v<result_t>)
+            return owned_value(int64_t(ret));
+        else if constexpr (std::is_floating_point_v<result_t>)
+            return owned_value(double(ret));
+    #if __cpp_char8_t >= 201811
+        else if constexpr (std::is_same_v<result_t, std::u8string_view> || std::is_same_v<result_t, std::u8string>)
+            return owned_value(std::string_view((const char *)ret.data(), ret.size()));
+    #endif
+        else if constexpr (std::is_same_v<result_t, zero_blob>)
+            return owned_value(owned_value::blob(ret.size()));
+        else
+            return ret ? memoized_result_from(*std::forward<T>(ret)) : owned_value();
+    }
+
+    template<class Derived, class Args>
+    class memoized_call;
+
+    template<class Derived, class... Args>
+    class memoized_call<Derived, std::tuple<Args...>>
+    {
+    public:
+        const owned_value & operator()(Args... args)
+            { return static_cast<Derived *>(this)->lookup(args...); }
+    };
+
+    /** @endcond */
+
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Argument-keyed memoization for typed SQL functions
+     *
+     * Wraps a callable suitable for
+     * @ref database::create_function(const char *, F, int) "typed create_function" and remembers
+     * the results it returned for the most recently used argument values, up to a fixed capacity.
+     * Repeated calls with the same arguments return the remembered result without invoking the callable.
+     * This complements context::get_auxdata() which only helps when an argument is constant
+     * across a statement.
+     *
+     * The memoized object is itself a typed callable with the same arguments as the wrapped one.
+     * Register a pointer to it so its statistics remain accessible:
+     * ```
+     * memoized decode([](std::string_view hash) { return expensive_decode(hash); }, 1000);
+     * db->create_function("geo_decode", &decode, SQLITE_UTF8 | SQLITE_DETERMINISTIC);
+     * ...
+     * auto rate = double(decode.hits()) / (decode.hits() + decode.misses());
+     * ```
+     *
+     * Notes:
+     * - Only use it with deterministic functions: a remembered result is returned regardless of
+     *   anything else the function might depend on.
+     * - Arguments are compared after conversion to the callable's parameter types so, for example,
+     *   `'1'` and `1` are the same argument for an `int64_t` parameter.
+     * - The callable may not take a `context *` or return `void`, since results passed via
+     *   the context cannot be remembered.
+     * - Like the connection it is used with, an instance is not thread safe. Use a separate
+     *   instance per connection.
+     *
+     * `#include <thinsqlitepp/memoized.hpp>`
+     *
+     * @tparam F Type of the wrapped callable
+     */
+    template<class F>
+    class memoized : public memoized_call<memoized<F>, typename typed_function_detector<F>::signature::arguments>
+    {
+    friend memoized_call<memoized<F>, typename typed_function_detector<F>::signature::arguments>;
+    private:
+        using signature = typename typed_function_detector<F>::signature;
+
+        static_assert(typed_function_detector<F>::value && std::is_same_v<typed_function_target<F>, F>,
+                      "F must be a callable object or a function pointer usable with typed create_function");
+        static_assert(!signature::has_context, "memoized functions cannot take context *");
+        static_assert(!std::is_void_v<typename signature::result_type>, "memoized functions must return a value");
+
+        template<class Args> struct key_size;
+        template<class... Args> struct key_size<std::tuple<Args...>>
+            { static constexpr size_t value = sizeof...(Args); };
+
+        struct entry
+        {
+            size_t hash;
+            std::vector<owned_value> key;
+            owned_value result;
+        };
+        using entry_list = std::list<entry>;
+    public:
+        /**
+         * Constructs a memoized wrapper
+         *
+         * @param func Callable to wrap
+         * @param capacity Maximum number of results to remember. Must be positive.
+         */
+        memoized(F func, size_t capacity):
+            _func(std::move(func)),
+            _capacity(capacity ? capacity : 1)
+        {
+            _index.reserve(_capacity);
+        }
+
+        memoized(const memoized &) = delete;
+        memoized & operator=(const memoized &) = delete;
+
+        /// Maximum number of remembered results
+        size_t capacity() const noexcept
+            { return _capacity; }
+        /// Number of currently remembered results
+        size_t size() const noexcept
+            { return _entries.size(); }
+        /// Number of calls answered from remembered results
+        uint64_t hits() const noexcept
+            { return _hits; }
+        /// Number of calls that invoked the wrapped callable
+        uint64_t misses() const noexcept
+            { return _misses; }
+
+        /// Forget all remembered results. Statistics are preserved.
+        void clear() noexcept
+        {
+            _index.clear();
+            _entries.clear();
+        }
+        /// Reset hit and miss counters
+        void reset_stats() noexcept
+            { _hits = _misses = 0; }
+
+        /// Access the wrapped callable
+        F & function() noexcept
+            { return _func; }
+        /// @overload
+        const F & function() const noexcept
+            { return _func; }
+
+    private:
+        template<class... Args>
+        const owned_value & lookup(const Args & ... args)
+        {
+            size_t hash = combine_hashes({memoized_key_hash(args)...});
+
+            auto [first, last] = _index.equal_range(hash);
+            for ( ; first != last; ++first)
+            {
+                auto & found = *first->second;
+                size_t idx = 0;
+                if ((memoized_key_equal(found.key[idx++], args) && ...))
+                {
+                    ++_hits;
+                    _entries.splice(_entries.begin(), _entries, first->second);
+                    return found.result;
+                }
+                (void)idx;
+            }
+
+            ++_misses;
+            owned_value result = memoized_result_from(_func(args...));
+
+            if (_entries.size() == _capacity)
+                evict();
+            std::vector<owned_value> key;
+            key.reserve(key_size<typename signature::arguments>::value);
+            (key.push_back(memoized_key_from(args)), ...);
+            _entries.push_front(entry{hash, std::move(key), std::move(result)});
+            try
+            {
+                _index.emplace(hash, _entries.begin());
+            }
+            catch(...)
+            {
+                _entries.pop_front();
+                throw;
+            }
+            return _entries.front().result;
+        }
+
+        void evict() noexcept
+        {
+            auto victim = std::prev(_entries.end());
+            auto [first, last] = _index.equal_range(victim->hash);
+            for ( ; first != last; ++first)
+            {
+                if (first->second == victim)
+                {
+                    _index.erase(first);
+                    break;
+                }
+            }
+            _entries.erase(victim);
+        }
+
+        static size_t combine_hashes(std::initializer_list<size_t> hashes) noexcept
+        {
+            size_t ret = 0;
+            for (size_t hash: hashes)
+                ret ^= hash + 0x9e3779b9 + (ret << 6) + (ret >> 2);
+            return ret;
+        }
+    private:
+        F _func;
+        size_t _capacity;
+        entry_list _entries;
+        std::unordered_multimap<size_t, typename entry_list::iterator> _index;
+        uint64_t _hits = 0;
+        uint64_t _misses = 0;
+    };
+
+    /** @} */
+}
+
+#endif
+
@@ -12,6 +12,7 @@
 #include "config.hpp"
 
 #include <memory>
+#include <tuple>
 #include <type_traits>
 #if __cpp_impl_three_way_comparison >= 201907
     #include <compare>
@@ -84,6 +85,50 @@ namespace thinsqlitepp
     template<class T>
     constexpr bool dependent_true = dependent_bool<T, true>;
 
+
+    //MARK: - callable_traits
+
+    /*
+     Signature of a callable with a single, non-overloaded call operator: plain functions,
+     function pointers, member functions and class types (e.g. non-generic lambdas).
+     For anything else is_callable is false.
+    */
+    template<class F, class = void>
+    struct callable_traits
+    {
+        static constexpr bool is_callable = false;
+        using result_type = void;
+        using arguments = void;
+    };
+
+    template<class R, class... Args>
+    struct callable_traits<R (Args...)>
+    {
+        static constexpr bool is_callable = true;
+        using result_type = R;
+        using arguments = std::tuple<Args...>;
+    };
+    template<class R, class... Args>
+    struct callable_traits<R (Args...) noexcept> : callable_traits<R (Args...)> {};
+
+    template<class R, class... Args>
+    struct callable_traits<R (*)(Args...)> : callable_traits<R (Args...)> {};
+    template<class R, class... Args>
+    struct callable_traits<R (*)(Args...) noexcept> : callable_traits<R (Args...)> {};
+
+    template<class R, class C, class... Args>
+    struct callable_traits<R (C::*)(Args...)> : callable_traits<R (Args...)> {};
+    template<class R, class C, class... Args>
+    struct callable_traits<R (C::*)(Args...) noexcept> : callable_traits<R (Args...)> {};
+    template<class R, class C, class... Args>
+    struct callable_traits<R (C::*)(Args...) const> : callable_traits<R (Args...)> {};
+    template<class R, class C, class... Args>
+    struct callable_traits<R (C::*)(Args...) const noexcept> : callable_traits<R (Args...)> {};
+
+    template<class F>
+    struct callable_traits<F, std::enable_if_t<std::is_class_v<F>, std::void_t<decltype(&F::operator())>>> :
+        callable_traits<decltype(&F::operator())> {};
+
     
     //MARK: - strong_ordering_from_int
     
@@ -0,0 +1,110 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_NAME_INDEX_INCLUDED
+#define HEADER_SQLITEPP_NAME_INDEX_INCLUDED
+
+#include "sql_text.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <stdint.h>
+
+namespace thinsqlitepp
+{
+    /** @cond PRIVATE */
+
+    /**
+     * Hashed name to number table
+     *
+     * Open addressing over a power of 2 number of slots with names stored in one buffer.
+     * Hashes are the same as sql_text::hash_of so precomputed ones can be used for lookups.
+     */
+    class name_index
+    {
+    public:
+        static constexpr int not_found = -1;
+
+        name_index() noexcept = default;
+
+        template<class GetName>
+        void assign(int first, int last, GetName get_name)
+        {
+            clear();
+            size_t count = last > first ? size_t(last - first) : 0;
+            size_t capacity = 4;
+            while (capacity < 2 * count)
+                capacity *= 2;
+            _slots.resize(capacity);
+            _mask = capacity - 1;
+            for (int value = first; value < last; ++value)
+            {
+                const char * name = get_name(value);
+                if (name)
+                    insert(name, value);
+            }
+        }
+
+        void clear() noexcept
+        {
+            _slots.clear();
+            _names.clear();
+            _mask = 0;
+        }
+
+        bool empty() const noexcept
+            { return _slots.empty(); }
+
+        int find(std::string_view name) const noexcept
+            { return find(name, sql_text::hash_of(name)); }
+
+        int find(std::string_view name, size_t hash) const noexcept
+        {
+            if (_slots.empty())
+                return not_found;
+            for (size_t pos = hash & _mask; ; pos = (pos + 1) & _mask)
+            {
+                auto & slot = _slots[pos];
+                if (slot.value == not_found)
+                    return not_found;
+                if (slot.hash == hash && slot.size == name.size() &&
+                    std::string_view(_names.data() + slot.offset, slot.size) == name)
+                    return slot.value;
+            }
+        }
+    private:
+        void insert(std::string_view name, int value)
+        {
+            size_t hash = sql_text::hash_of(name);
+            if (find(name, hash) != not_found)
+                return; //first one wins
+            size_t pos = hash & _mask;
+            while (_slots[pos].value != not_found)
+                pos = (pos + 1) & _mask;
+            _slots[pos] = slot{hash, _names.size(), name.size(), value};
+            _names.append(name);
+        }
+    private:
+        struct slot
+        {
+            size_t hash = 0;
+            size_t offset = 0;
+            size_t size = 0;
+            int value = not_found;
+        };
+        std::vector<slot> _slots;
+        std::string _names;
+        size_t _mask = 0;
+    };
+
+    /** @endcond */
+}
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_NAMED_PARAMETERS_INCLUDED
+#define HEADER_SQLITEPP_NAMED_PARAMETERS_INCLUDED
+
+#include "statement_iface.hpp"
+#include "name_index.hpp"
+
+#include <new>
+
+namespace thinsqlitepp
+{
+    class parameter_name;
+
+    inline namespace literals
+    {
+        SQLITEPP_CONSTEVAL parameter_name operator""_param(const char * str, size_t size) noexcept;
+    }
+
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Name of a statement parameter with precomputed hash
+     *
+     * Normally produced at compile time by the `_param` literal, e.g. `":id"_param`.
+     * Looking up a parameter by such name does not hash or measure it at runtime.
+     * The name must include the prefix character (`:`, `@` or `$`).
+     *
+     * Like `std::string_view` this class has _reference_ semantics.
+     *
+     * `#include <thinsqlitepp/statement.hpp>`
+     */
+    class parameter_name
+    {
+    public:
+        /// Construct from any text, computing the hash at runtime if necessary
+        constexpr explicit parameter_name(std::string_view name) noexcept:
+            _name(name),
+            _hash(sql_text::hash_of(name))
+        {}
+
+        /// The name
+        constexpr std::string_view name() const noexcept
+            { return _name; }
+        /// Precomputed hash of the name
+        constexpr size_t hash() const noexcept
+            { return _hash; }
+    private:
+        std::string_view _name;
+        size_t _hash;
+    };
+
+    inline namespace literals
+    {
+        /**
+         * Produce @ref parameter_name from a string literal
+         *
+         * In C++20 and later this operator is `consteval` so the hash is always computed
+         * at compile time.
+         */
+        SQLITEPP_CONSTEVAL parameter_name operator""_param(const char * str, size_t size) noexcept
+            { return parameter_name(std::string_view(str, size)); }
+    }
+
+    /**
+     * Binds parameters of a @ref statement by name
+     *
+     * statement::bind_parameter_index, like ::sqlite3_bind_parameter_index it wraps,
+     * searches all the parameter names on every call. This class builds a hashed table of
+     * the names on first use instead so each subsequent lookup costs about the same as binding
+     * by index.
+     * ```
+     * auto stmt = statement::create(db, "INSERT INTO items VALUES(:id, :name, :price)");
+     * named_parameters params(stmt);
+     * for (auto & item: items) {
+     *     auto_reset<auto_reset_flags::all> reset(stmt);
+     *     params.bind(":id"_param, item.id);
+     *     params.bind(":name"_param, item.name);
+     *     params.bind(":price", item.price);
+     *     stmt->step();
+     * }
+     * ```
+     * Keep an instance of this class together with its statement for as long as the
+     * statement is used. Parameter names of a statement are determined by its SQL only and
+     * do not change when SQLite re-prepares it.
+     *
+     * The @ref statement is held by reference and must exist as long as this object is used.
+     *
+     * `#include <thinsqlitepp/statement.hpp>`
+     */
+    class named_parameters
+    {
+    public:
+        /// Construct an instance for a given statement
+        named_parameters(statement * owner) noexcept:
+            _owner(owner)
+        {}
+        /// @overload
+        named_parameters(const std::unique_ptr<statement> & owner) noexcept:
+            named_parameters(owner.get())
+        {}
+
+        /// The statement this object binds parameters of
+        statement * owner() const noexcept
+            { return _owner; }
+
+        /**
+         * Returns the index of a parameter with a given name
+         *
+         * Same as statement::bind_parameter_index. Builds the table of names on first call.
+         *
+         * @returns Parameter index or 0 if there is no parameter with this name
+         */
+        int index_of(std::string_view name) const
+            { return lookup(name, sql_text::hash_of(name)); }
+        /// @overload
+        int index_of(const parameter_name & name) const
+            { return lookup(name.name(), name.hash()); }
+
+        /**
+         * Bind a value to a named parameter
+         *
+         * Calls the @ref statement_bind "statement::bind" overload for the remaining arguments.
+         * Binding to a name that does not exist fails with #SQLITE_RANGE.
+         */
+        template<class... Args>
+        void bind(std::string_view name, Args && ... args)
+            { _owner->bind(index_of(name), std::forward<Args>(args)...); }
+        /// @overload
+        template<class... Args>
+        void bind(const parameter_name & name, Args && ... args)
+            { _owner->bind(index_of(name), std::forward<Args>(args)...); }
+
+        /// Same as bind() but calls statement::bind_reference
+        template<class... Args>
+        void bind_reference(std::string_view name, Args && ... args)
+            { _owner->bind_reference(index_of(name), std::forward<Args>(args)...); }
+        /// @overload
+        template<class... Args>
+        void bind_reference(const parameter_name & name, Args && ... args)
+            { _owner->bind_reference(index_of(name), std::forward<Args>(args)...); }
+
+        /**
+         * Non-throwing version of bind()
+         *
+         * Calls the @ref statement_try_bind "statement::try_bind" overload for the remaining arguments.
+         * Returns #SQLITE_NOMEM if the table of names cannot be built.
+         */
+        template<class... Args>
+        result_code try_bind(std::string_view name, Args && ... args) noexcept
+            { return try_bind_hashed(name, sql_text::hash_of(name), std::forward<Args>(args)...); }
+        /// @overload
+        template<class... Args>
+        result_code try_bind(const parameter_name & name, Args && ... args) noexcept
+            { return try_bind_hashed(name.name(), name.hash(), std::forward<Args>(args)...); }
+
+        /**
+         * Forget the table of names
+         *
+         * Only needed if the object is reused for a different statement
+         */
+        void reset(statement * owner) noexcept
+        {
+            _owner = owner;
+            _names.clear();
+        }
+    private:
+        int lookup(std::string_view name, size_t hash) const
+        {
+            if (_names.empty())
+            {
+                _names.assign(1, _owner->bind_parameter_count() + 1, [this](int idx) {
+                    return _owner->bind_parameter_name(idx);
+                });
+            }
+            auto ret = _names.find(name, hash);
+            return ret == name_index::not_found ? 0 : ret;
+        }
+
+        template<class... Args>
+        result_code try_bind_hashed(std::string_view name, size_t hash, Args && ... args) noexcept
+        {
+            int idx;
+            try
+            {
+                idx = lookup(name, hash);
+            }
+            catch(std::bad_alloc &)
+            {
+                return result_code(SQLITE_NOMEM);
+            }
+            return _owner->try_bind(idx, std::forward<Args>(args)...);
+        }
+    private:
+        statement * _owner;
+        mutable name_index _names;
+    };
+
+    /** @} */
+}
+
+#endif
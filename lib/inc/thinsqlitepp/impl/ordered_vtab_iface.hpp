@@ -0,0 +1,245 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_ORDERED_VTAB_IFACE_INCLUDED
+#define HEADER_SQLITEPP_ORDERED_VTAB_IFACE_INCLUDED
+
+#include "vtab_iface.hpp"
+#include "constraint_bound.hpp"
+
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace thinsqlitepp
+{
+    /** @cond PRIVATE */
+
+    template<class T, class = void>
+    struct ordered_element_key
+    {
+        using type = T;
+        static const T & get(const T & val) noexcept
+            { return val; }
+    };
+
+    template<class T>
+    struct ordered_element_key<T, std::void_t<decltype(std::declval<const T &>().first)>>
+    {
+        using type = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<const T &>().first)>>;
+        static const type & get(const T & val) noexcept
+            { return val.first; }
+    };
+
+    //Type a key is converted from when comparing with constraint arguments
+    template<class K>
+    using ordered_key_bound_type = std::conditional_t<std::is_integral_v<K>, int64_t,
+                                   std::conditional_t<std::is_same_v<K, double>, double,
+                                   std::conditional_t<std::is_constructible_v<K, std::string_view>, std::string_view,
+                                   void>>>;
+
+    template<class C, class K, class = void>
+    constexpr bool ordered_has_lower_bound = false;
+    template<class C, class K>
+    constexpr bool ordered_has_lower_bound<C, K, std::void_t<
+        decltype(std::declval<const C &>().lower_bound(std::declval<const K &>())),
+        decltype(std::declval<const C &>().upper_bound(std::declval<const K &>()))>> = true;
+
+    template<class C, class = void>
+    constexpr bool ordered_has_key_comp = false;
+    template<class C>
+    constexpr bool ordered_has_key_comp<C, std::void_t<decltype(std::declval<const C &>().key_comp())>> = true;
+
+    //associative containers with unique keys return a pair from insert()
+    template<class C, class = void>
+    constexpr bool ordered_has_unique_keys = false;
+    template<class C>
+    constexpr bool ordered_has_unique_keys<C, std::void_t<
+        typename C::key_type,
+        decltype(std::declval<C &>().insert(std::declval<const typename C::value_type &>()).second)>> = true;
+
+    /** @endcond */
+
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Base class for virtual tables over sorted C++ containers
+     *
+     * This class is a @ref vtab that exposes a container sorted by a key: an associative
+     * container like `std::map`, `std::set` or `std::multimap` or a sorted random-access sequence
+     * like `std::vector`. Constraints on the key column are turned into a single `[first, last)`
+     * iterator range found via the container's own `lower_bound`/`upper_bound` (or std::lower_bound
+     * for sequences) so lookups are O(log n). Containers without their own `lower_bound` must have
+     * random-access iterators; this is checked at compile time. Output is produced in key order,
+     * ascending or descending, so SQLite does not need to sort when the query orders by the key.
+     *
+     * Derive your class from it passing your class and the container type. Your class needs to:
+     * - Pass the container to this class constructor and declare the table schema as usual.
+     * - Define a `cursor` class derived from ordered_vtab::cursor that implements `column()` using
+     *   ordered_vtab::cursor::current() and ordered_vtab::cursor::key()
+     * ```
+     * class map_table : public ordered_vtab<map_table, std::map<int, std::string>> {
+     * public:
+     *     using constructor_data_type = std::map<int, std::string> *;
+     *
+     *     map_table(connect_t, database * db, std::map<int, std::string> * map, int, const char * const *):
+     *         ordered_vtab(*map)
+     *     { db->declare_vtab("CREATE TABLE x(key INTEGER PRIMARY KEY, value TEXT)"); }
+     *
+     *     class cursor : public ordered_vtab::cursor {
+     *     public:
+     *         using ordered_vtab::cursor::cursor;
+     *         void column(context & ctxt, int idx) const {
+     *             if (idx == 0) ctxt.result(key()); else ctxt.result(current().second);
+     *         }
+     *     };
+     * };
+     * ```
+     *
+     * The element key is the element itself or its `first` member if it has one. The key type must be
+     * integral, `double` or a string type constructible from `std::string_view` and the container must be
+     * sorted in ascending key order consistent with SQLite (`BINARY` collation for strings). Only
+     * `=`, `<`, `<=`, `>` and `>=` constraints on the key are handled and SQLite still double checks them.
+     *
+     * You can change the following defaults by declaring members with the same names in your class:
+     * - `static constexpr int key_column = 0;` the index of the key column in the declared schema
+     * - `static constexpr bool key_is_rowid` whether the key is also the rowid. Defaults to `true`
+     *   for integral keys of containers with unique keys.
+     *
+     * The container must outlive the table and not be modified while statements using it are active.
+     *
+     * `#include <thinsqlitepp/ordered_vtab.hpp>`
+     *
+     * @tparam Derived Your derived class
+     * @tparam Container Type of the container
+     */
+    template<class Derived, class Container>
+    class ordered_vtab : public vtab<Derived>
+    {
+    public:
+        /// Type of the container
+        using container_type = Container;
+        /// Type of the container elements
+        using value_type = typename Container::value_type;
+        /// Type of the element keys
+        using key_type = typename ordered_element_key<value_type>::type;
+        /// Iterator used to traverse the container
+        using iterator = typename Container::const_iterator;
+
+        /// Data passed between best_index() and cursor::filter()
+        struct scan_plan : public sqlite_allocated
+        {
+            size_t count;   ///< Number of constraints
+            int ops[1];     ///< SQLITE_INDEX_CONSTRAINT_ for each constraint in the order of `argv` values
+        };
+
+        using index_data_type = scan_plan *;
+
+        /// Index of the key column. Redeclare it in your derived class to change.
+        static constexpr int key_column = 0;
+        /// Whether the key is also the rowid. Redeclare it in your derived class to change.
+        static constexpr bool key_is_rowid = std::is_integral_v<key_type> && ordered_has_unique_keys<Container>;
+
+        static_assert(!std::is_void_v<ordered_key_bound_type<key_type>>,
+                      "key must be integral, double or a string constructible from std::string_view");
+
+        /**
+         * Base class for cursors
+         *
+         * Implements everything except `column()`
+         */
+        class cursor : public vtab<Derived>::cursor
+        {
+        public:
+            using vtab<Derived>::cursor::cursor;
+
+            /// Equivalent to @ref xFilter
+            void filter(int idx, scan_plan * plan, int argc, value ** argv);
+
+            /// Equivalent to @ref xEof
+            bool eof() const noexcept
+                { return _first == _last; }
+
+            /// Equivalent to @ref xNext
+            void next()
+            {
+                if (_descending)
+                    --_last;
+                else
+                    ++_first;
+            }
+
+            /**
+             * Equivalent to @ref xRowid
+             *
+             * Returns the key if `key_is_rowid` is `true` or reports an error otherwise.
+             * Re-define this method if your table has a different rowid.
+             */
+            int64_t rowid() const
+            {
+                if constexpr (Derived::key_is_rowid)
+                    return int64_t(key());
+                else
+                    return int64_t(vtab<Derived>::cursor::rowid());
+            }
+
+        protected:
+            /// Iterator to the current element
+            iterator current_iterator() const noexcept
+                { return _descending ? std::prev(_last) : _first; }
+            /// The current element
+            const value_type & current() const noexcept
+                { return *current_iterator(); }
+            /// The key of the current element
+            const key_type & key() const noexcept
+                { return ordered_element_key<value_type>::get(current()); }
+        private:
+            iterator _first;
+            iterator _last;
+            bool _descending = false;
+        };
+
+    public:
+        /// Equivalent to @ref xBestIndex
+        bool best_index(index_info<index_data_type> & info) const;
+
+        /// Access the container
+        const Container & container() const noexcept
+            { return *_container; }
+
+    protected:
+        /// Constructs an instance over a given container
+        ordered_vtab(const Container & container) noexcept:
+            _container(&container)
+        {}
+
+    private:
+        static constexpr int descending_flag = 1;
+
+        bool is_key_column(int column) const noexcept
+            { return column == Derived::key_column || (Derived::key_is_rowid && column < 0); }
+
+        auto key_less() const;
+        static constraint_bound<key_type> make_key_bound(int op, const value & arg);
+        iterator lower_bound(const key_type & key) const;
+        iterator upper_bound(const key_type & key) const;
+        std::pair<iterator, iterator> find_range(const int * ops, size_t count, value * const * args) const;
+    private:
+        const Container * _container;
+    };
+
+    /** @} */
+}
+
+#endif
@@ -0,0 +1,314 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_ORDERED_VTAB_IMPL_INCLUDED
+#define HEADER_SQLITEPP_ORDERED_VTAB_IMPL_INCLUDED
+
+#include "ordered_vtab_iface.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+#include <stddef.h>
+
+namespace thinsqlitepp
+{
+    template<class Derived, class Container>
+    auto ordered_vtab<Derived, Container>::key_less() const
+    {
+        if constexpr (ordered_has_key_comp<Container>)
+            return _container->key_comp();
+        else
+            return std::less<key_type>();
+    }
+
+    template<class Derived, class Container>
+    auto ordered_vtab<Derived, Container>::lower_bound(const key_type & key) const -> iterator
+    {
+        if constexpr (ordered_has_lower_bound<Container, key_type>)
+        {
+            return _container->lower_bound(key);
+        }
+        else
+        {
+            static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                            typename std::iterator_traits<iterator>::iterator_category>,
+                          "a container without its own lower_bound/upper_bound must be a random-access sequence "
+                          "for key lookups to be O(log n)");
+            return std::lower_bound(_container->begin(), _container->end(), key,
+                                    [less = key_less()](const value_type & lhs, const key_type & rhs) {
+                return less(ordered_element_key<value_type>::get(lhs), rhs);
+            });
+        }
+    }
+
+    template<class Derived, class Container>
+    auto ordered_vtab<Derived, Container>::upper_bound(const key_type & key) const -> iterator
+    {
+        if constexpr (ordered_has_lower_bound<Container, key_type>)
+        {
+            return _container->upper_bound(key);
+        }
+        else
+        {
+            static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                            typename std::iterator_traits<iterator>::iterator_category>,
+                          "a container without its own lower_bound/upper_bound must be a random-access sequence "
+                          "for key lookups to be O(log n)");
+            return std::upper_bound(_container->begin(), _container->end(), key,
+                                    [less = key_less()](const key_type & lhs, const value_type & rhs) {
+                return less(lhs, ordered_element_key<value_type>::get(rhs));
+            });
+        }
+    }
+
+    template<class Derived, class Container>
+    auto ordered_vtab<Derived, Container>::make_key_bound(int op, const value & arg) -> constraint_bound<key_type>
+    {
+        using bound_type = ordered_key_bound_type<key_type>;
+
+        auto bound = make_constraint_bound<bound_type>(op, arg);
+        if (bound.match != constraint_match::compare)
+            return {bound.match, op, key_type()};
+
+        if constexpr (std::is_integral_v<key_type>)
+        {
+            //narrow int64_t to the key type
+            using limits = std::numeric_limits<key_type>;
+            const bool above = std::is_unsigned_v<key_type> ?
+                                    bound.value >= 0 && uint64_t(bound.value) > uint64_t(limits::max()) :
+                                    bound.value > int64_t(limits::max());
+            const bool below = std::is_unsigned_v<key_type> ?
+                                    bound.value < 0 :
+                                    bound.value < int64_t(limits::min());
+            if (above)
+                return {(bound.op == SQLITE_INDEX_CONSTRAINT_LT || bound.op == SQLITE_INDEX_CONSTRAINT_LE) ?
+                            constraint_match::all : constraint_match::none, bound.op, key_type()};
+            if (below)
+                return {(bound.op == SQLITE_INDEX_CONSTRAINT_GT || bound.op == SQLITE_INDEX_CONSTRAINT_GE) ?
+                            constraint_match::all : constraint_match::none, bound.op, key_type()};
+        }
+        return {constraint_match::compare, bound.op, key_type(bound.value)};
+    }
+
+    template<class Derived, class Container>
+    bool ordered_vtab<Derived, Container>::best_index(index_info<index_data_type> & info) const
+    {
+        const auto constraints = info.constraints();
+        auto usages = info.constraints_usage();
+        const double size = double(_container->size());
+
+        std::unique_ptr<scan_plan> plan;
+        bool has_lower = false, has_upper = false, has_equal = false;
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+        //constant arguments, if all are known, let us compute the exact row count
+        constexpr bool can_count = std::is_base_of_v<std::random_access_iterator_tag,
+                                                      typename std::iterator_traits<iterator>::iterator_category>;
+        std::vector<value *> known_args;
+        bool all_known = can_count;
+    #endif
+
+        for (size_t i = 0; i < constraints.size(); ++i)
+        {
+            auto & constraint = constraints[i];
+            if (!constraint.usable || !is_key_column(constraint.iColumn))
+                continue;
+            switch(constraint.op)
+            {
+                case SQLITE_INDEX_CONSTRAINT_EQ:
+                case SQLITE_INDEX_CONSTRAINT_GT:
+                case SQLITE_INDEX_CONSTRAINT_GE:
+                case SQLITE_INDEX_CONSTRAINT_LT:
+                case SQLITE_INDEX_CONSTRAINT_LE:
+                    break;
+                default:
+                    continue;
+            }
+            if constexpr (std::is_same_v<ordered_key_bound_type<key_type>, std::string_view>)
+            {
+                //keys are compared bytewise so only BINARY collation can be handled
+            #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 22, 0)
+                const char * collation = info.collation(int(i));
+                if (collation && sqlite3_stricmp(collation, "BINARY") != 0)
+                    continue;
+            #else
+                continue;
+            #endif
+            }
+
+            if (!plan)
+            {
+                size_t alloc_size = offsetof(scan_plan, ops) + sizeof(int) * constraints.size();
+                plan.reset((scan_plan *)scan_plan::operator new(alloc_size));
+                plan->count = 0;
+            }
+            plan->ops[plan->count] = constraint.op;
+            //SQLite still checks the constraint since argument conversions may depend on affinity
+            usages[i].argvIndex = int(++plan->count);
+        #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+            if (all_known)
+            {
+                value * arg = info.rhs_value(int(i));
+                all_known = arg != nullptr;
+                known_args.push_back(arg);
+            }
+        #endif
+
+            has_equal |= constraint.op == SQLITE_INDEX_CONSTRAINT_EQ;
+            has_lower |= constraint.op == SQLITE_INDEX_CONSTRAINT_GT || constraint.op == SQLITE_INDEX_CONSTRAINT_GE;
+            has_upper |= constraint.op == SQLITE_INDEX_CONSTRAINT_LT || constraint.op == SQLITE_INDEX_CONSTRAINT_LE;
+        }
+
+        //first let's check if we already provide the required order, if any
+        auto orderbys = info.orderbys();
+        bool ordered = !orderbys.empty() && is_key_column(orderbys[0].iColumn);
+        for (size_t i = 1; ordered && i < orderbys.size(); ++i)
+        {
+            //with unique keys the order is total so anything after the key is already satisfied
+            if (ordered_has_unique_keys<Container>)
+                break;
+            ordered = is_key_column(orderbys[i].iColumn) && orderbys[i].desc == orderbys[0].desc;
+        }
+        int flags = 0;
+        if (ordered)
+        {
+            info.set_order_by_consumed(true);
+            if (orderbys[0].desc)
+                flags |= descending_flag;
+        }
+
+        double estimated_rows = size;
+        [[maybe_unused]] bool unique = false;
+        if (has_equal)
+        {
+            unique = ordered_has_unique_keys<Container>;
+            estimated_rows = unique ? 1 : std::ceil(size / 10);
+        }
+        else if (has_lower && has_upper)
+        {
+            estimated_rows = std::ceil(size / 16);
+        }
+        else if (has_lower || has_upper)
+        {
+            estimated_rows = std::ceil(size / 4);
+        }
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+        if constexpr (can_count)
+        {
+            if (plan && all_known)
+            {
+                auto [first, last] = find_range(plan->ops, plan->count, known_args.data());
+                estimated_rows = double(last - first);
+            }
+        }
+    #endif
+        const double search_cost = plan ? 2 * std::log2(size + 1) : 0;
+        info.set_estimated_cost(search_cost + estimated_rows);
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 8, 2)
+        info.set_estimated_rows(int64_t(estimated_rows));
+    #endif
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 9, 0)
+        if (unique)
+            info.set_index_flags(info.index_flags() | SQLITE_INDEX_SCAN_UNIQUE);
+    #endif
+
+        info.set_index_number(flags);
+        if (plan)
+            info.set_index_data(std::move(plan));
+        return true;
+    }
+
+    template<class Derived, class Container>
+    auto ordered_vtab<Derived, Container>::find_range(const int * ops, size_t count, value * const * args) const ->
+        std::pair<iterator, iterator>
+    {
+        auto less = key_less();
+        const std::pair<iterator, iterator> empty(_container->end(), _container->end());
+
+        //combine all the constraints into at most one lower and one upper bound
+        std::optional<key_type> lower, upper;
+        bool lower_inclusive = false, upper_inclusive = false;
+        auto restrict_lower = [&](key_type && key, bool inclusive) {
+            if (!lower || less(*lower, key))
+            {
+                lower = std::move(key);
+                lower_inclusive = inclusive;
+            }
+            else if (!less(key, *lower))
+            {
+                lower_inclusive = lower_inclusive && inclusive;
+            }
+        };
+        auto restrict_upper = [&](key_type && key, bool inclusive) {
+            if (!upper || less(key, *upper))
+            {
+                upper = std::move(key);
+                upper_inclusive = inclusive;
+            }
+            else if (!less(*upper, key))
+            {
+                upper_inclusive = upper_inclusive && inclusive;
+            }
+        };
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto bound = make_key_bound(ops[i], *args[i]);
+            if (bound.match == constraint_match::none)
+                return empty;
+            if (bound.match == constraint_match::all)
+                continue;
+            switch(bound.op)
+            {
+                case SQLITE_INDEX_CONSTRAINT_EQ:
+                    restrict_lower(key_type(bound.value), true);
+                    restrict_upper(std::move(bound.value), true);
+                    break;
+                case SQLITE_INDEX_CONSTRAINT_GT: restrict_lower(std::move(bound.value), false); break;
+                case SQLITE_INDEX_CONSTRAINT_GE: restrict_lower(std::move(bound.value), true); break;
+                case SQLITE_INDEX_CONSTRAINT_LT: restrict_upper(std::move(bound.value), false); break;
+                case SQLITE_INDEX_CONSTRAINT_LE: restrict_upper(std::move(bound.value), true); break;
+            }
+        }
+
+        if (lower && upper)
+        {
+            //an empty range would produce iterators out of order
+            if (less(*upper, *lower))
+                return empty;
+            if (!less(*lower, *upper) && !(lower_inclusive && upper_inclusive))
+                return empty;
+        }
+
+        return {
+            !lower ? _container->begin() : lower_inclusive ? lower_bound(*lower) : upper_bound(*lower),
+            !upper ? _container->end() : upper_inclusive ? upper_bound(*upper) : lower_bound(*upper)
+        };
+    }
+
+    template<class Derived, class Container>
+    void ordered_vtab<Derived, Container>::cursor::filter(int idx, scan_plan * plan, [[maybe_unused]] int argc, value ** argv)
+    {
+        const ordered_vtab * me = this->owner();
+
+        _descending = (idx & descending_flag) != 0;
+        if (plan)
+        {
+            assert(size_t(argc) == plan->count);
+            std::tie(_first, _last) = me->find_range(plan->ops, plan->count, argv);
+        }
+        else
+        {
+            _first = me->_container->begin();
+            _last = me->_container->end();
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_OWNED_VALUE_INCLUDED
+#define HEADER_SQLITEPP_OWNED_VALUE_INCLUDED
+
+#include "value_iface.hpp"
+#include "meta.hpp"
+
+#include <string>
+#include <vector>
+#include <variant>
+#include <functional>
+
+namespace thinsqlitepp
+{
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * A self-contained copy of an SQLite value
+     *
+     * Unlike @ref value, which is a [fake wrapper class](https://github.com/gershnik/thinsqlitepp#fake-classes)
+     * that is only valid while SQLite says so, this class owns its data in ordinary C++ memory.
+     * It does not reference SQLite in any way once constructed and so can be freely kept around,
+     * moved between threads and outlive the database it came from.
+     *
+     * `#include <thinsqlitepp/value.hpp>`
+     */
+    class owned_value
+    {
+    public:
+        /// Type used to store blobs
+        using blob = std::vector<std::byte>;
+    private:
+        using storage = std::variant<std::nullptr_t, int64_t, double, std::string, blob>;
+    public:
+        /// Constructs a NULL value
+        owned_value() noexcept = default;
+        /// @overload
+        owned_value(std::nullptr_t) noexcept
+        {}
+        /// Constructs an INTEGER value
+        owned_value(int64_t val) noexcept:
+            _data(val)
+        {}
+        /// @overload
+        owned_value(int val) noexcept:
+            _data(int64_t(val))
+        {}
+        /// Constructs a FLOAT value
+        owned_value(double val) noexcept:
+            _data(val)
+        {}
+        /// Constructs a TEXT value
+        owned_value(std::string val) noexcept:
+            _data(std::move(val))
+        {}
+        /// @overload
+        owned_value(std::string_view val):
+            _data(std::string(val))
+        {}
+        /// @overload
+        owned_value(const char * val):
+            _data(std::string(val))
+        {}
+        /// Constructs a BLOB value
+        owned_value(blob val) noexcept:
+            _data(std::move(val))
+        {}
+        /// @overload
+        owned_value(const blob_view & val):
+            _data(blob(val.begin(), val.end()))
+        {}
+        /**
+         * Constructs a copy of an SQLite @ref value
+         *
+         * The copy preserves the value's type as reported by value::type()
+         */
+        explicit owned_value(const value & val)
+        {
+            switch(val.type())
+            {
+                case SQLITE_INTEGER: _data = val.get<int64_t>();                 break;
+                case SQLITE_FLOAT:   _data = val.get<double>();                  break;
+                case SQLITE_TEXT:    _data = std::string(val.get<std::string_view>()); break;
+                case SQLITE_BLOB:    { auto bytes = val.get<blob_view>(); _data = blob(bytes.begin(), bytes.end()); } break;
+            }
+        }
+
+        /**
+         * Datatype of the value
+         *
+         * @returns One of the SQLite [datatype constants](https://www.sqlite.org/c3ref/c_blob.html)
+         */
+        int type() const noexcept
+        {
+            static constexpr int types[] = { SQLITE_NULL, SQLITE_INTEGER, SQLITE_FLOAT, SQLITE_TEXT, SQLITE_BLOB };
+            return types[_data.index()];
+        }
+
+        /// Whether the value is NULL
+        bool is_null() const noexcept
+            { return _data.index() == 0; }
+
+        /**
+         * Obtain value's content
+         *
+         * Numeric types convert between each other. TEXT and BLOB values expose
+         * their bytes to both std::string_view and blob_view. Any other combination returns
+         * a default constructed result.
+         *
+         * @tparam T Desired output type. Must be one of:
+         * - int
+         * - int64_t
+         * - double
+         * - std::string_view
+         * - blob_view
+         */
+        template<class T>
+        T get() const noexcept
+        {
+            if constexpr (std::is_same_v<T, int> || std::is_same_v<T, int64_t> || std::is_same_v<T, double>)
+            {
+                if (auto p = std::get_if<int64_t>(&_data))
+                    return T(*p);
+                if (auto p = std::get_if<double>(&_data))
+                    return T(*p);
+                return T{};
+            }
+            else if constexpr (std::is_same_v<T, std::string_view>)
+            {
+                if (auto p = std::get_if<std::string>(&_data))
+                    return *p;
+                if (auto p = std::get_if<blob>(&_data))
+                    return std::string_view((const char *)p->data(), p->size());
+                return T{};
+            }
+            else if constexpr (std::is_same_v<T, blob_view>)
+            {
+                if (auto p = std::get_if<blob>(&_data))
+                    return blob_view(p->data(), p->size());
+                if (auto p = std::get_if<std::string>(&_data))
+                    return blob_view((const std::byte *)p->data(), p->size());
+                return T{};
+            }
+            else
+            {
+                static_assert(dependent_false<T>, "unsupported type");
+            }
+        }
+
+        /// Approximate number of bytes of heap memory held by this value
+        size_t heap_size() const noexcept
+        {
+            if (auto p = std::get_if<std::string>(&_data))
+                return p->capacity();
+            if (auto p = std::get_if<blob>(&_data))
+                return p->capacity();
+            return 0;
+        }
+
+        /// Hash code of the value
+        size_t hash() const noexcept
+        {
+            return std::visit([](const auto & val) -> size_t {
+                using type = std::decay_t<decltype(val)>;
+                if constexpr (std::is_same_v<type, std::nullptr_t>)
+                    return 0;
+                else if constexpr (std::is_same_v<type, blob>)
+                    return std::hash<std::string_view>()(std::string_view((const char *)val.data(), val.size())) ^ 0x5bd1e995;
+                else
+                    return std::hash<type>()(val);
+            }, _data);
+        }
+
+        /// Values are equal if they have the same type and content
+        friend bool operator==(const owned_value & lhs, const owned_value & rhs) noexcept
+            { return lhs._data == rhs._data; }
+        /// @overload
+        friend bool operator!=(const owned_value & lhs, const owned_value & rhs) noexcept
+            { return lhs._data != rhs._data; }
+    private:
+        storage _data;
+    };
+
+    /** @} */
+}
+
+/** @cond PRIVATE */
+
+namespace std
+{
+    template<>
+    struct hash<thinsqlitepp::owned_value>
+    {
+        size_t operator()(const thinsqlitepp::owned_value & val) const noexcept
+            { return val.hash(); }
+    };
+}
+
+/** @endcond */
+
+#endif
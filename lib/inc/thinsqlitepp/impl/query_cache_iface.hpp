@@ -0,0 +1,273 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_QUERY_CACHE_IFACE_INCLUDED
+#define HEADER_SQLITEPP_QUERY_CACHE_IFACE_INCLUDED
+
+#include "database_iface.hpp"
+#include "statement_iface.hpp"
+#include "dependencies_iface.hpp"
+#include "owned_value.hpp"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace thinsqlitepp
+{
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 16, 0)
+
+    /**
+     * Materialized result of a query
+     *
+     * Holds copies of all the rows returned by a query in ordinary C++ memory.
+     * Objects of this class are produced by @ref query_cache and are immutable.
+     *
+     * `#include <thinsqlitepp/query_cache.hpp>`
+     */
+    class query_result
+    {
+    friend class query_cache;
+    public:
+        /// Number of columns
+        int column_count() const noexcept
+            { return int(_names.size()); }
+
+        /// Name of a column
+        const std::string & column_name(int idx) const noexcept
+            { return _names[size_t(idx)]; }
+
+        /// Number of rows
+        size_t row_count() const noexcept
+            { return _names.empty() ? 0 : _cells.size() / _names.size(); }
+
+        /// Whether the result has no rows
+        bool empty() const noexcept
+            { return _cells.empty(); }
+
+        /// Value of a column in a row
+        const owned_value & at(size_t row, int column) const noexcept
+            { return _cells[row * _names.size() + size_t(column)]; }
+
+        /// Approximate number of bytes of memory held by this object
+        size_t memory_size() const noexcept;
+    private:
+        std::vector<std::string> _names;
+        std::vector<owned_value> _cells;
+    };
+
+    /**
+     * Result cache for read-only queries
+     *
+     * Runs queries on a database and remembers their materialized results keyed by the SQL text
+     * and bound parameter values. Repeating a query returns the remembered result without
+     * touching SQLite. A compiled statement is kept for as long as any remembered result was made
+     * with it. Statements no result needs anymore are kept for subsequent cache misses in a small
+     * least recently used list of limited size.
+     *
+     * ```
+     * query_cache cache(*db, 16 * 1024 * 1024);
+     * ...
+     * auto res = cache.query("SELECT name, price FROM products WHERE category = ?", category);
+     * for (size_t i = 0; i < res->row_count(); ++i)
+     *     show(res->at(i, 0).get<std::string_view>(), res->at(i, 1).get<double>());
+     * ```
+     *
+     * When a query is first compiled the cache records, via @ref dependency_collector, which tables it reads.
+     * It installs an update hook on the database and, when a row of a table changes through it,
+     * forgets the results that depend on that table. Results of queries that read a table modified
+     * by a still open transaction are not remembered until the transaction ends. Before every
+     * lookup the cache also checks `PRAGMA data_version` and `PRAGMA schema_version` of the main
+     * database and forgets everything if they changed, which covers commits made by other
+     * connections and schema changes. It also forgets everything if ::sqlite3_total_changes
+     * grew by more than the update hook reported, which covers changes that do not invoke the
+     * hook, such as the truncate optimization of `DELETE FROM table` or changes to `WITHOUT ROWID`
+     * tables.
+     *
+     * Memory used by remembered results is bounded: when the limit is exceeded the least recently
+     * used results are evicted. Results are returned by `std::shared_ptr` so an evicted result
+     * stays valid as long as the caller holds it.
+     *
+     * The update hook is owned by this object while it exists: do not set it on the same database
+     * yourself. The authorizer is set and cleared while a query is compiled so do not use this
+     * class while you have an authorizer set: it will be removed. Setting the authorizer also
+     * expires the other prepared statements of the connection so that they are recompiled on
+     * their next step. This happens once per SQL text, or again after its compiled statement was
+     * evicted. The database must outlive this object. Like the connection, an instance
+     * is not thread safe.
+     *
+     * Limitations:
+     * - Only use it for deterministic queries: functions such as `random()` or `date('now')`
+     *   are not re-evaluated for remembered results.
+     * - Changes to virtual tables and commits by other connections to attached databases
+     *   may not be detected. Use invalidate() or clear() for those.
+     *
+     * `#include <thinsqlitepp/query_cache.hpp>`
+     *
+     * @since SQLite 3.16
+     */
+    class query_cache
+    {
+    private:
+        struct prepared;
+        //elements of prepared_map
+        using statement_list = std::list<std::pair<const std::string, prepared> *>;
+
+        struct prepared
+        {
+            std::unique_ptr<statement> stmt;
+            //"schema.table" strings or ".table" if schema is unknown
+            std::vector<std::string> tables;
+            //number of remembered results made with this statement
+            size_t users = 0;
+            //value of _clock when the statement or a result made with it was last used
+            uint64_t last_used = 0;
+            //position in _idle if there are no users or in _used otherwise
+            statement_list::iterator position;
+        };
+        using prepared_map = std::unordered_map<std::string, prepared>;
+
+        struct entry
+        {
+            size_t hash;
+            prepared_map::value_type * source;
+            //address of the literal the query was made with, if any
+            const char * literal;
+            std::vector<owned_value> params;
+            std::shared_ptr<const query_result> result;
+            size_t memory_size;
+        };
+        using entry_list = std::list<entry>;
+    public:
+        /// Default maximum number of compiled statements kept without remembered results
+        static constexpr size_t default_max_idle_statements = 16;
+
+        /**
+         * Start caching queries on a database
+         *
+         * @param db Database to run queries on. Must outlive this object
+         * @param max_memory Maximum number of bytes of memory to use for remembered results
+         * @param max_idle_statements Maximum number of compiled statements to keep when no
+         * remembered result was made with them
+         */
+        query_cache(database & db, size_t max_memory, size_t max_idle_statements = default_max_idle_statements);
+        /// Removes the update hook
+        ~query_cache() noexcept;
+
+        query_cache(const query_cache &) = delete;
+        query_cache & operator=(const query_cache &) = delete;
+
+        /**
+         * Run a query or return its remembered result
+         *
+         * @param sql SQL of a single read-only statement
+         * @param args Values to bind to the statement parameters, in order. Anything owned_value
+         * can be constructed from is accepted.
+         * @throws exception with #SQLITE_MISUSE if the statement is not read-only
+         * or any error from compiling or running the statement
+         */
+        template<class... Args>
+        std::shared_ptr<const query_result> query(std::string_view sql, const Args & ... args)
+            { return lookup(sql_text(sql), std::vector<owned_value>{owned_value(args)...}); }
+
+        /**
+         * Run a query or return its remembered result
+         *
+         * Same as query(std::string_view, const Args & ...) but uses the precomputed hash of @p sql.
+         * Remembered results of `_sql` literals are found by comparing the literal address rather 
+         * than the text.
+         */
+        template<class... Args>
+        std::shared_ptr<const query_result> query(const sql_text & sql, const Args & ... args)
+            { return lookup(sql, std::vector<owned_value>{owned_value(args)...}); }
+
+        /**
+         * Forget remembered results that depend on a table
+         *
+         * @param table Name of the table
+         * @param schema Name of the database the table belongs to (`main`, `temp` or attached name)
+         */
+        void invalidate(std::string_view table, std::string_view schema = "main") noexcept;
+
+        /// Forget all remembered results and compiled statements. Statistics are preserved.
+        void clear() noexcept;
+
+        /// Number of remembered results
+        size_t size() const noexcept
+            { return _entries.size(); }
+        /// Number of compiled statements kept
+        size_t statement_count() const noexcept
+            { return _prepared.size(); }
+        /// Approximate number of bytes of memory used by remembered results
+        size_t memory_used() const noexcept
+            { return _memory_used; }
+        /// Maximum number of bytes of memory to use for remembered results
+        size_t max_memory() const noexcept
+            { return _max_memory; }
+        /// Number of queries answered from remembered results
+        uint64_t hits() const noexcept
+            { return _hits; }
+        /// Number of queries that had to run
+        uint64_t misses() const noexcept
+            { return _misses; }
+        /// Reset hit and miss counters
+        void reset_stats() noexcept
+            { _hits = _misses = 0; }
+    private:
+        std::shared_ptr<const query_result> lookup(const sql_text & sql, std::vector<owned_value> params);
+        prepared_map::value_type * prepare(std::string_view sql);
+        void check_versions();
+        void on_update(const char * db_name, const char * table) noexcept;
+        void invalidate_key(const std::string & key) noexcept;
+        void forget_results() noexcept;
+        void remove(entry_list::iterator it) noexcept;
+        void release(prepared & prep) noexcept;
+        void trim_idle(size_t max_count) noexcept;
+
+        static std::string table_key(std::string_view schema, std::string_view table);
+        static void bind_param(statement & stmt, int idx, const owned_value & val);
+    private:
+        database & _db;
+        size_t _max_memory;
+        size_t _max_idle_statements;
+        int64_t _total_changes;
+        //update hook calls since the last check_versions()
+        int64_t _hooked_changes = 0;
+        size_t _memory_used = 0;
+        prepared_map _prepared;
+        statement_list _used;
+        //most recently used first
+        statement_list _idle;
+        uint64_t _clock = 0;
+        entry_list _entries;
+        std::unordered_multimap<size_t, entry_list::iterator> _index;
+        //tables modified by the current transaction
+        std::unordered_set<std::string> _dirty;
+        bool _all_dirty = false;
+        std::unique_ptr<statement> _versions;
+        int64_t _data_version = -1;
+        int64_t _schema_version = -1;
+        uint64_t _hits = 0;
+        uint64_t _misses = 0;
+    };
+
+#endif
+
+    /** @} */
+}
+
+#endif
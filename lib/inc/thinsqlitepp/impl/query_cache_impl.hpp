@@ -0,0 +1,337 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_QUERY_CACHE_IMPL_INCLUDED
+#define HEADER_SQLITEPP_QUERY_CACHE_IMPL_INCLUDED
+
+#include "query_cache_iface.hpp"
+
+#include <algorithm>
+
+namespace thinsqlitepp
+{
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 16, 0)
+
+    //MARK: - query_result
+
+    inline size_t query_result::memory_size() const noexcept
+    {
+        size_t ret = sizeof(*this) + _names.capacity() * sizeof(std::string) + _cells.capacity() * sizeof(owned_value);
+        for (auto & name: _names)
+            ret += name.capacity();
+        for (auto & cell: _cells)
+            ret += cell.heap_size();
+        return ret;
+    }
+
+    //MARK: - query_cache
+
+    inline query_cache::query_cache(database & db, size_t max_memory, size_t max_idle_statements):
+        _db(db),
+        _max_memory(max_memory),
+        _max_idle_statements(max_idle_statements),
+        _total_changes(db.total_changes())
+    {
+        _versions = statement::create(_db, "SELECT data_version, schema_version FROM pragma_data_version, pragma_schema_version");
+        _db.update_hook([](query_cache * me, int /*op*/, const char * db_name, const char * table, sqlite3_int64 /*rowid*/) noexcept {
+            me->on_update(db_name, table);
+        }, this);
+    }
+
+    inline query_cache::~query_cache() noexcept
+    {
+        _db.update_hook(nullptr, nullptr);
+    }
+
+    inline std::shared_ptr<const query_result> query_cache::lookup(const sql_text & sql, std::vector<owned_value> params)
+    {
+        check_versions();
+        if ((!_dirty.empty() || _all_dirty) && _db.get_autocommit())
+        {
+            //the transaction that modified them is over
+            _dirty.clear();
+            _all_dirty = false;
+        }
+
+        size_t hash = sql.hash();
+        for (auto & param: params)
+            hash ^= param.hash() + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+        auto [first, last] = _index.equal_range(hash);
+        for ( ; first != last; ++first)
+        {
+            auto & found = *first->second;
+            const std::string & found_sql = found.source->first;
+            const bool same_sql = (sql.is_literal() && found.literal == sql.data() && found_sql.size() == sql.size()) ||
+                                  found_sql == sql.str();
+            if (same_sql && found.params == params)
+            {
+                if (sql.is_literal())
+                    found.literal = sql.data();
+                ++_hits;
+                found.source->second.last_used = ++_clock;
+                _entries.splice(_entries.begin(), _entries, first->second);
+                return found.result;
+            }
+        }
+
+        ++_misses;
+        auto source = prepare(sql.str());
+        auto & prep = source->second;
+
+        auto result = std::make_shared<query_result>();
+        {
+            auto & stmt = *prep.stmt;
+            auto_reset<auto_reset_flags::all> reset(&stmt);
+            for (size_t i = 0; i < params.size(); ++i)
+                bind_param(stmt, int(i + 1), params[i]);
+            const int count = stmt.column_count();
+            result->_names.reserve(size_t(count));
+            for (int i = 0; i < count; ++i)
+                result->_names.emplace_back(stmt.column_name(i));
+            while (stmt.step())
+            {
+                for (int i = 0; i < count; ++i)
+                    result->_cells.emplace_back(stmt.raw_column_value(i));
+            }
+        }
+
+        //results that may include uncommitted changes cannot be remembered
+        if (_all_dirty || std::any_of(prep.tables.begin(), prep.tables.end(), [this](const std::string & table) {
+            return _dirty.count(table) != 0;
+        }))
+            return result;
+
+        size_t memory_size = sizeof(entry) + result->memory_size() + params.capacity() * sizeof(owned_value);
+        for (auto & param: params)
+            memory_size += param.heap_size();
+        if (memory_size > _max_memory)
+            return result;
+
+        _entries.push_front(entry{hash, source, sql.is_literal() ? sql.data() : nullptr,
+                                 std::move(params), result, memory_size});
+        try
+        {
+            _index.emplace(hash, _entries.begin());
+        }
+        catch(...)
+        {
+            _entries.pop_front();
+            throw;
+        }
+        if (prep.users++ == 0)
+            _used.splice(_used.begin(), _idle, prep.position);
+        _memory_used += memory_size;
+        while (_memory_used > _max_memory)
+            remove(std::prev(_entries.end()));
+        return result;
+    }
+
+    inline auto query_cache::prepare(std::string_view sql) -> prepared_map::value_type *
+    {
+        std::string key(sql);
+        auto it = _prepared.find(key);
+        if (it != _prepared.end())
+        {
+            auto & prep = it->second;
+            prep.last_used = ++_clock;
+            if (!prep.users)
+                _idle.splice(_idle.begin(), _idle, prep.position);
+            return &*it;
+        }
+
+        statement_dependencies deps;
+        auto stmt = create_with_dependencies(_db, key, deps);
+        if (!stmt)
+            throw exception(SQLITE_MISUSE, error::message_ptr("query_cache: SQL contains no statement"));
+        if (!stmt->readonly())
+            throw exception(SQLITE_MISUSE, error::message_ptr("query_cache: only read-only statements can be cached"));
+
+        std::vector<std::string> tables;
+        tables.reserve(deps.reads.size());
+        //tables read without using any columns are reported without schema name
+        for (auto & access: deps.reads)
+            tables.push_back(table_key(access.schema, access.table));
+
+        //make room for the new one
+        trim_idle(_max_idle_statements ? _max_idle_statements - 1 : 0);
+        _idle.emplace_front(nullptr);
+        try
+        {
+            it = _prepared.emplace(std::move(key), prepared{std::move(stmt), std::move(tables), 0, ++_clock, _idle.begin()}).first;
+        }
+        catch(...)
+        {
+            _idle.pop_front();
+            throw;
+        }
+        _idle.front() = &*it;
+        return &*it;
+    }
+
+    inline void query_cache::check_versions()
+    {
+        auto_reset<auto_reset_flags::reset> reset(_versions);
+        _versions->step();
+        auto data_version = _versions->column_value<int64_t>(0);
+        auto schema_version = _versions->column_value<int64_t>(1);
+        //rows changed through this connection without calling the update hook, e.g. by
+        //the truncate optimization or in WITHOUT ROWID tables
+        auto total_changes = _db.total_changes();
+        bool unseen_changes = total_changes - _total_changes > _hooked_changes;
+        _total_changes = total_changes;
+        _hooked_changes = 0;
+        if (schema_version != _schema_version)
+        {
+            //compiled statements may now read different tables
+            clear();
+        }
+        else if (data_version != _data_version || unseen_changes)
+        {
+            forget_results();
+        }
+        if (unseen_changes)
+        {
+            //we do not know which tables changed
+            _all_dirty = true;
+        }
+        _data_version = data_version;
+        _schema_version = schema_version;
+    }
+
+    inline void query_cache::on_update(const char * db_name, const char * table) noexcept
+    {
+        ++_hooked_changes;
+        if (_all_dirty)
+            return;
+        try
+        {
+            auto [it, inserted] = _dirty.insert(table_key(db_name, table));
+            if (inserted)
+            {
+                invalidate_key(*it);
+                auto [any_it, any_inserted] = _dirty.insert(table_key("", table));
+                if (any_inserted)
+                    invalidate_key(*any_it);
+            }
+        }
+        catch(...)
+        {
+            //we cannot track what changed: forget everything until the transaction ends
+            _all_dirty = true;
+            forget_results();
+        }
+    }
+
+    inline void query_cache::invalidate(std::string_view table, std::string_view schema) noexcept
+    {
+        try
+        {
+            invalidate_key(table_key(schema, table));
+            invalidate_key(table_key("", table));
+        }
+        catch(...)
+        {
+            forget_results();
+        }
+    }
+
+    inline void query_cache::clear() noexcept
+    {
+        forget_results();
+        _idle.clear();
+        _prepared.clear();
+    }
+
+    inline void query_cache::forget_results() noexcept
+    {
+        _index.clear();
+        _entries.clear();
+        _memory_used = 0;
+        while (!_used.empty())
+        {
+            auto & prep = _used.front()->second;
+            prep.users = 1;
+            release(prep);
+        }
+    }
+
+    inline void query_cache::invalidate_key(const std::string & key) noexcept
+    {
+        for (auto it = _entries.begin(); it != _entries.end(); )
+        {
+            auto & tables = it->source->second.tables;
+            auto current = it++;
+            if (std::find(tables.begin(), tables.end(), key) != tables.end())
+                remove(current);
+        }
+    }
+
+    inline void query_cache::remove(entry_list::iterator victim) noexcept
+    {
+        auto [first, last] = _index.equal_range(victim->hash);
+        for ( ; first != last; ++first)
+        {
+            if (first->second == victim)
+            {
+                _index.erase(first);
+                break;
+            }
+        }
+        _memory_used -= victim->memory_size;
+        auto & prep = victim->source->second;
+        _entries.erase(victim);
+        release(prep);
+    }
+
+    inline void query_cache::release(prepared & prep) noexcept
+    {
+        if (--prep.users != 0)
+            return;
+        //results are released in no particular order so keep the idle ones ordered by use
+        auto pos = std::find_if(_idle.begin(), _idle.end(), [&](const prepared_map::value_type * item) {
+            return item->second.last_used < prep.last_used;
+        });
+        _idle.splice(pos, _used, prep.position);
+        trim_idle(_max_idle_statements);
+    }
+
+    inline void query_cache::trim_idle(size_t max_count) noexcept
+    {
+        while (_idle.size() > max_count)
+        {
+            auto it = _prepared.find(_idle.back()->first);
+            _idle.pop_back();
+            _prepared.erase(it);
+        }
+    }
+
+    inline std::string query_cache::table_key(std::string_view schema, std::string_view table)
+    {
+        std::string ret;
+        ret.reserve(schema.size() + 1 + table.size());
+        ret.append(schema).append(1, '.').append(table);
+        return ret;
+    }
+
+    inline void query_cache::bind_param(statement & stmt, int idx, const owned_value & val)
+    {
+        switch(val.type())
+        {
+            case SQLITE_INTEGER: stmt.bind(idx, val.get<int64_t>());          break;
+            case SQLITE_FLOAT:   stmt.bind(idx, val.get<double>());           break;
+            case SQLITE_TEXT:    stmt.bind_reference(idx, val.get<std::string_view>()); break;
+            case SQLITE_BLOB:    stmt.bind_reference(idx, val.get<blob_view>());        break;
+            default:             stmt.bind(idx, nullptr);                     break;
+        }
+    }
+
+#endif
+}
+
+#endif
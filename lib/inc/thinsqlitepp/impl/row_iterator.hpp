@@ -10,6 +10,9 @@
 #define HEADER_SQLITEPP_ROW_ITERATOR_INCLUDED
 
 #include "statement_iface.hpp"
+#include "name_index.hpp"
+
+#include <memory>
 
 namespace thinsqlitepp
 {
@@ -127,6 +130,48 @@ namespace thinsqlitepp
         int _idx;
     };
 
+    /** @cond PRIVATE */
+
+    /**
+     * Hashed column names of a statement
+     * 
+     * Rebuilt whenever SQLite re-prepares the statement since column names can change then
+     */
+    class column_names
+    {
+    public:
+        void reset() noexcept
+        {
+            _owner = nullptr;
+            _index.clear();
+        }
+
+        int find(const statement * owner, std::string_view name)
+        {
+        #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+            int version = sqlite3_stmt_status(owner->c_ptr(), SQLITE_STMTSTATUS_REPREPARE, 0);
+        #else
+            int version = owner->column_count();
+        #endif
+            if (_index.empty() || owner != _owner || version != _version)
+            {
+                _owner = nullptr;
+                _index.assign(0, owner->column_count(), [owner](int idx) {
+                    return owner->column_name(idx);
+                });
+                _owner = owner;
+                _version = version;
+            }
+            return _index.find(name);
+        }
+    private:
+        name_index _index;
+        const statement * _owner = nullptr;
+        int _version = 0;
+    };
+
+    /** @endcond */
+
     /**
      * Row result of a @ref statement
      * 
@@ -136,6 +181,18 @@ namespace thinsqlitepp
      * @ref statement result and changes every time the statement makes 
      * a statement::step.
      * 
+     * Cells can also be accessed by column name. For rows produced by a @ref row_iterator
+     * the names are hashed on first such access and the table is kept by the iterator so
+     * subsequent lookups cost about the same as access by index. A row constructed directly
+     * searches the column names on every lookup. A row produced by a @ref row_iterator must
+     * not be accessed by name after the iterator is destroyed or assigned to.
+     * ```
+     * for (auto row: row_range(stmt)) {
+     *     auto name = row["name"].value<std::string_view>();
+     *     ...
+     * }
+     * ```
+     * 
      * `#include <thinsqlitepp/statement.hpp>`
      * 
      */
@@ -235,6 +292,38 @@ namespace thinsqlitepp
         
         cell operator[](int idx) const noexcept
             { return cell(_owner, idx); }
+
+        /**
+         * Access a cell by column name
+         * 
+         * If there are multiple columns with the same name the first one is returned. 
+         * If there is no such column the returned cell refers to an invalid index and 
+         * behaves the same as for an out of range index.
+         * 
+         * @see index_of
+         */
+        cell operator[](std::string_view name) const
+            { return cell(_owner, index_of(name)); }
+
+        /**
+         * Index of a column with a given name
+         * 
+         * The comparison is case sensitive and uses the names returned by statement::column_name.
+         * The names are recomputed if SQLite re-prepares the statement.
+         * 
+         * @returns Column index or -1 if there is no such column
+         */
+        int index_of(std::string_view name) const
+        {
+            if (_columns)
+                return _columns->find(_owner, name);
+            for (int i = 0, count = _owner->column_count(); i < count; ++i)
+            {
+                if (const char * col = _owner->column_name(i); col && name == col)
+                    return i;
+            }
+            return -1;
+        }
         
         const_iterator begin() const noexcept
             { return const_iterator(_owner, 0); }
@@ -253,8 +342,14 @@ namespace thinsqlitepp
             { return const_reverse_iterator(begin()); }
         const_reverse_iterator crend() const noexcept
             { return const_reverse_iterator(begin()); }
+    protected:
+        row(const statement * owner, column_names * columns) noexcept:
+            _owner(owner),
+            _columns(columns)
+        {}
     protected:
         const statement * _owner;
+        column_names * _columns = nullptr;
     };
 
     /**
@@ -283,7 +378,7 @@ namespace thinsqlitepp
          * Such iterator is usable as an end of range sentinel
          */
         row_iterator() noexcept:
-            row(nullptr)
+            row(nullptr, &_column_names)
         {}
         /**
          * Create an instance referring to a given statement
@@ -292,7 +387,7 @@ namespace thinsqlitepp
          * hence the argument must be non-const.
          */
         row_iterator(statement * owner):
-            row(owner)
+            row(owner, &_column_names)
         {
             if (_owner)
                 increment();
@@ -303,6 +398,17 @@ namespace thinsqlitepp
             row_iterator(owner.get())
         {}
 
+        /// Copies do not share the table of column names with the original
+        row_iterator(const row_iterator & src) noexcept:
+            row(src._owner, &_column_names)
+        {}
+        row_iterator & operator=(const row_iterator & src) noexcept
+        {
+            _owner = src._owner;
+            _column_names.reset();
+            return *this;
+        }
+
         row operator*() const noexcept
             { return *this; }
         
@@ -324,6 +430,8 @@ namespace thinsqlitepp
             if (!const_cast<statement *>(_owner)->step())
                 _owner = nullptr;
         }
+    private:
+        column_names _column_names;
     };
 
     /**
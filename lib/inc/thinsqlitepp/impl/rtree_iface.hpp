@@ -0,0 +1,274 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_RTREE_IFACE_INCLUDED
+#define HEADER_SQLITEPP_RTREE_IFACE_INCLUDED
+
+#include "database_iface.hpp"
+#include "value_iface.hpp"
+#include "exception_iface.hpp"
+#include "typed_function_iface.hpp"
+#include "span.hpp"
+
+namespace thinsqlitepp
+{
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 8, 5)
+
+    /**
+     * @addtogroup SQL SQLite API Wrappers
+     * @{
+     */
+
+    /**
+     * R-Tree query callback information
+     *
+     * This is a [fake wrapper class](https://github.com/gershnik/thinsqlitepp#fake-classes) for
+     * sqlite3_rtree_query_info.
+     *
+     * An object of this class is passed to callbacks registered with create_rtree_query_callback() for
+     * every R-Tree node and leaf entry the search considers. The callback inspects the bounding box
+     * in coordinates() and reports how it relates to the query region via set_within(). Reporting
+     * `NOT_WITHIN` for an internal node prunes the whole subtree below it.
+     *
+     * `#include <thinsqlitepp/rtree.hpp>`
+     *
+     * @since SQLite 3.8.5
+     */
+    class rtree_query_info final : public handle<sqlite3_rtree_query_info, rtree_query_info>
+    {
+    public:
+        /// Query information objects are never destroyed by user code
+        ~rtree_query_info() noexcept = delete;
+
+        /// Parameters passed to the SQL function in the `MATCH` clause
+        span<const sqlite3_rtree_dbl> parameters() const noexcept
+            { return {c_ptr()->aParam, size_t(c_ptr()->nParam)}; }
+
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 8, 11)
+        /**
+         * Original SQL value of a parameter
+         *
+         * @since SQLite 3.8.11
+         */
+        const value * sql_parameter(int idx) const noexcept
+            { return value::from(c_ptr()->apSqlParam[idx]); }
+    #endif
+
+        /**
+         * Bounding box of the node or entry being checked
+         *
+         * The coordinates come in (min, max) pairs, one pair per dimension, in the order of
+         * the R-Tree columns.
+         */
+        span<const sqlite3_rtree_dbl> coordinates() const noexcept
+            { return {c_ptr()->aCoord, size_t(c_ptr()->nCoord)}; }
+
+        /// Level of the node being checked. Leaf entries are on level 0.
+        int level() const noexcept
+            { return c_ptr()->iLevel; }
+
+        /// Largest level in the tree, i.e. the level of the root node
+        int max_level() const noexcept
+            { return c_ptr()->mxLevel; }
+
+        /// Whether a leaf entry, rather than an internal node, is being checked
+        bool is_leaf() const noexcept
+            { return c_ptr()->iLevel == 0; }
+
+        /// Rowid of the leaf entry being checked. Only meaningful if is_leaf() is true
+        int64_t rowid() const noexcept
+            { return c_ptr()->iRowid; }
+
+        /// Number of entries pending in the search queue on a given level
+        unsigned queue_size(int level) const noexcept
+            { return c_ptr()->anQueue[level]; }
+
+        /// Visibility of the parent node. One of `NOT_WITHIN`, `PARTLY_WITHIN` or `FULLY_WITHIN`
+        int parent_within() const noexcept
+            { return c_ptr()->eParentWithin; }
+
+        /// Score of the parent node
+        sqlite3_rtree_dbl parent_score() const noexcept
+            { return c_ptr()->rParentScore; }
+
+        /// Current visibility. Initially the same as parent_within()
+        int within() const noexcept
+            { return c_ptr()->eWithin; }
+
+        /**
+         * Report visibility of the node or entry being checked
+         *
+         * @param val One of `NOT_WITHIN`, `PARTLY_WITHIN` or `FULLY_WITHIN`. For leaf entries anything
+         * other than `NOT_WITHIN` makes the entry part of the result.
+         */
+        void set_within(int val) noexcept
+            { c_ptr()->eWithin = val; }
+
+        /// Current score. Initially the same as parent_score()
+        sqlite3_rtree_dbl score() const noexcept
+            { return c_ptr()->rScore; }
+
+        /// Set the score. Entries with lower scores are returned first.
+        void set_score(sqlite3_rtree_dbl val) noexcept
+            { c_ptr()->rScore = val; }
+
+        /// Per-query user data set via set_user_data() or nullptr
+        void * user_data() const noexcept
+            { return c_ptr()->pUser; }
+
+        /**
+         * Set per-query user data
+         *
+         * The data persists for the duration of the query (e.g. to cache parsed parameters) and
+         * @p destructor, if not null, is called when the query ends.
+         */
+        void set_user_data(void * data, void (*destructor)(void *)) noexcept
+        {
+            if (auto old_destructor = c_ptr()->xDelUser)
+                old_destructor(c_ptr()->pUser);
+            c_ptr()->pUser = data;
+            c_ptr()->xDelUser = destructor;
+        }
+    };
+
+    /**
+     * R-Tree geometry callback information
+     *
+     * This is a [fake wrapper class](https://github.com/gershnik/thinsqlitepp#fake-classes) for
+     * sqlite3_rtree_geometry.
+     *
+     * `#include <thinsqlitepp/rtree.hpp>`
+     */
+    class rtree_geometry final : public handle<sqlite3_rtree_geometry, rtree_geometry>
+    {
+    public:
+        /// Geometry objects are never destroyed by user code
+        ~rtree_geometry() noexcept = delete;
+
+        /// Parameters passed to the SQL function in the `MATCH` clause
+        span<const sqlite3_rtree_dbl> parameters() const noexcept
+            { return {c_ptr()->aParam, size_t(c_ptr()->nParam)}; }
+
+        /// Per-query user data or nullptr
+        void * user_data() const noexcept
+            { return c_ptr()->pUser; }
+    };
+
+    /** @} */
+
+    /** @cond PRIVATE */
+
+    template<class F>
+    constexpr bool is_rtree_query_callback = std::is_nothrow_invocable_v<typed_function_target<std::decay_t<F>> &, rtree_query_info &>;
+
+    template<class T>
+    constexpr bool is_pointer_to_rtree_geometry_callback = std::is_pointer_v<T> &&
+        std::is_nothrow_invocable_r_v<bool, std::remove_pointer_t<T> &, const rtree_geometry &, span<const sqlite3_rtree_dbl>>;
+
+    /** @endcond */
+
+    /**
+     * @addtogroup SQL SQLite API Wrappers
+     * @{
+     */
+
+    /**
+     * Register an R-Tree query callback
+     *
+     * Wraps ::sqlite3_rtree_query_callback
+     *
+     * The callback is used as `SELECT ... FROM rtree WHERE id MATCH name(params...)` and must be
+     * callable as
+     * ```
+     * void (rtree_query_info & info) noexcept;
+     * //or
+     * int (rtree_query_info & info) noexcept; //returns an SQLite error code
+     * ```
+     * It is invoked for each internal node and leaf entry the search reaches and should call
+     * rtree_query_info::set_within(). See rtree_circle and rtree_polygon for examples.
+     *
+     * As with @ref database_create_function "create_function" the callback must be `noexcept`.
+     *
+     * @param db database to register the callback with
+     * @param name name of the SQL function to use in `MATCH`
+     * @param callback Either a callable object or a function pointer, in which case it is copied and the copy
+     * is destroyed when the function is removed; or a **pointer** to such callable object which is used by
+     * reference and must outlive the registration.
+     *
+     * @since SQLite 3.8.5
+     */
+    template<class F>
+    SQLITEPP_ENABLE_IF(is_rtree_query_callback<F>,
+    void) create_rtree_query_callback(database & db, const char * name, F callback);
+
+    /**
+     * Register a legacy R-Tree geometry callback
+     *
+     * Wraps ::sqlite3_rtree_geometry_callback
+     *
+     * The callback is used as `SELECT ... FROM rtree WHERE id MATCH name(params...)` and must be
+     * callable as
+     * ```
+     * bool (const rtree_geometry & geom, span<const sqlite3_rtree_dbl> coords) noexcept;
+     * ```
+     * returning whether the bounding box in `coords` overlaps the region. Returning false for an internal
+     * node prunes the subtree below it. New code should prefer create_rtree_query_callback().
+     *
+     * SQLite never releases geometry callback data so this function only accepts a **pointer** to
+     * a callable object which must outlive the database connection.
+     */
+    template<class T>
+    SQLITEPP_ENABLE_IF(is_pointer_to_rtree_geometry_callback<T>,
+    void) create_rtree_geometry_callback(database & db, const char * name, T callback_ptr);
+
+    /**
+     * R-Tree query callback that matches a circle
+     *
+     * Register it with create_rtree_query_callback() and use as
+     * ```
+     * db->exec("SELECT id FROM places WHERE id MATCH circle(x, y, radius)");
+     * ```
+     * The first two dimensions of the R-Tree are treated as X and Y. Internal nodes that do not reach
+     * the circle are pruned and nodes entirely inside it are accepted without checking their entries
+     * further. Entries whose bounding box overlaps the circle match.
+     *
+     * `#include <thinsqlitepp/rtree.hpp>`
+     */
+    class rtree_circle
+    {
+    public:
+        int operator()(rtree_query_info & info) const noexcept;
+    };
+
+    /**
+     * R-Tree query callback that matches a polygon
+     *
+     * Register it with create_rtree_query_callback() and use as
+     * ```
+     * db->exec("SELECT id FROM places WHERE id MATCH polygon(x0, y0, x1, y1, x2, y2, ...)");
+     * ```
+     * The parameters are the vertices of a simple polygon (at least 3). The first two dimensions
+     * of the R-Tree are treated as X and Y. Internal nodes that do not reach the polygon are pruned
+     * and nodes entirely inside it are accepted without checking their entries further. Entries whose
+     * bounding box overlaps the polygon, including its boundary, match.
+     *
+     * `#include <thinsqlitepp/rtree.hpp>`
+     */
+    class rtree_polygon
+    {
+    public:
+        int operator()(rtree_query_info & info) const noexcept;
+    };
+
+    /** @} */
+
+#endif
+}
+
+#endif
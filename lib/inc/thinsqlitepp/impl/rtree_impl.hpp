@@ -0,0 +1,209 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_RTREE_IMPL_INCLUDED
+#define HEADER_SQLITEPP_RTREE_IMPL_INCLUDED
+
+#include "rtree_iface.hpp"
+
+#include <algorithm>
+
+namespace thinsqlitepp
+{
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 8, 5)
+
+    /** @cond PRIVATE */
+
+    template<class F>
+    struct rtree_query_function
+    {
+        using target = typed_function_target<F>;
+
+        static int call(sqlite3_rtree_query_info * info) noexcept
+        {
+            target & func = *static_cast<target *>(info->pContext);
+            auto & wrapped = *rtree_query_info::from(info);
+            if constexpr (std::is_void_v<std::invoke_result_t<target &, rtree_query_info &>>)
+            {
+                func(wrapped);
+                return SQLITE_OK;
+            }
+            else
+            {
+                return int(func(wrapped));
+            }
+        }
+    };
+
+    template<class T>
+    struct rtree_geometry_function
+    {
+        static int call(sqlite3_rtree_geometry * geom, int count, sqlite3_rtree_dbl * coords, int * res) noexcept
+        {
+            auto & func = *static_cast<std::remove_pointer_t<T> *>(geom->pContext);
+            *res = func(*rtree_geometry::from(geom), span<const sqlite3_rtree_dbl>(coords, size_t(count)));
+            return SQLITE_OK;
+        }
+    };
+
+    //axis-aligned box formed by the first two dimensions of an R-Tree entry
+    struct rtree_box
+    {
+        double x0, x1, y0, y1;
+
+        static bool from(const rtree_query_info & info, rtree_box & box) noexcept
+        {
+            auto coords = info.coordinates();
+            if (coords.size() < 4)
+                return false;
+            box = {double(coords[0]), double(coords[1]), double(coords[2]), double(coords[3])};
+            return true;
+        }
+
+        //Liang-Barsky clipping of segment (ax, ay) - (bx, by) against the box
+        bool intersects(double ax, double ay, double bx, double by) const noexcept
+        {
+            double t0 = 0, t1 = 1;
+            auto clip = [&](double p, double q) {
+                if (p == 0)
+                    return q >= 0;
+                const double r = q / p;
+                if (p < 0)
+                {
+                    if (r > t1)
+                        return false;
+                    t0 = std::max(t0, r);
+                }
+                else
+                {
+                    if (r < t0)
+                        return false;
+                    t1 = std::min(t1, r);
+                }
+                return true;
+            };
+            const double dx = bx - ax, dy = by - ay;
+            return clip(-dx, ax - x0) && clip(dx, x1 - ax) && clip(-dy, ay - y0) && clip(dy, y1 - ay);
+        }
+    };
+
+    /** @endcond */
+
+    template<class F>
+    SQLITEPP_ENABLE_IF(is_rtree_query_callback<F>,
+    void) create_rtree_query_callback(database & db, const char * name, F callback)
+    {
+        using handler_t = rtree_query_function<F>;
+        using target_t = typename handler_t::target;
+
+        int res;
+        if constexpr (!std::is_same_v<target_t, F>)
+        {
+            res = sqlite3_rtree_query_callback(db.c_ptr(), name, &handler_t::call,
+                                               const_cast<std::remove_const_t<target_t> *>(callback), nullptr);
+        }
+        else
+        {
+            //on failure SQLite calls the destructor itself
+            res = sqlite3_rtree_query_callback(db.c_ptr(), name, &handler_t::call,
+                                               new F(std::move(callback)),
+                                               [](void * p) { delete static_cast<F *>(p); });
+        }
+        if (res != SQLITE_OK)
+            throw exception(res, db);
+    }
+
+    template<class T>
+    SQLITEPP_ENABLE_IF(is_pointer_to_rtree_geometry_callback<T>,
+    void) create_rtree_geometry_callback(database & db, const char * name, T callback_ptr)
+    {
+        int res = sqlite3_rtree_geometry_callback(db.c_ptr(), name, &rtree_geometry_function<T>::call,
+                                                  const_cast<std::remove_const_t<std::remove_pointer_t<T>> *>(callback_ptr));
+        if (res != SQLITE_OK)
+            throw exception(res, db);
+    }
+
+    //MARK: - rtree_circle
+
+    inline int rtree_circle::operator()(rtree_query_info & info) const noexcept
+    {
+        auto params = info.parameters();
+        rtree_box box;
+        if (params.size() != 3 || !rtree_box::from(info, box))
+            return SQLITE_ERROR;
+
+        //everything below a node inside the circle is inside too
+        if (info.parent_within() == FULLY_WITHIN)
+            return SQLITE_OK;
+
+        const double cx = double(params[0]), cy = double(params[1]), r = double(params[2]);
+        const double r2 = r * r;
+
+        const double near_x = std::max({box.x0 - cx, cx - box.x1, 0.});
+        const double near_y = std::max({box.y0 - cy, cy - box.y1, 0.});
+        if (near_x * near_x + near_y * near_y > r2)
+        {
+            info.set_within(NOT_WITHIN);
+            return SQLITE_OK;
+        }
+
+        const double far_x = std::max(cx - box.x0, box.x1 - cx);
+        const double far_y = std::max(cy - box.y0, box.y1 - cy);
+        info.set_within(far_x * far_x + far_y * far_y <= r2 ? FULLY_WITHIN : PARTLY_WITHIN);
+        return SQLITE_OK;
+    }
+
+    //MARK: - rtree_polygon
+
+    inline int rtree_polygon::operator()(rtree_query_info & info) const noexcept
+    {
+        auto params = info.parameters();
+        rtree_box box;
+        if (params.size() < 6 || params.size() % 2 != 0 || !rtree_box::from(info, box))
+            return SQLITE_ERROR;
+
+        if (info.parent_within() == FULLY_WITHIN)
+            return SQLITE_OK;
+
+        const size_t count = params.size() / 2;
+        auto x = [&](size_t i) { return double(params[2 * (i % count)]); };
+        auto y = [&](size_t i) { return double(params[2 * (i % count) + 1]); };
+
+        //even-odd rule
+        auto contains = [&](double px, double py) {
+            bool inside = false;
+            for (size_t i = 0, j = count - 1; i < count; j = i++)
+            {
+                if ((y(i) > py) != (y(j) > py) &&
+                    px < (x(j) - x(i)) * (py - y(i)) / (y(j) - y(i)) + x(i))
+                    inside = !inside;
+            }
+            return inside;
+        };
+
+        bool edge_hits_box = false;
+        for (size_t i = 0; i < count && !edge_hits_box; ++i)
+            edge_hits_box = box.intersects(x(i), y(i), x(i + 1), y(i + 1));
+
+        const int corners_inside = int(contains(box.x0, box.y0)) + int(contains(box.x1, box.y0)) +
+                                   int(contains(box.x0, box.y1)) + int(contains(box.x1, box.y1));
+
+        if (corners_inside == 4 && !edge_hits_box)
+            info.set_within(FULLY_WITHIN);
+        else if (corners_inside > 0 || edge_hits_box)
+            info.set_within(PARTLY_WITHIN);
+        else
+            info.set_within(NOT_WITHIN);
+        return SQLITE_OK;
+    }
+
+#endif
+}
+
+#endif
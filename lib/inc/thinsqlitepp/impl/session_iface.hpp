@@ -0,0 +1,753 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_SESSION_IFACE_INCLUDED
+#define HEADER_SQLITEPP_SESSION_IFACE_INCLUDED
+
+#include "handle.hpp"
+#include "database_iface.hpp"
+#include "exception_iface.hpp"
+#include "memory_iface.hpp"
+#include "span.hpp"
+#include "meta.hpp"
+
+#include <exception>
+
+namespace thinsqlitepp
+{
+#if defined(SQLITE_ENABLE_SESSION) && defined(SQLITE_ENABLE_PREUPDATE_HOOK) && \
+    SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 13, 0)
+
+    class changeset_iterator;
+
+    /** @cond PRIVATE */
+
+    struct session_detector
+    {
+        template<class T>
+        static constexpr bool is_pointer_to_input = std::is_pointer_v<T> &&
+            std::is_invocable_r_v<size_t, std::remove_pointer_t<T>, span<std::byte>>;
+
+        template<class T>
+        static constexpr bool is_pointer_to_output = std::is_pointer_v<T> &&
+            std::is_invocable_r_v<void, std::remove_pointer_t<T>, span<const std::byte>>;
+
+        template<class T>
+        static constexpr bool is_pointer_to_filter = std::is_null_pointer_v<T> ||
+            (std::is_pointer_v<T> && std::is_nothrow_invocable_r_v<bool, std::remove_pointer_t<T>, const char *>);
+
+        template<class T>
+        static constexpr bool is_pointer_to_conflict_handler = std::is_pointer_v<T> &&
+            std::is_nothrow_invocable_r_v<int, std::remove_pointer_t<T>, int, changeset_iterator *>;
+    };
+
+    //Adapts C++ streaming callables to SQLite xInput/xOutput and carries any exception
+    //they throw across SQLite back to the caller
+    template<class T>
+    class stream_adapter
+    {
+    public:
+        stream_adapter(T handler) noexcept: _handler(handler)
+        {}
+
+        static int input(void * me, void * data, int * size) noexcept
+        {
+            auto self = static_cast<stream_adapter *>(me);
+            try
+            {
+                *size = int((*self->_handler)(span<std::byte>(static_cast<std::byte *>(data), size_t(*size))));
+                return SQLITE_OK;
+            }
+            catch(...)
+            {
+                return self->store_current();
+            }
+        }
+
+        static int output(void * me, const void * data, int size) noexcept
+        {
+            auto self = static_cast<stream_adapter *>(me);
+            try
+            {
+                (*self->_handler)(span<const std::byte>(static_cast<const std::byte *>(data), size_t(size)));
+                return SQLITE_OK;
+            }
+            catch(...)
+            {
+                return self->store_current();
+            }
+        }
+
+        void rethrow_if_failed() const
+        {
+            if (_error)
+                std::rethrow_exception(_error);
+        }
+    private:
+        int store_current() noexcept
+        {
+            _error = std::current_exception();
+            try
+            {
+                throw;
+            }
+            catch(exception & ex)
+            {
+                return ex.extended_error_code();
+            }
+            catch(std::bad_alloc &)
+            {
+                return SQLITE_NOMEM;
+            }
+            catch(...)
+            {
+                return SQLITE_ERROR;
+            }
+        }
+    private:
+        T _handler;
+        std::exception_ptr _error;
+    };
+
+    /** @endcond */
+
+    /**
+     * @addtogroup SQL SQLite API Wrappers
+     * @{
+     */
+
+    /**
+     * A changeset or patchset held in memory
+     *
+     * This class owns a buffer allocated by SQLite that contains a changeset or a patchset
+     * produced by session::changeset(), session::patchset(), changegroup::output() and similar.
+     * It also provides static methods that operate on changesets, either
+     * in memory (via blob_view) or in a streaming fashion via callbacks.
+     *
+     * Streaming methods accept **pointers** to input and output callables.
+     * An input callable must be invocable as
+     * ```
+     * size_t (*input_ptr)(span<std::byte> buffer);
+     * ```
+     * It must fill the buffer with up to `buffer.size()` next bytes of the input and return the
+     * number of bytes written. Returning 0 indicates the end of input.
+     * An output callable must be invocable as
+     * ```
+     * void (*output_ptr)(span<const std::byte> data);
+     * ```
+     * and consume the next chunk of output.
+     * Both can throw exceptions. An exception thrown from a callback aborts the operation and is
+     * re-thrown from the method that invoked it.
+     *
+     * Available only if #SQLITE_ENABLE_SESSION and #SQLITE_ENABLE_PREUPDATE_HOOK
+     * are defined during compilation
+     *
+     * `#include <thinsqlitepp/session.hpp>`
+     *
+     * @since SQLite 3.13
+     */
+    class changeset
+    {
+    public:
+        /// Constructs an empty changeset
+        changeset() noexcept = default;
+
+        /// Constructs a changeset from a buffer allocated by SQLite
+        changeset(allocated_bytes && data, size_t size) noexcept:
+            _data(std::move(data)),
+            _size(size)
+        {}
+
+        /// Changeset bytes
+        blob_view data() const noexcept
+            { return blob_view(_data.get(), _size); }
+
+        /// @overload
+        operator blob_view() const noexcept
+            { return data(); }
+
+        /// Size of the changeset in bytes
+        size_t size() const noexcept
+            { return _size; }
+
+        /// Whether there is no data
+        bool empty() const noexcept
+            { return _size == 0; }
+
+        /**
+         * Invert a changeset
+         *
+         * Equivalent to ::sqlite3changeset_invert
+         */
+        static changeset invert(const blob_view & changes);
+
+        /**
+         * Concatenate two changesets
+         *
+         * Equivalent to ::sqlite3changeset_concat
+         */
+        static changeset concat(const blob_view & lhs, const blob_view & rhs);
+
+        /**
+         * Apply a changeset to a database
+         *
+         * Equivalent to ::sqlite3changeset_apply or ::sqlite3changeset_apply_v2
+         *
+         * @param db Database to apply the changes to
+         * @param changes Changeset to apply
+         * @param conflict_ptr A **pointer** to any C++ callable that can be invoked as
+         * ```
+         * int (*conflict_ptr)(int conflict_type, changeset_iterator * iterator) noexcept;
+         * ```
+         * where `conflict_type` is one of `SQLITE_CHANGESET_DATA`, `SQLITE_CHANGESET_NOTFOUND`,
+         * `SQLITE_CHANGESET_CONFLICT`, `SQLITE_CHANGESET_CONSTRAINT` or `SQLITE_CHANGESET_FOREIGN_KEY`
+         * and the return value is one of `SQLITE_CHANGESET_OMIT`, `SQLITE_CHANGESET_REPLACE` or
+         * `SQLITE_CHANGESET_ABORT`. The iterator is positioned on the conflicting change.
+         * @param filter_ptr A **pointer** to any C++ callable that can be invoked as
+         * ```
+         * bool (*filter_ptr)(const char * table) noexcept;
+         * ```
+         * It should return `false` to skip changes to a given table. Can be nullptr.
+         * @param flags A combination of `SQLITE_CHANGESETAPPLY_` flags. Ignored prior to SQLite 3.22
+         */
+        template<class Conflict, class Filter = std::nullptr_t>
+        static
+        SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_conflict_handler<Conflict> &&
+                           session_detector::is_pointer_to_filter<Filter>,
+        void) apply(database & db, const blob_view & changes, Conflict conflict_ptr, Filter filter_ptr = nullptr, int flags = 0);
+
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 14, 0)
+
+        /**
+         * Invert a changeset read from a stream
+         *
+         * Equivalent to ::sqlite3changeset_invert_strm
+         *
+         * @since SQLite 3.14
+         */
+        template<class In, class Out>
+        static
+        SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_input<In> && session_detector::is_pointer_to_output<Out>,
+        void) invert(In input_ptr, Out output_ptr);
+
+        /**
+         * Concatenate two changesets read from streams
+         *
+         * Equivalent to ::sqlite3changeset_concat_strm
+         *
+         * @since SQLite 3.14
+         */
+        template<class InLhs, class InRhs, class Out>
+        static
+        SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_input<InLhs> && session_detector::is_pointer_to_input<InRhs> &&
+                           session_detector::is_pointer_to_output<Out>,
+        void) concat(InLhs lhs_input_ptr, InRhs rhs_input_ptr, Out output_ptr);
+
+        /**
+         * Apply a changeset read from a stream to a database
+         *
+         * Equivalent to ::sqlite3changeset_apply_strm or ::sqlite3changeset_apply_v2_strm
+         *
+         * See apply(database &, const blob_view &, Conflict, Filter, int) for description
+         * of the other parameters.
+         *
+         * @since SQLite 3.14
+         */
+        template<class In, class Conflict, class Filter = std::nullptr_t>
+        static
+        SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_input<In> &&
+                           session_detector::is_pointer_to_conflict_handler<Conflict> &&
+                           session_detector::is_pointer_to_filter<Filter>,
+        void) apply(database & db, In input_ptr, Conflict conflict_ptr, Filter filter_ptr = nullptr, int flags = 0);
+
+    #endif
+
+    private:
+        template<class Conflict, class Filter>
+        struct apply_context
+        {
+            Conflict conflict;
+            Filter filter;
+
+            static int call_filter(void * me, const char * table) noexcept;
+            static int call_conflict(void * me, int type, sqlite3_changeset_iter * iter) noexcept;
+        };
+
+        static changeset check_output(int res, int size, void * data)
+        {
+            allocated_bytes ret(static_cast<std::byte *>(data));
+            if (res != SQLITE_OK)
+                throw exception(res);
+            return changeset(std::move(ret), size_t(size));
+        }
+
+        friend class session;
+        friend class changegroup;
+    private:
+        allocated_bytes _data;
+        size_t _size = 0;
+    };
+
+    /**
+     * Changeset iterator
+     *
+     * This is a [fake wrapper class](https://github.com/gershnik/thinsqlitepp#fake-classes) for
+     * sqlite3_changeset_iter.
+     *
+     * Iterators created via start() are owned by the caller. Iterators passed to conflict handlers
+     * of changeset::apply() are owned by SQLite and must not be deleted.
+     *
+     * Available only if #SQLITE_ENABLE_SESSION and #SQLITE_ENABLE_PREUPDATE_HOOK
+     * are defined during compilation
+     *
+     * `#include <thinsqlitepp/session.hpp>`
+     *
+     * @since SQLite 3.13
+     */
+    class changeset_iterator final : public handle<sqlite3_changeset_iter, changeset_iterator>
+    {
+    public:
+        /// Description of the current change
+        struct operation
+        {
+            const char * table;     ///< Name of the table
+            int column_count;       ///< Number of columns in the table
+            int code;               ///< `SQLITE_INSERT`, `SQLITE_DELETE` or `SQLITE_UPDATE`
+            bool indirect;          ///< Whether the change is indirect
+        };
+    public:
+        /**
+         * Create an iterator over a changeset in memory
+         *
+         * Equivalent to ::sqlite3changeset_start or ::sqlite3changeset_start_v2
+         *
+         * The changeset memory must remain valid as long as the iterator exists.
+         *
+         * @param changes Changeset to iterate
+         * @param flags A combination of `SQLITE_CHANGESETSTART_` flags. Ignored prior to SQLite 3.26
+         */
+        static std::unique_ptr<changeset_iterator> start(const blob_view & changes, int flags = 0);
+
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 14, 0)
+        /**
+         * Create an iterator over a changeset read from a stream
+         *
+         * Equivalent to ::sqlite3changeset_start_strm or ::sqlite3changeset_start_v2_strm
+         *
+         * @param input_ptr A **pointer** to input callable. See @ref changeset for details.
+         * The callable object must exist as long as the iterator exists. Exceptions it throws
+         * are reported as SQLite errors from next().
+         * @param flags A combination of `SQLITE_CHANGESETSTART_` flags. Ignored prior to SQLite 3.26
+         *
+         * @since SQLite 3.14
+         */
+        template<class In>
+        static
+        SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_input<In>,
+        std::unique_ptr<changeset_iterator>) start(In input_ptr, int flags = 0);
+    #endif
+
+        /// Equivalent to ::sqlite3changeset_finalize
+        ~changeset_iterator() noexcept
+            { sqlite3changeset_finalize(c_ptr()); }
+
+        /**
+         * Advance to the next change
+         *
+         * Equivalent to ::sqlite3changeset_next
+         *
+         * @returns `true` if positioned on a change, `false` at the end
+         */
+        bool next()
+        {
+            int res = sqlite3changeset_next(c_ptr());
+            if (res == SQLITE_ROW)
+                return true;
+            if (res == SQLITE_DONE)
+                return false;
+            throw exception(res);
+        }
+
+        /**
+         * Describe the current change
+         *
+         * Equivalent to ::sqlite3changeset_op
+         */
+        operation op() const
+        {
+            operation ret;
+            int indirect;
+            check_error(sqlite3changeset_op(c_ptr(), &ret.table, &ret.column_count, &ret.code, &indirect));
+            ret.indirect = indirect;
+            return ret;
+        }
+
+        /**
+         * Primary key flags for the columns of the current change's table
+         *
+         * Equivalent to ::sqlite3changeset_pk
+         */
+        span<const unsigned char> primary_key() const
+        {
+            unsigned char * flags;
+            int count;
+            check_error(sqlite3changeset_pk(c_ptr(), &flags, &count));
+            return span<const unsigned char>(flags, size_t(count));
+        }
+
+        /**
+         * Old value of a column for UPDATE and DELETE changes
+         *
+         * Equivalent to ::sqlite3changeset_old
+         *
+         * @returns The value or nullptr if it is not part of the change
+         */
+        value * old_value(int column_idx) const
+            { return get_value(sqlite3changeset_old, column_idx); }
+
+        /**
+         * New value of a column for UPDATE and INSERT changes
+         *
+         * Equivalent to ::sqlite3changeset_new
+         *
+         * @returns The value or nullptr if it is not part of the change
+         */
+        value * new_value(int column_idx) const
+            { return get_value(sqlite3changeset_new, column_idx); }
+
+        /**
+         * Value of a column in the conflicting row
+         *
+         * Equivalent to ::sqlite3changeset_conflict
+         *
+         * Can only be used within a conflict handler for `SQLITE_CHANGESET_DATA` or
+         * `SQLITE_CHANGESET_CONFLICT` conflicts.
+         */
+        value * conflict_value(int column_idx) const
+            { return get_value(sqlite3changeset_conflict, column_idx); }
+
+        /**
+         * Number of foreign key violations
+         *
+         * Equivalent to ::sqlite3changeset_fk_conflicts
+         *
+         * Can only be used within a conflict handler for `SQLITE_CHANGESET_FOREIGN_KEY` conflict.
+         */
+        int foreign_key_conflicts() const
+        {
+            int ret;
+            check_error(sqlite3changeset_fk_conflicts(c_ptr(), &ret));
+            return ret;
+        }
+
+    private:
+        template<class In>
+        static int input(void * input_ptr, void * data, int * size) noexcept;
+
+        value * get_value(int (*getter)(sqlite3_changeset_iter *, int, sqlite3_value **), int column_idx) const
+        {
+            sqlite3_value * ret = nullptr;
+            check_error(getter(c_ptr(), column_idx, &ret));
+            return (value *)ret;
+        }
+
+        static void check_error(int res)
+        {
+            if (res != SQLITE_OK)
+                throw exception(res);
+        }
+    };
+
+    /**
+     * Session object that records changes made to a database
+     *
+     * This is a [fake wrapper class](https://github.com/gershnik/thinsqlitepp#fake-classes) for
+     * sqlite3_session.
+     *
+     * Available only if #SQLITE_ENABLE_SESSION and #SQLITE_ENABLE_PREUPDATE_HOOK
+     * are defined during compilation
+     *
+     * `#include <thinsqlitepp/session.hpp>`
+     *
+     * @since SQLite 3.13
+     */
+    class session final : public handle<sqlite3_session, session>
+    {
+    public:
+        /**
+         * Create a new session object
+         *
+         * Equivalent to ::sqlite3session_create
+         *
+         * The session must be destroyed before the database it is attached to.
+         *
+         * @param db Database to record changes for
+         * @param db_name Name of the database (`main`, `temp` or attached name)
+         */
+        static std::unique_ptr<session> create(const database & db, const string_param & db_name = "main")
+        {
+            sqlite3_session * ret = nullptr;
+            int res = sqlite3session_create(db.c_ptr(), db_name.c_str(), &ret);
+            if (res != SQLITE_OK)
+                throw exception(res, db);
+            return std::unique_ptr<session>(from(ret));
+        }
+
+        /// Equivalent to ::sqlite3session_delete
+        ~session() noexcept
+            { sqlite3session_delete(c_ptr()); }
+
+        /**
+         * Enable or disable recording of changes
+         *
+         * Equivalent to ::sqlite3session_enable
+         *
+         * @returns Whether the session is enabled after the call
+         */
+        bool enable(bool val) noexcept
+            { return sqlite3session_enable(c_ptr(), val); }
+
+        /// Whether the session is enabled
+        bool enabled() const noexcept
+            { return sqlite3session_enable(c_ptr(), -1); }
+
+        /**
+         * Set or clear the indirect change flag
+         *
+         * Equivalent to ::sqlite3session_indirect
+         *
+         * @returns The value of the flag after the call
+         */
+        bool indirect(bool val) noexcept
+            { return sqlite3session_indirect(c_ptr(), val); }
+
+        /// Whether the indirect change flag is set
+        bool is_indirect() const noexcept
+            { return sqlite3session_indirect(c_ptr(), -1); }
+
+        /**
+         * Attach a table to the session
+         *
+         * Equivalent to ::sqlite3session_attach
+         *
+         * @param table Name of the table or nullptr to record changes to all tables
+         */
+        void attach(const string_param & table)
+            { check_error(sqlite3session_attach(c_ptr(), table.c_str())); }
+
+        /**
+         * Set a table filter
+         *
+         * Equivalent to ::sqlite3session_table_filter
+         *
+         * @param filter_ptr A **pointer** to any C++ callable that can be invoked as
+         * ```
+         * bool (*filter_ptr)(const char * table) noexcept;
+         * ```
+         * It should return `true` to record changes to a given table.
+         * This parameter can also be nullptr to reset the filter.
+         * The filter object must exist as long as it is set.
+         */
+        template<class T>
+        SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_filter<T>,
+        void) table_filter(T filter_ptr) noexcept;
+
+        /**
+         * Load the difference between tables into the session
+         *
+         * Equivalent to ::sqlite3session_diff
+         */
+        void diff(const string_param & from_db, const string_param & table)
+        {
+            char * errmessage = nullptr;
+            int res = sqlite3session_diff(c_ptr(), from_db.c_str(), table.c_str(), &errmessage);
+            error::message_ptr errmessage_ptr(errmessage, sqlite3_free);
+            if (res != SQLITE_OK)
+                throw exception(res, std::move(errmessage_ptr));
+        }
+
+        /**
+         * Generate a changeset from the session
+         *
+         * Equivalent to ::sqlite3session_changeset
+         */
+        class changeset changeset() const
+        {
+            int size = 0;
+            void * data = nullptr;
+            int res = sqlite3session_changeset(c_ptr(), &size, &data);
+            return thinsqlitepp::changeset::check_output(res, size, data);
+        }
+
+        /**
+         * Generate a patchset from the session
+         *
+         * Equivalent to ::sqlite3session_patchset
+         */
+        class changeset patchset() const
+        {
+            int size = 0;
+            void * data = nullptr;
+            int res = sqlite3session_patchset(c_ptr(), &size, &data);
+            return thinsqlitepp::changeset::check_output(res, size, data);
+        }
+
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 14, 0)
+
+        /**
+         * Stream a changeset from the session
+         *
+         * Equivalent to ::sqlite3session_changeset_strm
+         *
+         * @param output_ptr A **pointer** to output callable. See @ref changeset for details.
+         *
+         * @since SQLite 3.14
+         */
+        template<class Out>
+        SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_output<Out>,
+        void) changeset(Out output_ptr) const;
+
+        /**
+         * Stream a patchset from the session
+         *
+         * Equivalent to ::sqlite3session_patchset_strm
+         *
+         * @param output_ptr A **pointer** to output callable. See @ref changeset for details.
+         *
+         * @since SQLite 3.14
+         */
+        template<class Out>
+        SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_output<Out>,
+        void) patchset(Out output_ptr) const;
+
+    #endif
+
+        /**
+         * Whether the session has no recorded changes
+         *
+         * Equivalent to ::sqlite3session_isempty
+         */
+        bool empty() const noexcept
+            { return sqlite3session_isempty(c_ptr()); }
+
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 36, 0)
+        /**
+         * Amount of heap memory used by the session
+         *
+         * Equivalent to ::sqlite3session_memory_used
+         *
+         * @since SQLite 3.36
+         */
+        int64_t memory_used() const noexcept
+            { return sqlite3session_memory_used(c_ptr()); }
+    #endif
+
+    private:
+        static void check_error(int res)
+        {
+            if (res != SQLITE_OK)
+                throw exception(res);
+        }
+    };
+
+    /**
+     * Object to combine multiple changesets
+     *
+     * This is a [fake wrapper class](https://github.com/gershnik/thinsqlitepp#fake-classes) for
+     * sqlite3_changegroup.
+     *
+     * Available only if #SQLITE_ENABLE_SESSION and #SQLITE_ENABLE_PREUPDATE_HOOK
+     * are defined during compilation
+     *
+     * `#include <thinsqlitepp/session.hpp>`
+     *
+     * @since SQLite 3.13
+     */
+    class changegroup final : public handle<sqlite3_changegroup, changegroup>
+    {
+    public:
+        /**
+         * Create a new changegroup
+         *
+         * Equivalent to ::sqlite3changegroup_new
+         */
+        static std::unique_ptr<changegroup> create()
+        {
+            sqlite3_changegroup * ret = nullptr;
+            int res = sqlite3changegroup_new(&ret);
+            if (res != SQLITE_OK)
+                throw exception(res);
+            return std::unique_ptr<changegroup>(from(ret));
+        }
+
+        /// Equivalent to ::sqlite3changegroup_delete
+        ~changegroup() noexcept
+            { sqlite3changegroup_delete(c_ptr()); }
+
+        /**
+         * Add a changeset to the group
+         *
+         * Equivalent to ::sqlite3changegroup_add
+         */
+        void add(const blob_view & changes)
+        {
+            int res = sqlite3changegroup_add(c_ptr(), int_size(changes.size()), const_cast<std::byte *>(changes.data()));
+            if (res != SQLITE_OK)
+                throw exception(res);
+        }
+
+        /**
+         * Obtain the combined changeset
+         *
+         * Equivalent to ::sqlite3changegroup_output
+         */
+        changeset output() const
+        {
+            int size = 0;
+            void * data = nullptr;
+            int res = sqlite3changegroup_output(c_ptr(), &size, &data);
+            return changeset::check_output(res, size, data);
+        }
+
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 14, 0)
+
+        /**
+         * Add a changeset read from a stream to the group
+         *
+         * Equivalent to ::sqlite3changegroup_add_strm
+         *
+         * @param input_ptr A **pointer** to input callable. See @ref changeset for details.
+         *
+         * @since SQLite 3.14
+         */
+        template<class In>
+        SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_input<In>,
+        void) add(In input_ptr);
+
+        /**
+         * Stream the combined changeset
+         *
+         * Equivalent to ::sqlite3changegroup_output_strm
+         *
+         * @param output_ptr A **pointer** to output callable. See @ref changeset for details.
+         *
+         * @since SQLite 3.14
+         */
+        template<class Out>
+        SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_output<Out>,
+        void) output(Out output_ptr) const;
+
+    #endif
+    };
+
+    /** @} */
+
+#endif
+}
+
+#endif
@@ -0,0 +1,259 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_SESSION_IMPL_INCLUDED
+#define HEADER_SQLITEPP_SESSION_IMPL_INCLUDED
+
+#include "session_iface.hpp"
+
+namespace thinsqlitepp
+{
+#if defined(SQLITE_ENABLE_SESSION) && defined(SQLITE_ENABLE_PREUPDATE_HOOK) && \
+    SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 13, 0)
+
+    //MARK: - changeset
+
+    inline changeset changeset::invert(const blob_view & changes)
+    {
+        int size = 0;
+        void * data = nullptr;
+        int res = sqlite3changeset_invert(int_size(changes.size()), changes.data(), &size, &data);
+        return check_output(res, size, data);
+    }
+
+    inline changeset changeset::concat(const blob_view & lhs, const blob_view & rhs)
+    {
+        int size = 0;
+        void * data = nullptr;
+        int res = sqlite3changeset_concat(int_size(lhs.size()), const_cast<std::byte *>(lhs.data()),
+                                          int_size(rhs.size()), const_cast<std::byte *>(rhs.data()),
+                                          &size, &data);
+        return check_output(res, size, data);
+    }
+
+    template<class Conflict, class Filter>
+    int changeset::apply_context<Conflict, Filter>::call_filter(void * me, const char * table) noexcept
+    {
+        if constexpr (!std::is_null_pointer_v<Filter>)
+            return (*static_cast<apply_context *>(me)->filter)(table);
+        else
+            return true;
+    }
+
+    template<class Conflict, class Filter>
+    int changeset::apply_context<Conflict, Filter>::call_conflict(void * me, int type, sqlite3_changeset_iter * iter) noexcept
+    {
+        return (*static_cast<apply_context *>(me)->conflict)(type, changeset_iterator::from(iter));
+    }
+
+    template<class Conflict, class Filter>
+    SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_conflict_handler<Conflict> &&
+                       session_detector::is_pointer_to_filter<Filter>,
+    void) changeset::apply(database & db, const blob_view & changes, Conflict conflict_ptr, Filter filter_ptr, int flags)
+    {
+        apply_context<Conflict, Filter> context{conflict_ptr, filter_ptr};
+        auto filter = std::is_null_pointer_v<Filter> ? nullptr : &decltype(context)::call_filter;
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 22, 0)
+        int res = sqlite3changeset_apply_v2(db.c_ptr(), int_size(changes.size()), const_cast<std::byte *>(changes.data()),
+                                            filter, &decltype(context)::call_conflict, &context,
+                                            nullptr, nullptr, flags);
+    #else
+        (void)flags;
+        int res = sqlite3changeset_apply(db.c_ptr(), int_size(changes.size()), const_cast<std::byte *>(changes.data()),
+                                         filter, &decltype(context)::call_conflict, &context);
+    #endif
+        if (res != SQLITE_OK)
+            throw exception(res, db);
+    }
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 14, 0)
+
+    template<class In, class Out>
+    SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_input<In> && session_detector::is_pointer_to_output<Out>,
+    void) changeset::invert(In input_ptr, Out output_ptr)
+    {
+        stream_adapter<In> input(input_ptr);
+        stream_adapter<Out> output(output_ptr);
+        int res = sqlite3changeset_invert_strm(&stream_adapter<In>::input, &input, &stream_adapter<Out>::output, &output);
+        input.rethrow_if_failed();
+        output.rethrow_if_failed();
+        if (res != SQLITE_OK)
+            throw exception(res);
+    }
+
+    template<class InLhs, class InRhs, class Out>
+    SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_input<InLhs> && session_detector::is_pointer_to_input<InRhs> &&
+                       session_detector::is_pointer_to_output<Out>,
+    void) changeset::concat(InLhs lhs_input_ptr, InRhs rhs_input_ptr, Out output_ptr)
+    {
+        stream_adapter<InLhs> lhs(lhs_input_ptr);
+        stream_adapter<InRhs> rhs(rhs_input_ptr);
+        stream_adapter<Out> output(output_ptr);
+        int res = sqlite3changeset_concat_strm(&stream_adapter<InLhs>::input, &lhs,
+                                               &stream_adapter<InRhs>::input, &rhs,
+                                               &stream_adapter<Out>::output, &output);
+        lhs.rethrow_if_failed();
+        rhs.rethrow_if_failed();
+        output.rethrow_if_failed();
+        if (res != SQLITE_OK)
+            throw exception(res);
+    }
+
+    template<class In, class Conflict, class Filter>
+    SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_input<In> &&
+                       session_detector::is_pointer_to_conflict_handler<Conflict> &&
+                       session_detector::is_pointer_to_filter<Filter>,
+    void) changeset::apply(database & db, In input_ptr, Conflict conflict_ptr, Filter filter_ptr, int flags)
+    {
+        stream_adapter<In> input(input_ptr);
+        apply_context<Conflict, Filter> context{conflict_ptr, filter_ptr};
+        auto filter = std::is_null_pointer_v<Filter> ? nullptr : &decltype(context)::call_filter;
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 22, 0)
+        int res = sqlite3changeset_apply_v2_strm(db.c_ptr(), &stream_adapter<In>::input, &input,
+                                                 filter, &decltype(context)::call_conflict, &context,
+                                                 nullptr, nullptr, flags);
+    #else
+        (void)flags;
+        int res = sqlite3changeset_apply_strm(db.c_ptr(), &stream_adapter<In>::input, &input,
+                                              filter, &decltype(context)::call_conflict, &context);
+    #endif
+        input.rethrow_if_failed();
+        if (res != SQLITE_OK)
+            throw exception(res, db);
+    }
+
+#endif
+
+    //MARK: - changeset_iterator
+
+    inline std::unique_ptr<changeset_iterator> changeset_iterator::start(const blob_view & changes, int flags)
+    {
+        sqlite3_changeset_iter * ret = nullptr;
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 26, 0)
+        int res = sqlite3changeset_start_v2(&ret, int_size(changes.size()), const_cast<std::byte *>(changes.data()), flags);
+    #else
+        (void)flags;
+        int res = sqlite3changeset_start(&ret, int_size(changes.size()), const_cast<std::byte *>(changes.data()));
+    #endif
+        check_error(res);
+        return std::unique_ptr<changeset_iterator>(from(ret));
+    }
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 14, 0)
+
+    template<class In>
+    int changeset_iterator::input(void * input_ptr, void * data, int * size) noexcept
+    {
+        try
+        {
+            *size = int((*static_cast<In>(input_ptr))(span<std::byte>(static_cast<std::byte *>(data), size_t(*size))));
+            return SQLITE_OK;
+        }
+        catch(exception & ex)
+        {
+            return ex.extended_error_code();
+        }
+        catch(std::bad_alloc &)
+        {
+            return SQLITE_NOMEM;
+        }
+        catch(std::exception &)
+        {
+            return SQLITE_ERROR;
+        }
+    }
+
+    template<class In>
+    SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_input<In>,
+    std::unique_ptr<changeset_iterator>) changeset_iterator::start(In input_ptr, int flags)
+    {
+        sqlite3_changeset_iter * ret = nullptr;
+        void * data = const_cast<std::remove_const_t<std::remove_pointer_t<In>> *>(input_ptr);
+    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 26, 0)
+        int res = sqlite3changeset_start_v2_strm(&ret, &changeset_iterator::input<In>, data, flags);
+    #else
+        (void)flags;
+        int res = sqlite3changeset_start_strm(&ret, &changeset_iterator::input<In>, data);
+    #endif
+        check_error(res);
+        return std::unique_ptr<changeset_iterator>(from(ret));
+    }
+
+#endif
+
+    //MARK: - session
+
+    template<class T>
+    SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_filter<T>,
+    void) session::table_filter(T filter_ptr) noexcept
+    {
+        if constexpr (!std::is_null_pointer_v<T>)
+        {
+            if (filter_ptr)
+            {
+                sqlite3session_table_filter(c_ptr(), [](void * data, const char * table) noexcept -> int {
+                    return (*static_cast<T>(data))(table);
+                }, const_cast<std::remove_const_t<std::remove_pointer_t<T>> *>(filter_ptr));
+                return;
+            }
+        }
+        sqlite3session_table_filter(c_ptr(), nullptr, nullptr);
+    }
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 14, 0)
+
+    template<class Out>
+    SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_output<Out>,
+    void) session::changeset(Out output_ptr) const
+    {
+        stream_adapter<Out> output(output_ptr);
+        int res = sqlite3session_changeset_strm(c_ptr(), &stream_adapter<Out>::output, &output);
+        output.rethrow_if_failed();
+        check_error(res);
+    }
+
+    template<class Out>
+    SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_output<Out>,
+    void) session::patchset(Out output_ptr) const
+    {
+        stream_adapter<Out> output(output_ptr);
+        int res = sqlite3session_patchset_strm(c_ptr(), &stream_adapter<Out>::output, &output);
+        output.rethrow_if_failed();
+        check_error(res);
+    }
+
+    //MARK: - changegroup
+
+    template<class In>
+    SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_input<In>,
+    void) changegroup::add(In input_ptr)
+    {
+        stream_adapter<In> input(input_ptr);
+        int res = sqlite3changegroup_add_strm(c_ptr(), &stream_adapter<In>::input, &input);
+        input.rethrow_if_failed();
+        if (res != SQLITE_OK)
+            throw exception(res);
+    }
+
+    template<class Out>
+    SQLITEPP_ENABLE_IF(session_detector::is_pointer_to_output<Out>,
+    void) changegroup::output(Out output_ptr) const
+    {
+        stream_adapter<Out> output(output_ptr);
+        int res = sqlite3changegroup_output_strm(c_ptr(), &stream_adapter<Out>::output, &output);
+        output.rethrow_if_failed();
+        if (res != SQLITE_OK)
+            throw exception(res);
+    }
+
+#endif
+
+#endif
+}
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_SLIDING_WINDOW_IFACE_INCLUDED
+#define HEADER_SQLITEPP_SLIDING_WINDOW_IFACE_INCLUDED
+
+#include "config.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <type_traits>
+
+namespace thinsqlitepp
+{
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Window function state computing SUM over a sliding frame in O(1) per row
+     *
+     * Use with @ref database::create_window_function(const char *, int) "typed create_window_function":
+     * ```
+     * db->create_window_function<sliding_sum<int64_t>>("fast_sum");
+     * ```
+     * Like SQL `SUM` NULL arguments are ignored and the result is NULL if the frame has no
+     * non-NULL values. With `double` values the result is computed by adding and subtracting
+     * and so can accumulate rounding errors over very long partitions.
+     *
+     * `#include <thinsqlitepp/sliding_window.hpp>`
+     *
+     * @tparam T Either `int64_t` or `double`
+     */
+    template<class T>
+    class sliding_sum
+    {
+        static_assert(std::is_same_v<T, int64_t> || std::is_same_v<T, double>, "T must be int64_t or double");
+    public:
+        /// Adds a row to the frame
+        void step(std::optional<T> val) noexcept
+        {
+            if (val)
+            {
+                _sum += *val;
+                ++_count;
+            }
+        }
+        /// Removes the oldest row from the frame
+        void inverse(std::optional<T> val) noexcept
+        {
+            if (val)
+            {
+                _sum -= *val;
+                --_count;
+            }
+        }
+        /// Sum of non-NULL values in the frame
+        std::optional<T> result() const noexcept
+            { return _count ? std::optional<T>(_sum) : std::nullopt; }
+    private:
+        T _sum = 0;
+        size_t _count = 0;
+    };
+
+    /**
+     * Window function state computing MIN or MAX over a sliding frame in amortized O(1) per row
+     *
+     * The state keeps a monotonic deque of the values that can still become the extreme one:
+     * a new value evicts all older values that it beats and the front of the deque is the result.
+     * Since rows leave a window frame in the order they entered it, each value is added and removed
+     * at most once.
+     *
+     * Like SQL `MIN` and `MAX` NULL arguments are ignored and the result is NULL if the frame has no
+     * non-NULL values.
+     *
+     * `#include <thinsqlitepp/sliding_window.hpp>`
+     *
+     * @tparam T Either `int64_t` or `double`
+     * @tparam Compare Comparator that returns `true` if its first argument should be preferred to the
+     * second
+     *
+     * @see sliding_min, sliding_max
+     */
+    template<class T, class Compare>
+    class sliding_extreme
+    {
+        static_assert(std::is_same_v<T, int64_t> || std::is_same_v<T, double>, "T must be int64_t or double");
+    public:
+        /// Adds a row to the frame
+        void step(std::optional<T> val)
+        {
+            uint64_t seq = _added++;
+            if (!val)
+                return;
+            while (!_window.empty() && !Compare()(_window.back().value, *val))
+                _window.pop_back();
+            _window.push_back({seq, *val});
+        }
+        /// Removes the oldest row from the frame
+        void inverse(std::optional<T>) noexcept
+        {
+            uint64_t seq = _removed++;
+            if (!_window.empty() && _window.front().seq == seq)
+                _window.pop_front();
+        }
+        /// The extreme non-NULL value in the frame
+        std::optional<T> result() const noexcept
+            { return _window.empty() ? std::nullopt : std::optional<T>(_window.front().value); }
+    private:
+        struct item
+        {
+            uint64_t seq;
+            T value;
+        };
+        std::deque<item> _window;
+        uint64_t _added = 0;
+        uint64_t _removed = 0;
+    };
+
+    /// Window function state computing MIN over a sliding frame. See sliding_extreme
+    template<class T>
+    using sliding_min = sliding_extreme<T, std::less<T>>;
+
+    /// Window function state computing MAX over a sliding frame. See sliding_extreme
+    template<class T>
+    using sliding_max = sliding_extreme<T, std::greater<T>>;
+
+    /** @} */
+}
+
+#endif
+
@@ -0,0 +1,148 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_SQL_TEXT_INCLUDED
+#define HEADER_SQLITEPP_SQL_TEXT_INCLUDED
+
+#include "config.hpp"
+
+#include <functional>
+#include <string_view>
+
+#include <stdint.h>
+
+namespace thinsqlitepp
+{
+    class sql_text;
+
+    inline namespace literals
+    {
+        SQLITEPP_CONSTEVAL sql_text operator""_sql(const char * str, size_t size) noexcept;
+    }
+
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * SQL text with precomputed length and hash
+     *
+     * Objects of this class are normally produced at compile time by the `_sql` literal:
+     * ```
+     * using namespace thinsqlitepp::literals;
+     *
+     * auto stmt = statement::create(db, "SELECT * FROM items WHERE id = ?"_sql);
+     * auto res = cache.query("SELECT name FROM items WHERE category = ?"_sql, category);
+     * ```
+     * Passing it to statement::create() avoids measuring the string and lets SQLite use it
+     * without making a copy. Caches such as @ref query_cache use the precomputed hash instead of
+     * hashing the text on every lookup and, for literals, recognize the same text by its address.
+     *
+     * The hash is 64-bit FNV-1a of the text (truncated to `size_t`). Like `std::string_view`
+     * this class has _reference_ semantics.
+     */
+    class sql_text
+    {
+    friend SQLITEPP_CONSTEVAL sql_text literals::operator""_sql(const char * str, size_t size) noexcept;
+    public:
+        /// Construct from any text, computing the hash at runtime if necessary
+        constexpr explicit sql_text(std::string_view str) noexcept:
+            _str(str),
+            _hash(hash_of(str))
+        {}
+
+        /// Pointer to the text
+        constexpr const char * data() const noexcept
+            { return _str.data(); }
+        /// Length of the text in bytes, not including the null terminator if any
+        constexpr size_t size() const noexcept
+            { return _str.size(); }
+        /// Precomputed hash of the text
+        constexpr size_t hash() const noexcept
+            { return _hash; }
+        /**
+         * Whether the text is a string literal
+         *
+         * Literal text is null terminated and stays at the same address for the duration of the program.
+         */
+        constexpr bool is_literal() const noexcept
+            { return _literal; }
+
+        /// Access the text
+        constexpr operator std::string_view() const noexcept
+            { return _str; }
+        /// @overload
+        constexpr std::string_view str() const noexcept
+            { return _str; }
+
+        /// Computes the same hash as hash() for arbitrary text
+        static constexpr size_t hash_of(std::string_view str) noexcept
+        {
+            uint64_t ret = 0xcbf29ce484222325ull;
+            for (char c: str)
+            {
+                ret ^= uint64_t((unsigned char)c);
+                ret *= 0x100000001b3ull;
+            }
+            return size_t(ret);
+        }
+
+        /// Texts are equal if they have the same content
+        friend constexpr bool operator==(const sql_text & lhs, const sql_text & rhs) noexcept
+        {
+            return lhs._hash == rhs._hash && lhs._str.size() == rhs._str.size() &&
+                   (lhs._str.data() == rhs._str.data() || lhs._str == rhs._str);
+        }
+        /// @overload
+        friend constexpr bool operator!=(const sql_text & lhs, const sql_text & rhs) noexcept
+            { return !(lhs == rhs); }
+    private:
+        constexpr sql_text(std::string_view str, bool literal) noexcept:
+            _str(str),
+            _hash(hash_of(str)),
+            _literal(literal)
+        {}
+    private:
+        std::string_view _str;
+        size_t _hash;
+        bool _literal = false;
+    };
+
+    inline namespace literals
+    {
+        /**
+         * Produce @ref sql_text from a string literal
+         *
+         * In C++20 and later this operator is `consteval` so the length and hash are always
+         * computed at compile time. In C++17 it is `constexpr` and they are computed at compile
+         * time in constant expressions, e.g. `static constexpr auto query = "..."_sql;`, and
+         * usually with optimizations enabled.
+         */
+        SQLITEPP_CONSTEVAL sql_text operator""_sql(const char * str, size_t size) noexcept
+            { return sql_text(std::string_view(str, size), true); }
+    }
+
+    /** @} */
+}
+
+/** @cond PRIVATE */
+
+namespace std
+{
+    template<>
+    struct hash<thinsqlitepp::sql_text>
+    {
+        size_t operator()(const thinsqlitepp::sql_text & val) const noexcept
+            { return val.hash(); }
+    };
+}
+
+/** @endcond */
+
+#endif
@@ -11,8 +11,10 @@
 
 #include "handle.hpp"
 #include "string_param.hpp"
+#include "sql_text.hpp"
 #include "span.hpp"
 #include "memory_iface.hpp"
+#include "exception_iface.hpp"
 
 #include <utility>
 #include <string>
@@ -74,6 +76,19 @@ namespace thinsqlitepp
                                             #endif
                                                  );
 
+        /**
+         * Compile an SQL statement
+         * 
+         * Same as create(const database &, const string_param &, unsigned int) but uses the 
+         * precomputed length of @p sql. Text of `_sql` literals is passed to SQLite together with 
+         * its null terminator which allows SQLite to avoid copying it.
+         */
+        static std::unique_ptr<statement> create(const database & db, const sql_text & sql
+                                            #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                 , unsigned int flags = 0
+                                            #endif
+                                                 );
+
 #if __cpp_char8_t >= 201811
         /**
          * Compile an SQL statement
@@ -111,6 +126,62 @@ namespace thinsqlitepp
                    );
         }
 #endif
+
+        /**
+         * Compile an SQL statement without throwing
+         * 
+         * Same as create(const database &, const string_param &, unsigned int) but failures are
+         * reported via the returned outcome. Note that, as with create(), a successful outcome
+         * can hold a null statement if @p sql contains no SQL.
+         */
+        static outcome<std::unique_ptr<statement>> try_create(const database & db, const string_param & sql
+                                                         #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                              , unsigned int flags = 0
+                                                         #endif
+                                                              ) noexcept;
+
+        /**
+         * Compile an SQL statement without throwing
+         * 
+         * Same as create(const database &, std::string_view &, unsigned int) but failures are
+         * reported via the returned outcome. On failure @p sql is not modified.
+         */
+        static outcome<std::unique_ptr<statement>> try_create(const database & db, std::string_view & sql
+                                                         #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                              , unsigned int flags = 0
+                                                         #endif
+                                                              ) noexcept;
+
+        /**
+         * Compile an SQL statement without throwing
+         * 
+         * Same as create(const database &, const sql_text &, unsigned int) but failures are
+         * reported via the returned outcome.
+         */
+        static outcome<std::unique_ptr<statement>> try_create(const database & db, const sql_text & sql
+                                                         #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                              , unsigned int flags = 0
+                                                         #endif
+                                                              ) noexcept;
+
+    #if defined(SQLITE_ENABLE_UNLOCK_NOTIFY)
+        /**
+         * Compile an SQL statement waiting for shared-cache locks
+         * 
+         * Same as create(const database &, const string_param &, unsigned int) but if compilation fails
+         * with #SQLITE_LOCKED_SHAREDCACHE, blocks via database::wait_for_unlock() until the lock is 
+         * released and tries again.
+         * 
+         * Available only if #SQLITE_ENABLE_UNLOCK_NOTIFY is defined during compilation
+         * 
+         * @throws exception with #SQLITE_LOCKED if waiting would result in a deadlock
+         */
+        static std::unique_ptr<statement> blocking_create(class database & db, const string_param & sql
+                                                     #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                          , unsigned int flags = 0
+                                                     #endif
+                                                          );
+    #endif
         
         /// Equivalent to ::sqlite3_finalize
         ~statement() noexcept
@@ -136,6 +207,30 @@ namespace thinsqlitepp
          */
         bool step();
 
+        /**
+         * Evaluate the statement without throwing
+         * 
+         * Same as step() but failures, such as #SQLITE_BUSY, are reported via the returned outcome
+         * rather than an exception. The error message is only retrieved if outcome::error() is called.
+         */
+        outcome<bool> try_step() noexcept;
+
+    #if defined(SQLITE_ENABLE_UNLOCK_NOTIFY)
+        /**
+         * Evaluate the statement waiting for shared-cache locks
+         * 
+         * Same as step() but if evaluation fails with #SQLITE_LOCKED_SHAREDCACHE, blocks via 
+         * database::wait_for_unlock() until the lock is released, resets the statement and tries again.
+         * Since the statement is reset, this should only be used for the first step of a query or
+         * for statements that do not return rows.
+         * 
+         * Available only if #SQLITE_ENABLE_UNLOCK_NOTIFY is defined during compilation
+         * 
+         * @throws exception with #SQLITE_LOCKED if waiting would result in a deadlock
+         */
+        bool blocking_step();
+    #endif
+
         /**
          * Reset the statement
          * 
@@ -357,6 +452,42 @@ namespace thinsqlitepp
          */
         void bind(int idx, const value & val);
 
+        ///@}
+
+        /** @{
+         * @anchor statement_try_bind
+         * @name Binding values to parameters without throwing
+         * 
+         * These functions are the same as the corresponding @ref statement_bind "bind" overloads
+         * but report failures via the returned result_code rather than an exception.
+         */
+
+        /// Non-throwing version of bind(int, std::nullptr_t)
+        result_code try_bind(int idx, std::nullptr_t) noexcept
+            { return make_result(sqlite3_bind_null(c_ptr(), idx)); }
+        /// Non-throwing version of bind(int, int)
+        result_code try_bind(int idx, int val) noexcept
+            { return make_result(sqlite3_bind_int(c_ptr(), idx, val)); }
+        /// Non-throwing version of bind(int, int64_t)
+        result_code try_bind(int idx, int64_t val) noexcept
+            { return make_result(sqlite3_bind_int64(c_ptr(), idx, val)); }
+        /// Non-throwing version of bind(int, double)
+        result_code try_bind(int idx, double val) noexcept
+            { return make_result(sqlite3_bind_double(c_ptr(), idx, val)); }
+        /// Non-throwing version of bind(int, const std::string_view &)
+        result_code try_bind(int idx, const std::string_view & val) noexcept;
+    #if __cpp_char8_t >= 201811
+        /// Non-throwing version of bind(int, const std::u8string_view &)
+        result_code try_bind(int idx, const std::u8string_view & val) noexcept;
+    #endif
+        /// Non-throwing version of bind(int, const blob_view &)
+        result_code try_bind(int idx, const blob_view & val) noexcept;
+        /// Non-throwing version of bind(int, const zero_blob &)
+        result_code try_bind(int idx, const zero_blob & val) noexcept
+            { return make_result(sqlite3_bind_zeroblob(c_ptr(), idx, int(val.size()))); }
+        /// Non-throwing version of bind(int, const value &)
+        result_code try_bind(int idx, const value & val) noexcept;
+
         ///@}
         
         /** @{
@@ -551,6 +682,8 @@ namespace thinsqlitepp
         
     private:
         void check_error(int res) const;
+        result_code make_result(int res) const noexcept
+            { return result_code(res, res == SQLITE_OK ? nullptr : &database()); }
     };
 
     /// @cond PRIVATE
@@ -19,6 +19,45 @@ namespace thinsqlitepp
                                                         , unsigned int flags
 #endif
                                                         )
+    {
+        return try_create(db, sql
+                    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                          , flags
+                    #endif
+                         ).value();
+    }
+
+    inline std::unique_ptr<statement> statement::create(const class database & db, std::string_view & sql
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                        , unsigned int flags
+#endif
+                                                        )
+    {
+        return try_create(db, sql
+                    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                          , flags
+                    #endif
+                         ).value();
+    }
+
+    inline std::unique_ptr<statement> statement::create(const class database & db, const sql_text & sql
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                        , unsigned int flags
+#endif
+                                                        )
+    {
+        return try_create(db, sql
+                    #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                          , flags
+                    #endif
+                         ).value();
+    }
+
+    inline outcome<std::unique_ptr<statement>> statement::try_create(const class database & db, const string_param & sql
+                                                                #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                                     , unsigned int flags
+                                                                #endif
+                                                                     ) noexcept
     {
         const char * tail = nullptr;
         sqlite3_stmt * ret = nullptr;
@@ -28,30 +67,76 @@ namespace thinsqlitepp
         int res = sqlite3_prepare_v2(db.c_ptr(), sql.c_str(), -1, &ret, &tail);
 #endif
         if (res != SQLITE_OK)
-            throw exception(res, db);
+            return result_code(res, &db);
         return std::unique_ptr<statement>(from(ret));
     }
 
-    inline std::unique_ptr<statement> statement::create(const class database & db, std::string_view & sql
-#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
-                                                        , unsigned int flags
-#endif
-                                                        )
+    inline outcome<std::unique_ptr<statement>> statement::try_create(const class database & db, std::string_view & sql
+                                                                #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                                     , unsigned int flags
+                                                                #endif
+                                                                     ) noexcept
     {
+        if (sql.size() > size_t(std::numeric_limits<int>::max()))
+            return result_code(SQLITE_TOOBIG);
         const char * start = sql.size() ? &sql[0] : "";
         const char * tail = nullptr;
         sqlite3_stmt * ret = nullptr;
 #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
-        int res = sqlite3_prepare_v3(db.c_ptr(), start, int_size(sql.size()), flags, &ret, &tail);
+        int res = sqlite3_prepare_v3(db.c_ptr(), start, int(sql.size()), flags, &ret, &tail);
 #else
-        int res = sqlite3_prepare_v2(db.c_ptr(), start, int_size(sql.size()), &ret, &tail);
+        int res = sqlite3_prepare_v2(db.c_ptr(), start, int(sql.size()), &ret, &tail);
 #endif
         if (res != SQLITE_OK)
-            throw exception(res, db);
+            return result_code(res, &db);
         sql.remove_prefix(tail - start);
         return std::unique_ptr<statement>(from(ret));
     }
 
+    inline outcome<std::unique_ptr<statement>> statement::try_create(const class database & db, const sql_text & sql
+                                                                #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                                     , unsigned int flags
+                                                                #endif
+                                                                     ) noexcept
+    {
+        if (sql.size() >= size_t(std::numeric_limits<int>::max()))
+            return result_code(SQLITE_TOOBIG);
+        //passing the null terminator lets SQLite skip copying the text
+        const int size = int(sql.size()) + (sql.is_literal() ? 1 : 0);
+        const char * start = sql.size() ? sql.data() : "";
+        sqlite3_stmt * ret = nullptr;
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+        int res = sqlite3_prepare_v3(db.c_ptr(), start, size, flags, &ret, nullptr);
+#else
+        int res = sqlite3_prepare_v2(db.c_ptr(), start, size, &ret, nullptr);
+#endif
+        if (res != SQLITE_OK)
+            return result_code(res, &db);
+        return std::unique_ptr<statement>(from(ret));
+    }
+
+
+#if defined(SQLITE_ENABLE_UNLOCK_NOTIFY)
+    inline std::unique_ptr<statement> statement::blocking_create(class database & db, const string_param & sql
+                                                            #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                                                 , unsigned int flags
+                                                            #endif
+                                                                 )
+    {
+        for ( ; ; )
+        {
+            auto res = try_create(db, sql
+                            #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+                                  , flags
+                            #endif
+                                 );
+            if (res.has_value() || res.code().primary() != SQLITE_LOCKED || 
+                sqlite3_extended_errcode(db.c_ptr()) != SQLITE_LOCKED_SHAREDCACHE)
+                return std::move(res).value();
+            db.wait_for_unlock();
+        }
+    }
+#endif
 
     inline bool statement::step()
     {
@@ -63,12 +148,47 @@ namespace thinsqlitepp
         throw exception(res, database());
     }
 
+    inline outcome<bool> statement::try_step() noexcept
+    {
+        int res = sqlite3_step(c_ptr());
+        if (res == SQLITE_DONE)
+            return false;
+        if (res == SQLITE_ROW)
+            return true;
+        return result_code(res, &database());
+    }
+
+#if defined(SQLITE_ENABLE_UNLOCK_NOTIFY)
+    inline bool statement::blocking_step()
+    {
+        for ( ; ; )
+        {
+            int res = sqlite3_step(c_ptr());
+            if (res == SQLITE_DONE)
+                return false;
+            if (res == SQLITE_ROW)
+                return true;
+            if ((res & 0xFF) != SQLITE_LOCKED || 
+                sqlite3_extended_errcode(sqlite3_db_handle(c_ptr())) != SQLITE_LOCKED_SHAREDCACHE)
+                throw exception(res, database());
+            database().wait_for_unlock();
+            reset();
+        }
+    }
+#endif
+
     inline void statement::bind(int idx, const std::string_view & value)
     {
+        try_bind(idx, value).check();
+    }
+
+    inline result_code statement::try_bind(int idx, const std::string_view & value) noexcept
+    {
+        if (value.size() > size_t(std::numeric_limits<int>::max()))
+            return result_code(SQLITE_TOOBIG);
         if (auto data = value.data())
-            check_error(sqlite3_bind_text(c_ptr(), idx, data, int_size(value.size()), SQLITE_TRANSIENT));
-        else
-            check_error(sqlite3_bind_text(c_ptr(), idx, "", 0, SQLITE_STATIC));
+            return make_result(sqlite3_bind_text(c_ptr(), idx, data, int(value.size()), SQLITE_TRANSIENT));
+        return make_result(sqlite3_bind_text(c_ptr(), idx, "", 0, SQLITE_STATIC));
     }
 
     inline void statement::bind_reference(int idx, const std::string_view & value)
@@ -95,10 +215,12 @@ namespace thinsqlitepp
 #if __cpp_char8_t >= 201811
     inline void statement::bind(int idx, const std::u8string_view & value)
     {
-        if (auto data = value.data())
-            check_error(sqlite3_bind_text(c_ptr(), idx, (const char *)data, int_size(value.size()), SQLITE_TRANSIENT));
-        else
-            check_error(sqlite3_bind_text(c_ptr(), idx, "", 0, SQLITE_STATIC));
+        try_bind(idx, value).check();
+    }
+
+    inline result_code statement::try_bind(int idx, const std::u8string_view & value) noexcept
+    {
+        return try_bind(idx, std::string_view((const char *)value.data(), value.size()));
     }
 
     inline void statement::bind_reference(int idx, const std::u8string_view & value)
@@ -125,10 +247,16 @@ namespace thinsqlitepp
 
     inline void statement::bind(int idx, const blob_view & value)
     {
+        try_bind(idx, value).check();
+    }
+
+    inline result_code statement::try_bind(int idx, const blob_view & value) noexcept
+    {
+        if (value.size() > size_t(std::numeric_limits<int>::max()))
+            return result_code(SQLITE_TOOBIG);
         if (auto data = value.data())
-            check_error(sqlite3_bind_blob(c_ptr(), idx, data, int_size(value.size()), SQLITE_TRANSIENT));
-        else
-            check_error(sqlite3_bind_zeroblob(c_ptr(), idx, 0));
+            return make_result(sqlite3_bind_blob(c_ptr(), idx, data, int(value.size()), SQLITE_TRANSIENT));
+        return make_result(sqlite3_bind_zeroblob(c_ptr(), idx, 0));
     }
 
     inline void statement::bind_reference(int idx, const blob_view & value)
@@ -157,6 +285,11 @@ namespace thinsqlitepp
         check_error(sqlite3_bind_value(c_ptr(), idx, val.c_ptr()));
     }
 
+    inline result_code statement::try_bind(int idx, const value & val) noexcept
+    {
+        return make_result(sqlite3_bind_value(c_ptr(), idx, val.c_ptr()));
+    }
+
     
 
     template<>
@@ -0,0 +1,215 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_TYPED_FUNCTION_IFACE_INCLUDED
+#define HEADER_SQLITEPP_TYPED_FUNCTION_IFACE_INCLUDED
+
+#include "span.hpp"
+#include "meta.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+namespace thinsqlitepp
+{
+    class context;
+    class value;
+    class owned_value;
+
+    /** @cond PRIVATE */
+
+    //MARK: - Argument and result types
+
+    template<class T>
+    constexpr bool is_typed_function_scalar =
+        std::is_same_v<T, int> ||
+        std::is_same_v<T, int64_t> ||
+        std::is_same_v<T, double> ||
+        std::is_same_v<T, std::string_view> ||
+    #if __cpp_char8_t >= 201811
+        std::is_same_v<T, std::u8string_view> ||
+    #endif
+        std::is_same_v<T, blob_view>;
+
+    template<class T>
+    struct typed_function_argument
+    {
+        static constexpr bool supported = is_typed_function_scalar<T>;
+    };
+    template<class T>
+    struct typed_function_argument<std::optional<T>>
+    {
+        static constexpr bool supported = is_typed_function_scalar<T>;
+    };
+    template<>
+    struct typed_function_argument<value>
+    {
+        static constexpr bool supported = true;
+    };
+    template<>
+    struct typed_function_argument<value *>
+    {
+        static constexpr bool supported = true;
+    };
+    template<>
+    struct typed_function_argument<const value *>
+    {
+        static constexpr bool supported = true;
+    };
+
+    template<class T>
+    constexpr bool is_typed_function_argument =
+        typed_function_argument<std::remove_cv_t<std::remove_reference_t<T>>>::supported;
+
+
+    template<class T>
+    struct typed_function_result
+    {
+        static constexpr bool supported =
+            std::is_void_v<T> ||
+            std::is_null_pointer_v<T> ||
+            std::is_arithmetic_v<T> ||
+            std::is_same_v<T, std::string_view> ||
+            std::is_same_v<T, std::string> ||
+        #if __cpp_char8_t >= 201811
+            std::is_same_v<T, std::u8string_view> ||
+            std::is_same_v<T, std::u8string> ||
+        #endif
+            std::is_same_v<T, blob_view> ||
+            std::is_same_v<T, zero_blob> ||
+            std::is_same_v<T, owned_value>;
+    };
+    template<class T>
+    struct typed_function_result<std::optional<T>> : typed_function_result<T>
+    {};
+
+    template<class T>
+    constexpr bool is_typed_function_result =
+        typed_function_result<std::remove_cv_t<std::remove_reference_t<T>>>::supported;
+
+    //MARK: - Signature
+
+    template<class R, class Args>
+    struct typed_function_signature
+    {
+        static constexpr bool valid = false;
+    };
+
+    template<class R, class... Args>
+    struct typed_function_signature<R, std::tuple<Args...>>
+    {
+        static constexpr bool valid = is_typed_function_result<R> && (is_typed_function_argument<Args> && ...);
+        static constexpr bool has_context = false;
+        static constexpr int arg_count = int(sizeof...(Args));
+        using result_type = R;
+        using arguments = std::tuple<Args...>;
+    };
+
+    template<class R, class... Args>
+    struct typed_function_signature<R, std::tuple<context *, Args...>>
+    {
+        static constexpr bool valid = is_typed_function_result<R> && (is_typed_function_argument<Args> && ...);
+        static constexpr bool has_context = true;
+        static constexpr int arg_count = int(sizeof...(Args));
+        using result_type = R;
+        using arguments = std::tuple<Args...>;
+    };
+
+    /*
+     A typed function can be passed either by value (any callable, including function pointers)
+     in which case it is copied, or as a pointer to a callable object which is then used by reference.
+    */
+    template<class F>
+    using typed_function_target = std::conditional_t<std::is_pointer_v<F> && std::is_class_v<std::remove_pointer_t<F>>,
+                                                     std::remove_pointer_t<F>,
+                                                     F>;
+
+    template<class F, bool Callable = callable_traits<typed_function_target<F>>::is_callable>
+    struct typed_function_detector
+    {
+        static constexpr bool value = false;
+    };
+
+    template<class F>
+    struct typed_function_detector<F, true>
+    {
+        using traits = callable_traits<typed_function_target<F>>;
+        using signature = typed_function_signature<typename traits::result_type, typename traits::arguments>;
+
+        static constexpr bool value = signature::valid;
+    };
+
+    template<class F>
+    constexpr bool is_typed_function = typed_function_detector<std::decay_t<F>>::value;
+
+    //MARK: - Aggregates
+
+    template<class S, class = void>
+    struct typed_aggregate_detector
+    {
+        static constexpr bool value = false;
+    };
+
+    template<class S>
+    struct typed_aggregate_detector<S, std::void_t<decltype(&S::step), decltype(&S::result)>>
+    {
+    private:
+        using step_traits = callable_traits<decltype(&S::step)>;
+        using result_traits = callable_traits<decltype(&S::result)>;
+
+        static constexpr bool is_valid = []() constexpr {
+            if constexpr (step_traits::is_callable && result_traits::is_callable)
+            {
+                return std::is_default_constructible_v<S> && std::is_nothrow_destructible_v<S> &&
+                       typed_function_signature<void, typename step_traits::arguments>::valid &&
+                       std::tuple_size_v<typename result_traits::arguments> == 0 &&
+                       is_typed_function_result<typename result_traits::result_type> &&
+                       !std::is_void_v<typename result_traits::result_type>;
+            }
+            else
+            {
+                return false;
+            }
+        }();
+    public:
+        using signature = typed_function_signature<void, typename step_traits::arguments>;
+
+        static constexpr bool value = is_valid;
+    };
+
+    template<class S, class = void>
+    struct typed_window_detector
+    {
+        static constexpr bool value = false;
+    };
+
+    template<class S>
+    struct typed_window_detector<S, std::void_t<decltype(&S::step), decltype(&S::inverse)>>
+    {
+        static constexpr bool value = []() constexpr {
+            if constexpr (typed_aggregate_detector<S>::value && callable_traits<decltype(&S::inverse)>::is_callable)
+                return std::is_same_v<typename callable_traits<decltype(&S::inverse)>::arguments,
+                                      typename callable_traits<decltype(&S::step)>::arguments>;
+            else
+                return false;
+        }();
+    };
+
+    template<class S>
+    constexpr bool is_typed_aggregate = typed_aggregate_detector<S>::value;
+
+    template<class S>
+    constexpr bool is_typed_window = typed_window_detector<S>::value;
+
+    /** @endcond */
+}
+
+#endif
+
@@ -0,0 +1,302 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_TYPED_FUNCTION_IMPL_INCLUDED
+#define HEADER_SQLITEPP_TYPED_FUNCTION_IMPL_INCLUDED
+
+#include "typed_function_iface.hpp"
+#include "context_iface.hpp"
+#include "value_iface.hpp"
+#include "owned_value.hpp"
+#include "exception_iface.hpp"
+
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace thinsqlitepp
+{
+    /** @cond PRIVATE */
+
+    template<class T>
+    decltype(auto) typed_function_argument_from(value * val) noexcept
+    {
+        using arg_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+        if constexpr (std::is_pointer_v<arg_t>)
+            return val;
+        else if constexpr (std::is_same_v<arg_t, value>)
+            return *val;
+        else if constexpr (is_typed_function_scalar<arg_t>)
+            return val->get<arg_t>();
+        else
+        {
+            if (val->type() == SQLITE_NULL)
+                return arg_t();
+            return arg_t(val->get<typename arg_t::value_type>());
+        }
+    }
+
+    template<class T>
+    void typed_function_result_to(context * ctxt, const T & ret) noexcept
+    {
+        if constexpr (std::is_null_pointer_v<T>)
+        {
+            ctxt->result(nullptr);
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            if constexpr (sizeof(T) < sizeof(int) || (sizeof(T) == sizeof(int) && std::is_signed_v<T>))
+                ctxt->result(int(ret));
+            else
+                ctxt->result(int64_t(ret));
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            ctxt->result(double(ret));
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            ctxt->result(std::string_view(ret));
+        }
+    #if __cpp_char8_t >= 201811
+        else if constexpr (std::is_same_v<T, std::u8string>)
+        {
+            ctxt->result(std::u8string_view(ret));
+        }
+    #endif
+        else if constexpr (std::is_same_v<T, owned_value>)
+        {
+            switch(ret.type())
+            {
+                case SQLITE_INTEGER: ctxt->result(ret.template get<int64_t>());          break;
+                case SQLITE_FLOAT:   ctxt->result(ret.template get<double>());           break;
+                case SQLITE_TEXT:    ctxt->result(ret.template get<std::string_view>()); break;
+                case SQLITE_BLOB:    ctxt->result(ret.template get<blob_view>());        break;
+                default:             ctxt->result(nullptr);
+            }
+        }
+        else if constexpr (typed_function_result<T>::supported && !is_typed_function_scalar<T> && !std::is_same_v<T, zero_blob>)
+        {
+            //std::optional
+            if (ret)
+                typed_function_result_to(ctxt, *ret);
+            else
+                ctxt->result(nullptr);
+        }
+        else
+        {
+            ctxt->result(ret);
+        }
+    }
+
+    //Must be called from within a catch block
+    inline void typed_function_report_exception(context * ctxt) noexcept
+    {
+        try
+        {
+            throw;
+        }
+        catch(exception & ex)
+        {
+            ctxt->error(ex.what());
+            ctxt->error(ex.extended_error_code());
+        }
+        catch(std::bad_alloc &)
+        {
+            ctxt->error_nomem();
+        }
+        catch(std::exception & ex)
+        {
+            ctxt->error(ex.what());
+        }
+        catch(...)
+        {
+            ctxt->error("unknown exception");
+        }
+    }
+
+    template<class Signature, class Func, size_t... Idx>
+    decltype(auto) typed_function_call(Func && func, context * ctxt, value ** values, std::index_sequence<Idx...>)
+    {
+        if constexpr (Signature::has_context)
+            return func(ctxt, typed_function_argument_from<std::tuple_element_t<Idx, typename Signature::arguments>>(values[Idx])...);
+        else
+        {
+            (void)ctxt;
+            (void)values;
+            return func(typed_function_argument_from<std::tuple_element_t<Idx, typename Signature::arguments>>(values[Idx])...);
+        }
+    }
+
+    template<class Signature, class Func>
+    void typed_function_call_and_store(Func && func, context * ctxt, value ** values)
+    {
+        using result_type = decltype(typed_function_call<Signature>(func, ctxt, values,
+                                                                    std::make_index_sequence<size_t(Signature::arg_count)>()));
+        
+        if constexpr (std::is_void_v<result_type>)
+            typed_function_call<Signature>(func, ctxt, values, std::make_index_sequence<size_t(Signature::arg_count)>());
+        else
+            typed_function_result_to(ctxt, typed_function_call<Signature>(func, ctxt, values,
+                                                                          std::make_index_sequence<size_t(Signature::arg_count)>()));
+    }
+
+    template<class F>
+    struct typed_function
+    {
+        using target = typed_function_target<F>;
+        using signature = typename typed_function_detector<F>::signature;
+
+        static constexpr int arg_count = signature::arg_count;
+
+    private:
+        template<class Args> struct nothrow_detector;
+        template<class... Args> struct nothrow_detector<std::tuple<Args...>>
+        {
+            static constexpr bool value = signature::has_context ?
+                std::is_nothrow_invocable_v<target &, context *, Args...> :
+                std::is_nothrow_invocable_v<target &, Args...>;
+        };
+    public:
+        static constexpr bool is_nothrow = nothrow_detector<typename signature::arguments>::value;
+
+        static void call(context * ctxt, int /*count*/, value ** values) noexcept
+        {
+            target & func = *ctxt->user_data<target>();
+            if constexpr (is_nothrow)
+            {
+                typed_function_call_and_store<signature>(func, ctxt, values);
+            }
+            else
+            {
+                try
+                {
+                    typed_function_call_and_store<signature>(func, ctxt, values);
+                }
+                catch(...)
+                {
+                    typed_function_report_exception(ctxt);
+                }
+            }
+        }
+    };
+
+    /*
+     Aggregate state lives in memory obtained from context::aggregate_context. SQLite zero-fills it
+     on allocation so the first byte tells whether the state object has been constructed. The object 
+     itself follows, suitably aligned.
+    */
+    template<class State>
+    struct typed_aggregate
+    {
+        using signature = typename typed_aggregate_detector<State>::signature;
+
+        static constexpr int arg_count = signature::arg_count;
+
+        static void step(context * ctxt, int /*count*/, value ** values) noexcept
+        {
+            try
+            {
+                State * state = get_state(ctxt);
+                if (!state)
+                    return ctxt->error_nomem();
+                typed_function_call_and_store<signature>([state](auto && ... args) {
+                    state->step(std::forward<decltype(args)>(args)...);
+                }, ctxt, values);
+            }
+            catch(...)
+            {
+                typed_function_report_exception(ctxt);
+            }
+        }
+
+        static void inverse(context * ctxt, int /*count*/, value ** values) noexcept
+        {
+            try
+            {
+                State * state = get_state(ctxt);
+                if (!state)
+                    return ctxt->error_nomem();
+                typed_function_call_and_store<signature>([state](auto && ... args) {
+                    state->inverse(std::forward<decltype(args)>(args)...);
+                }, ctxt, values);
+            }
+            catch(...)
+            {
+                typed_function_report_exception(ctxt);
+            }
+        }
+
+        static void current(context * ctxt) noexcept
+        {
+            try
+            {
+                if (State * state = find_state(ctxt))
+                {
+                    typed_function_result_to(ctxt, state->result());
+                }
+                else
+                {
+                    State empty;
+                    typed_function_result_to(ctxt, empty.result());
+                }
+            }
+            catch(...)
+            {
+                typed_function_report_exception(ctxt);
+            }
+        }
+
+        static void last(context * ctxt) noexcept
+        {
+            current(ctxt);
+            if (State * state = find_state(ctxt))
+            {
+                state->~State();
+                *static_cast<unsigned char *>(ctxt->aggregate_context(0)) = 0;
+            }
+        }
+
+    private:
+        static constexpr size_t storage_size = sizeof(State) + alignof(State);
+
+        static State * locate(void * storage) noexcept
+        {
+            auto addr = reinterpret_cast<uintptr_t>(storage) + 1;
+            addr = (addr + alignof(State) - 1) & ~uintptr_t(alignof(State) - 1);
+            return reinterpret_cast<State *>(addr);
+        }
+
+        static State * find_state(context * ctxt) noexcept
+        {
+            auto storage = static_cast<unsigned char *>(ctxt->aggregate_context(0));
+            if (!storage || !*storage)
+                return nullptr;
+            return std::launder(locate(storage));
+        }
+
+        static State * get_state(context * ctxt)
+        {
+            auto storage = static_cast<unsigned char *>(ctxt->aggregate_context(int(storage_size)));
+            if (!storage)
+                return nullptr;
+            if (!*storage)
+            {
+                new (locate(storage)) State();
+                *storage = 1;
+            }
+            return std::launder(locate(storage));
+        }
+    };
+
+    /** @endcond */
+}
+
+#endif
+
@@ -16,6 +16,7 @@
 #include "memory_iface.hpp"
 #include "span.hpp"
 
+#include <algorithm>
 #include <type_traits>
 #include <string.h>
 
@@ -26,6 +27,48 @@ namespace thinsqlitepp {
      * @{
      */
 
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+
+    /**
+     * LIMIT and OFFSET of a statement forwarded to a virtual table cursor
+     *
+     * Use index_info::forward_limit_offset() in your @ref vtab::best_index to request them and
+     * extract() in your cursor filter to retrieve them.
+     *
+     * `#include <thinsqlitepp/vtab.hpp>`
+     *
+     * @since SQLite 3.38
+     */
+    struct limit_offset
+    {
+        static constexpr int has_limit = 1;     ///< LIMIT has been forwarded
+        static constexpr int has_offset = 2;    ///< OFFSET has been forwarded
+
+        int64_t limit = -1;     ///< Maximum number of rows to produce. Negative if unlimited.
+        int64_t offset = 0;     ///< Number of rows to skip before producing any
+
+        /**
+         * Retrieves forwarded values from filter arguments
+         *
+         * The values are removed from the end of the arguments and `argc` is adjusted accordingly.
+         *
+         * @param forwarded the value returned from index_info::forward_limit_offset()
+         * @param argc number of filter arguments
+         * @param argv filter arguments
+         */
+        static limit_offset extract(int forwarded, int & argc, value ** argv) noexcept
+        {
+            limit_offset ret;
+            if ((forwarded & has_offset) && argc > 0)
+                ret.offset = std::max(argv[--argc]->get<int64_t>(), int64_t(0));
+            if ((forwarded & has_limit) && argc > 0)
+                ret.limit = argv[--argc]->get<int64_t>();
+            return ret;
+        }
+    };
+
+#endif
+
     /**
      * Virtual Table Indexing Information
      * 
@@ -108,9 +151,81 @@ namespace thinsqlitepp {
              * 
              * Equivalent to ::sqlite3_vtab_in
              */
-            void handle_in(int constraint_idx, bool handle) const noexcept 
+            void handle_in(int constraint_idx, bool handle) const noexcept
                 { sqlite3_vtab_in(this->c_ptr(), constraint_idx, handle); }
 
+            /**
+             * Returns the right-hand side value of a constraint if it is known during planning
+             *
+             * Equivalent to ::sqlite3_vtab_rhs_value
+             *
+             * The value is only known if it is a constant literal in the statement. It has not
+             * been converted according to column affinity.
+             *
+             * @returns the value or `nullptr` if it is not available
+             */
+            value * rhs_value(int constraint_idx) const
+            {
+                sqlite3_value * ret = nullptr;
+                int res = sqlite3_vtab_rhs_value(this->c_ptr(), constraint_idx, &ret);
+                if (res != SQLITE_OK && res != SQLITE_NOTFOUND)
+                    throw exception(res);
+                return value::from(ret);
+            }
+
+            /**
+             * Pass statement's LIMIT and OFFSET to cursor filter
+             *
+             * Call this method at the end of your @ref vtab::best_index after you have assigned
+             * `argvIndex` to all other constraints you use and decided on ORDER BY consumption.
+             *
+             * LIMIT and OFFSET are only forwarded if the rows produced by your cursor are final:
+             * all other constraints must be omitted and ORDER BY (if any) consumed. In this case
+             * LIMIT and OFFSET constraints receive `argvIndex` values after all the others and are
+             * marked omitted. Your filter then must skip OFFSET rows and can stop after LIMIT ones.
+             * Use limit_offset::extract() in your filter to retrieve the values.
+             *
+             * @returns combination of limit_offset::has_limit and limit_offset::has_offset flags
+             * describing what was forwarded. Pass it to filter, for example via @ref set_index_number.
+             *
+             * @since SQLite 3.38
+             */
+            int forward_limit_offset() noexcept
+            {
+                const auto all_constraints = constraints();
+                auto usages = constraints_usage();
+
+                if (!orderbys().empty() && !order_by_consumed())
+                    return 0;
+
+                int last_index = 0;
+                for (size_t i = 0; i < all_constraints.size(); ++i)
+                {
+                    auto op = all_constraints[i].op;
+                    if (op == SQLITE_INDEX_CONSTRAINT_LIMIT || op == SQLITE_INDEX_CONSTRAINT_OFFSET)
+                        continue;
+                    //SQLite would filter out some of the rows we produce
+                    if (!usages[i].omit)
+                        return 0;
+                    last_index = std::max(last_index, usages[i].argvIndex);
+                }
+
+                int ret = 0;
+                for (int op: {SQLITE_INDEX_CONSTRAINT_LIMIT, SQLITE_INDEX_CONSTRAINT_OFFSET})
+                {
+                    for (size_t i = 0; i < all_constraints.size(); ++i)
+                    {
+                        if (all_constraints[i].op != op || !all_constraints[i].usable)
+                            continue;
+                        usages[i].argvIndex = ++last_index;
+                        usages[i].omit = true;
+                        ret |= (op == SQLITE_INDEX_CONSTRAINT_LIMIT ? limit_offset::has_limit : limit_offset::has_offset);
+                        break;
+                    }
+                }
+                return ret;
+            }
+
          #endif
 
         
@@ -295,6 +410,21 @@ namespace thinsqlitepp {
          */
         using index_data_type = void;
 
+        /**
+         * Maximum number of closed cursors kept for reuse
+         *
+         * You can override this default by declaring a different constant in your
+         * derived class.
+         *
+         * If non-zero, cursors closed by SQLite are not destroyed but kept (up to this number)
+         * and handed out again on subsequent @ref xOpen calls without calling @ref open.
+         * A reused cursor keeps whatever state it had so your cursor::filter must fully
+         * re-initialize it. Pooled cursors are destroyed when the table is disconnected or destroyed.
+         *
+         * The default is `0`, meaning cursors are never reused
+         */
+        static constexpr size_t cursor_pool_size = 0;
+
         /**
          * Base class for cursors
          * 
@@ -452,6 +582,8 @@ namespace thinsqlitepp {
              */
             Derived * owner() const noexcept
                 { return static_cast<Derived *>(this->pVtab); }
+        private:
+            cursor * _next_pooled = nullptr;
         };
     public:
         /// Marker type that marks the constructor of @p Derived to be used to create a new table
@@ -575,6 +707,9 @@ namespace thinsqlitepp {
          * do not need to re-define this function. Otherwise re-define it to create cursor in the appropriate
          * way. Your implementation can throw exceptions to indicate errors.
          * 
+         * If @ref cursor_pool_size is non-zero this method is only called when there are no
+         * previously closed cursors available for reuse.
+         *
          * @tparam D Defers resolution of nested data types declared in derived class. This is an 
          * internal implementation detail - your re-defined implementations do not need to be templated.
          * @returns A unique pointer to the cursor instance
@@ -614,10 +749,16 @@ namespace thinsqlitepp {
     private:
         void set_error_message(error & err) const
         {
+            auto message = err.extract_message();
+            //messages without a deleter are not owned (e.g. literals) and SQLite will free zErrMsg
+            if (message && !message.get_deleter())
+            {
+                set_error_message(message.get());
+                return;
+            }
             auto me = const_cast<vtab *>(this);
             if (me->zErrMsg)
                 sqlite3_free(me->zErrMsg);
-            auto message = err.extract_message();
             me->zErrMsg = (char *)message.release();
         }
 
@@ -625,6 +766,9 @@ namespace thinsqlitepp {
             { set_error_message(ex.error()); }
 
         void set_error_message(std::exception & ex) const
+            { set_error_message(ex.what()); }
+
+        void set_error_message(const char * message) const
         {
             auto me = const_cast<vtab *>(this);
             if (me->zErrMsg)
@@ -632,17 +776,22 @@ namespace thinsqlitepp {
                 sqlite3_free(me->zErrMsg);
                 me->zErrMsg = nullptr;
             }
-            auto message = ex.what();
+            me->zErrMsg = copy_error_message(message);
+        }
+
+        static char * copy_error_message(const char * message) noexcept
+        {
             const auto len = strlen(message) + 1;
-            if (char * const ret = (char *)sqlite_allocate_nothrow(len))
-            {
+            char * const ret = (char *)sqlite_allocate_nothrow(len);
+            if (ret)
                 memcpy(ret, message, len);
-                me->zErrMsg = ret;
-            }
+            return ret;
         }
 
         static constexpr void check_requirements();
 
+        void clear_cursor_pool() noexcept;
+
         #define SQLITEPP_DECLARE_IMPL(xname, name) \
             static std::remove_pointer_t<decltype(sqlite3_module::xname)> name##_impl
         #define SQLITEPP_DECLARE_CONDITIONAL_IMPL(xname, name) \
@@ -687,6 +836,9 @@ namespace thinsqlitepp {
         #undef SQLITEPP_DECLARE_IMPL
         #undef SQLITEPP_DECLARE_CONDITIONAL_IMPL
 
+    private:
+        cursor * _pooled_cursors = nullptr;
+        size_t _pooled_cursor_count = 0;
     };
 
     /** @} */
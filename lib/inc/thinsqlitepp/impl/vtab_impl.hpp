@@ -138,7 +138,7 @@ namespace thinsqlitepp
                 requires 
                     (
                         !std::is_void_v<typename T::index_data_type> && 
-                        requires { { cur.filter(int{}, (typename T::index_data_type *)nullptr, int{}, (value **)nullptr) } -> std::same_as<void>; }
+                        requires { { cur.filter(int{}, (typename T::index_data_type)nullptr, int{}, (value **)nullptr) } -> std::same_as<void>; }
                     ) || (
                         std::is_void_v<typename T::index_data_type> && 
                         requires { { cur.filter(int{}, int{}, (value **)nullptr) } -> std::same_as<void>; }
@@ -217,17 +217,15 @@ namespace thinsqlitepp
         catch(exception & ex) 
         {
             auto message = ex.error().extract_message();
-            *err = (char *)message.release();
+            //messages without a deleter are not owned (e.g. literals) and SQLite will free *err
+            if (message && !message.get_deleter())
+                *err = copy_error_message(message.get());
+            else
+                *err = (char *)message.release();
         }
         catch(std::exception & ex)
         {
-            auto message = ex.what();
-            const auto len = strlen(message) + 1;
-            if (char * const ret = (char *)sqlite_allocate_nothrow(len))
-            {
-                memcpy(ret, message, len);
-                *err = ret;
-            }
+            *err = copy_error_message(ex.what());
         }
         return SQLITE_ERROR;
     }
@@ -254,17 +252,15 @@ namespace thinsqlitepp
         catch(exception & ex) 
         {
             auto message = ex.error().extract_message();
-            *err = (char *)message.release();
+            //messages without a deleter are not owned (e.g. literals) and SQLite will free *err
+            if (message && !message.get_deleter())
+                *err = copy_error_message(message.get());
+            else
+                *err = (char *)message.release();
         }
         catch(std::exception & ex)
         {
-            auto message = ex.what();
-            const auto len = strlen(message) + 1;
-            if (char * const ret = (char *)sqlite_allocate_nothrow(len))
-            {
-                memcpy(ret, message, len);
-                *err = ret;
-            }
+            *err = copy_error_message(ex.what());
         }
         return SQLITE_ERROR;
     }
@@ -317,10 +313,22 @@ namespace thinsqlitepp
         SQLITEPP_END_CALLBACK
     }
 
+    template<class Derived>
+    void vtab<Derived>::clear_cursor_pool() noexcept
+    {
+        while (auto pooled = _pooled_cursors)
+        {
+            _pooled_cursors = pooled->_next_pooled;
+            delete static_cast<typename Derived::cursor *>(pooled);
+        }
+        _pooled_cursor_count = 0;
+    }
+
     template<class Derived>
     int vtab<Derived>::disconnect_impl(sqlite3_vtab * vtab)
     {
         auto me = std::unique_ptr<Derived>(static_cast<Derived *>(vtab));
+        me->clear_cursor_pool();
 
         if constexpr (vtab_detector::has_disconnect<Derived>) {
             Derived::disconnect(std::move(me));
@@ -332,6 +340,7 @@ namespace thinsqlitepp
     int vtab<Derived>::destroy_impl(sqlite3_vtab * vtab)
     {
         auto me = std::unique_ptr<Derived>(static_cast<Derived *>(vtab));
+        me->clear_cursor_pool();
 
         if constexpr (vtab_detector::has_destroy<Derived>) {
             Derived::destroy(std::move(me));
@@ -344,6 +353,18 @@ namespace thinsqlitepp
     {
         auto me = static_cast<Derived *>(vtab);
 
+        if constexpr (Derived::cursor_pool_size > 0)
+        {
+            if (auto pooled = me->_pooled_cursors)
+            {
+                me->_pooled_cursors = pooled->_next_pooled;
+                --me->_pooled_cursor_count;
+                pooled->_next_pooled = nullptr;
+                *cursor = static_cast<typename Derived::cursor *>(pooled)->c_ptr();
+                return SQLITE_OK;
+            }
+        }
+
         SQLITEPP_BEGIN_CALLBACK
         {
             std::unique_ptr<typename Derived::cursor> res = me->open();
@@ -357,6 +378,19 @@ namespace thinsqlitepp
     int vtab<Derived>::close_impl(sqlite3_vtab_cursor * cursor)
     {
         auto me = static_cast<typename Derived::cursor *>(cursor);
+
+        if constexpr (Derived::cursor_pool_size > 0)
+        {
+            auto owner = static_cast<Derived *>(cursor->pVtab);
+            if (owner->_pooled_cursor_count < Derived::cursor_pool_size)
+            {
+                me->_next_pooled = owner->_pooled_cursors;
+                owner->_pooled_cursors = me;
+                ++owner->_pooled_cursor_count;
+                return SQLITE_OK;
+            }
+        }
+
         delete me;
         return SQLITE_OK;
     }
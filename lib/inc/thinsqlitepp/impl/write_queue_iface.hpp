@@ -0,0 +1,149 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_WRITE_QUEUE_IFACE_INCLUDED
+#define HEADER_SQLITEPP_WRITE_QUEUE_IFACE_INCLUDED
+
+#include "database_iface.hpp"
+#include "exception_iface.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace thinsqlitepp
+{
+    /**
+     * @addtogroup Utility Utilities
+     * @{
+     */
+
+    /**
+     * Single-writer queue with group commit
+     *
+     * Funnels write operations submitted from any number of threads onto one writer connection
+     * owned by a background thread. Instead of every thread fighting over the database write lock
+     * and paying for its own commit, the writer takes all operations queued so far (up to a limit)
+     * and runs them in a single transaction:
+     * ```
+     * BEGIN IMMEDIATE
+     *   SAVEPOINT write_queue; <operation 1>; RELEASE write_queue
+     *   SAVEPOINT write_queue; <operation 2>; RELEASE write_queue
+     *   ...
+     * COMMIT
+     * ```
+     * An operation that throws is rolled back to its savepoint, so it does not affect the other
+     * operations in the group. The future returned from submit() becomes ready only after the shared
+     * `COMMIT` succeeds, so a ready future means the write is durable. If the commit itself fails
+     * the whole group is rolled back and every future in it receives the commit error.
+     *
+     * ```
+     * write_queue queue(database::open("data.db", SQLITE_OPEN_READWRITE));
+     *
+     * //from any thread
+     * auto id = queue.submit([&](database & db) {
+     *     auto stmt = statement::create(db, "INSERT INTO events(payload) VALUES(?)");
+     *     stmt->bind(1, payload);
+     *     stmt->step();
+     *     return db.last_insert_rowid();
+     * });
+     * use(id.get());
+     * ```
+     *
+     * Operations must not begin, commit or roll back transactions themselves. The writer connection
+     * is only ever used from the background thread, so it can be opened with #SQLITE_OPEN_NOMUTEX.
+     * Configure it (busy timeout, journal mode etc.) before passing it in.
+     *
+     * `#include <thinsqlitepp/write_queue.hpp>`
+     */
+    class write_queue
+    {
+    public:
+        /// Default maximum number of operations committed together
+        static constexpr size_t default_max_batch = 1024;
+    public:
+        /**
+         * Start the writer thread
+         *
+         * @param db writer connection. The queue takes ownership of it.
+         * @param max_batch maximum number of operations to group into one transaction
+         */
+        explicit write_queue(std::unique_ptr<database> db, size_t max_batch = default_max_batch);
+
+        /// Completes all pending operations and stops the writer thread. See close().
+        ~write_queue() noexcept
+            { close(); }
+
+        write_queue(const write_queue &) = delete;
+        write_queue & operator=(const write_queue &) = delete;
+
+        /**
+         * Queue a write operation
+         *
+         * Thread safe.
+         *
+         * @param func callable invoked as `func(database &)` on the writer thread. Its return value,
+         * if any, is delivered via the returned future after the commit.
+         * @throws exception with #SQLITE_MISUSE if the queue has been closed
+         */
+        template<class F>
+        auto submit(F && func) -> std::future<std::decay_t<std::invoke_result_t<std::decay_t<F> &, database &>>>;
+
+        /**
+         * Stop accepting new operations, complete the queued ones and stop the writer thread
+         *
+         * Idempotent. Must not be called concurrently with itself or from inside an operation.
+         */
+        void close() noexcept;
+
+        /// Number of operations waiting to be executed
+        size_t pending() const noexcept;
+    private:
+        class task
+        {
+        public:
+            virtual ~task() noexcept = default;
+
+            //executes the operation, capturing its result or exception
+            virtual void run(database & db) noexcept = 0;
+            //delivers the outcome once the transaction is finished
+            virtual void complete(std::exception_ptr transaction_error) noexcept = 0;
+
+            bool failed() const noexcept
+                { return bool(_error); }
+        protected:
+            std::exception_ptr _error;
+        };
+
+        template<class F, class R>
+        class typed_task;
+
+        void enqueue(std::unique_ptr<task> t);
+        void worker() noexcept;
+        void run_batch(std::vector<std::unique_ptr<task>> & batch) noexcept;
+    private:
+        std::unique_ptr<database> _db;
+        size_t _max_batch;
+        mutable std::mutex _mutex;
+        std::condition_variable _available;
+        std::deque<std::unique_ptr<task>> _queue;
+        bool _closed = false;
+        std::thread _thread;
+    };
+
+    /** @} */
+}
+
+#endif
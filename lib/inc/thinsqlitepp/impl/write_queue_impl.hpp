@@ -0,0 +1,198 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_WRITE_QUEUE_IMPL_INCLUDED
+#define HEADER_SQLITEPP_WRITE_QUEUE_IMPL_INCLUDED
+
+#include "write_queue_iface.hpp"
+
+namespace thinsqlitepp
+{
+    template<class F, class R>
+    class write_queue::typed_task : public write_queue::task
+    {
+    public:
+        template<class Arg>
+        typed_task(Arg && func):
+            _func(std::forward<Arg>(func))
+        {}
+
+        std::future<R> get_future()
+            { return _promise.get_future(); }
+
+        void run(database & db) noexcept override
+        {
+            try
+            {
+                if constexpr (std::is_void_v<R>)
+                    _func(db);
+                else
+                    _result.emplace(_func(db));
+            }
+            catch(...)
+            {
+                _error = std::current_exception();
+            }
+        }
+
+        void complete(std::exception_ptr transaction_error) noexcept override
+        {
+            try
+            {
+                if (_error)
+                    _promise.set_exception(_error);
+                else if (transaction_error)
+                    _promise.set_exception(transaction_error);
+                else if constexpr (std::is_void_v<R>)
+                    _promise.set_value();
+                else
+                    _promise.set_value(std::move(*_result));
+            }
+            catch(...)
+            {
+                //R move constructor threw: nothing else we can do but report it
+                try
+                {
+                    _promise.set_exception(std::current_exception());
+                }
+                catch(...)
+                {
+                    //the promise cannot be satisfied at all: whoever waits gets broken_promise
+                }
+            }
+        }
+    private:
+        struct no_result {};
+
+        F _func;
+        std::promise<R> _promise;
+        std::optional<std::conditional_t<std::is_void_v<R>, no_result, R>> _result;
+    };
+
+    inline write_queue::write_queue(std::unique_ptr<database> db, size_t max_batch):
+        _db(std::move(db)),
+        _max_batch(max_batch ? max_batch : 1)
+    {
+        _thread = std::thread([this]() noexcept { worker(); });
+    }
+
+    template<class F>
+    auto write_queue::submit(F && func) -> std::future<std::decay_t<std::invoke_result_t<std::decay_t<F> &, database &>>>
+    {
+        using result_type = std::decay_t<std::invoke_result_t<std::decay_t<F> &, database &>>;
+        auto t = std::make_unique<typed_task<std::decay_t<F>, result_type>>(std::forward<F>(func));
+        auto ret = t->get_future();
+        enqueue(std::move(t));
+        return ret;
+    }
+
+    inline void write_queue::enqueue(std::unique_ptr<task> t)
+    {
+        {
+            std::lock_guard lock(_mutex);
+            if (_closed)
+                throw exception(SQLITE_MISUSE, error::message_ptr("write_queue is closed"));
+            _queue.push_back(std::move(t));
+        }
+        _available.notify_one();
+    }
+
+    inline void write_queue::close() noexcept
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _closed = true;
+        }
+        _available.notify_one();
+        if (_thread.joinable())
+            _thread.join();
+    }
+
+    inline size_t write_queue::pending() const noexcept
+    {
+        std::lock_guard lock(_mutex);
+        return _queue.size();
+    }
+
+    inline void write_queue::worker() noexcept
+    {
+        std::vector<std::unique_ptr<task>> batch;
+        for ( ; ; )
+        {
+            std::unique_ptr<task> unbatched;
+            std::exception_ptr error;
+            {
+                std::unique_lock lock(_mutex);
+                _available.wait(lock, [this]() { return _closed || !_queue.empty(); });
+                if (_queue.empty())
+                    return;
+                //whatever accumulated while the previous group was committing forms the next group
+                const size_t count = std::min(_queue.size(), _max_batch);
+                try
+                {
+                    batch.reserve(count);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        batch.push_back(std::move(_queue.front()));
+                        _queue.pop_front();
+                    }
+                }
+                catch(...)
+                {
+                    //cannot even group them: fail the first one and try again with the rest
+                    error = std::current_exception();
+                    unbatched = std::move(_queue.front());
+                    _queue.pop_front();
+                }
+            }
+            if (unbatched)
+            {
+                unbatched->complete(error);
+                continue;
+            }
+            run_batch(batch);
+            batch.clear();
+        }
+    }
+
+    inline void write_queue::run_batch(std::vector<std::unique_ptr<task>> & batch) noexcept
+    {
+        std::exception_ptr transaction_error;
+        try
+        {
+            _db->exec("BEGIN IMMEDIATE");
+            try
+            {
+                for (auto & t: batch)
+                {
+                    _db->exec("SAVEPOINT write_queue");
+                    t->run(*_db);
+                    if (t->failed())
+                        _db->exec("ROLLBACK TO write_queue");
+                    _db->exec("RELEASE write_queue");
+                }
+                _db->exec("COMMIT");
+            }
+            catch(...)
+            {
+                transaction_error = std::current_exception();
+                if (!_db->get_autocommit())
+                    sqlite3_exec(_db->c_ptr(), "ROLLBACK", nullptr, nullptr, nullptr);
+            }
+        }
+        catch(...)
+        {
+            transaction_error = std::current_exception();
+        }
+
+        for (auto & t: batch)
+            t->complete(transaction_error);
+    }
+}
+
+#endif
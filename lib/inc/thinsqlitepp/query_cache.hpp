@@ -0,0 +1,20 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_QUERY_CACHE_INCLUDED
+#define HEADER_SQLITEPP_QUERY_CACHE_INCLUDED
+
+#include <thinsqlitepp/impl/query_cache_iface.hpp>
+
+#include <thinsqlitepp/impl/database_impl.hpp>
+#include <thinsqlitepp/impl/statement_impl.hpp>
+#include <thinsqlitepp/impl/dependencies_impl.hpp>
+#include <thinsqlitepp/impl/query_cache_impl.hpp>
+#include <thinsqlitepp/impl/exception_impl.hpp>
+
+#endif
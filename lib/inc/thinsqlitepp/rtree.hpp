@@ -0,0 +1,18 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_RTREE_INCLUDED
+#define HEADER_SQLITEPP_RTREE_INCLUDED
+
+#include <thinsqlitepp/impl/rtree_iface.hpp>
+
+#include <thinsqlitepp/impl/database_impl.hpp>
+#include <thinsqlitepp/impl/rtree_impl.hpp>
+#include <thinsqlitepp/impl/exception_impl.hpp>
+
+#endif
@@ -0,0 +1,17 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_SESSION_INCLUDED
+#define HEADER_SQLITEPP_SESSION_INCLUDED
+
+#include <thinsqlitepp/impl/session_iface.hpp>
+#include <thinsqlitepp/impl/session_impl.hpp>
+
+#include <thinsqlitepp/impl/exception_impl.hpp>
+
+#endif
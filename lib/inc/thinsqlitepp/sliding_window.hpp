@@ -0,0 +1,14 @@
+/*
+ Copyright 2026 Eugene Gershnik
+
+ Use of this source code is governed by a BSD-style
+ license that can be found in the LICENSE file or at
+ https://github.com/gershnik/thinsqlitepp/blob/main/LICENSE
+*/
+
+#ifndef HEADER_SQLITEPP_SLIDING_WINDOW_INCLUDED
+#define HEADER_SQLITEPP_SLIDING_WINDOW_INCLUDED
+
+#include <thinsqlitepp/impl/sliding_window_iface.hpp>
+
+#endif
@@ -11,6 +11,7 @@
 
 #include <thinsqlitepp/impl/statement_iface.hpp>
 #include <thinsqlitepp/impl/row_iterator.hpp>
+#include <thinsqlitepp/impl/named_parameters.hpp>
 #include <thinsqlitepp/impl/statement_impl.hpp>
 
 #include <thinsqlitepp/impl/exception_impl.hpp>
@@ -9,17 +9,33 @@
 #ifndef HEADER_SQLITEPP_SQLITEPP_INCLUDED
 #define HEADER_SQLITEPP_SQLITEPP_INCLUDED
 
+#include <thinsqlitepp/arrow.hpp>
 #include <thinsqlitepp/backup.hpp>
 #include <thinsqlitepp/blob.hpp>
+#include <thinsqlitepp/buffered_vtab.hpp>
+#include <thinsqlitepp/busy_policy.hpp>
+#include <thinsqlitepp/carray.hpp>
+#include <thinsqlitepp/change_capture.hpp>
+#include <thinsqlitepp/column_table.hpp>
 #include <thinsqlitepp/context.hpp>
+#include <thinsqlitepp/csv_table.hpp>
 #include <thinsqlitepp/database.hpp>
+#include <thinsqlitepp/dependencies.hpp>
 #include <thinsqlitepp/exception.hpp>
+#include <thinsqlitepp/fts5.hpp>
 #include <thinsqlitepp/global.hpp>
+#include <thinsqlitepp/memoized.hpp>
 #include <thinsqlitepp/mutex.hpp>
+#include <thinsqlitepp/ordered_vtab.hpp>
+#include <thinsqlitepp/query_cache.hpp>
+#include <thinsqlitepp/rtree.hpp>
+#include <thinsqlitepp/session.hpp>
+#include <thinsqlitepp/sliding_window.hpp>
 #include <thinsqlitepp/snapshot.hpp>
 #include <thinsqlitepp/statement.hpp>
 #include <thinsqlitepp/value.hpp>
 #include <thinsqlitepp/version.hpp>
 #include <thinsqlitepp/vtab.hpp>
+#include <thinsqlitepp/write_queue.hpp>
 
 #endif 
\ No newline at end of file
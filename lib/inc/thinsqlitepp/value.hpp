@@ -10,6 +10,7 @@
 #define HEADER_SQLITEPP_VALUE_INCLUDED
 
 #include <thinsqlitepp/impl/value_iface.hpp>
+#include <thinsqlitepp/impl/owned_value.hpp>
 
 #include <thinsqlitepp/impl/exception_impl.hpp>
 
@@ -0,0 +1,39 @@
+#define THINSQLITEPP_BUILDING_EXTENSION 1
+#include "functions.hpp"
+
+#include <cstring>
+
+using namespace thinsqlitepp;
+
+
+SQLITE_EXTENSION_INIT1
+
+
+extern "C"
+#if defined(_WIN32)
+__declspec(dllexport)
+#elif defined(__GNUC__)
+[[gnu::visibility("default")]]
+#endif
+int sqlite3_approxstats_init(database * db, char ** pzErrMsg, const sqlite3_api_routines * pApi){
+    SQLITE_EXTENSION_INIT2(pApi);
+  
+    try{
+
+        approx_stats::register_functions(*db);
+        return SQLITE_OK;
+    }
+    catch(exception & ex) {
+        *pzErrMsg = const_cast<char *>(ex.error().extract_message().release());
+        return ex.extended_error_code();
+    }
+    catch(std::exception & ex) {
+        auto what = ex.what();
+        auto len = strlen(what) + 1;
+        if (auto message = (char *)sqlite3_malloc(int(len))) {
+            memcpy(message, what, len);
+            *pzErrMsg = message;
+        }
+        return SQLITE_ERROR;
+    }
+}
@@ -0,0 +1,268 @@
+#ifndef HEADER_APPROX_STATS_FUNCTIONS_INCLUDED
+#define HEADER_APPROX_STATS_FUNCTIONS_INCLUDED
+
+#include "sketches.hpp"
+
+#include <thinsqlitepp/database.hpp>
+
+#include <optional>
+#include <string>
+
+// SQL functions of the approx-stats pack. Every sketch comes in 4 flavors:
+//
+//   approx_xxx(value, ...)              - final result over the group
+//   approx_xxx_state(value, ...)        - serialized partial state (BLOB) over the group
+//   approx_xxx_merge(state, ...)        - final result over a group of partial states
+//   approx_xxx_merge_state(state)       - partial state combining a group of partial states
+//
+// So `approx_xxx(x)` over a table gives the same result as `approx_xxx_merge(s)` over the
+// `approx_xxx_state(x)` values of its shards.
+
+namespace approx_stats {
+
+    using namespace thinsqlitepp;
+
+    //MARK: - approx_count_distinct
+
+    template<bool Partial>
+    owned_value distinct_result(const hyperloglog & sketch) {
+        if constexpr (Partial)
+            return owned_value(sketch.serialize());
+        else
+            return owned_value(sketch.estimate());
+    }
+
+    template<bool Partial>
+    struct count_distinct {
+        void step(const value & val) noexcept {
+            if (val.type() != SQLITE_NULL)
+                sketch.add(hash_value(val));
+        }
+        owned_value result() const
+            { return distinct_result<Partial>(sketch); }
+
+        hyperloglog sketch;
+    };
+
+    template<bool Partial>
+    struct count_distinct_merge {
+        void step(std::optional<blob_view> state) {
+            if (state)
+                sketch.merge(hyperloglog::deserialize(*state));
+        }
+        owned_value result() const
+            { return distinct_result<Partial>(sketch); }
+
+        hyperloglog sketch;
+    };
+
+    //MARK: - approx_percentile
+
+    inline double check_quantile(double q) {
+        if (!(q >= 0 && q <= 1))
+            throw std::invalid_argument("percentile must be between 0 and 1");
+        return q;
+    }
+
+    struct percentile {
+        void step(std::optional<double> val, double q) {
+            fraction = check_quantile(q);
+            if (val)
+                digest.add(*val);
+        }
+        std::optional<double> result() {
+            if (digest.empty())
+                return std::nullopt;
+            return digest.quantile(fraction);
+        }
+
+        tdigest digest;
+        double fraction = 0.5;
+    };
+
+    struct percentile_state {
+        void step(std::optional<double> val) {
+            if (val)
+                digest.add(*val);
+        }
+        owned_value result()
+            { return owned_value(digest.serialize()); }
+
+        tdigest digest;
+    };
+
+    struct percentile_merge {
+        void step(std::optional<blob_view> state, double q) {
+            fraction = check_quantile(q);
+            if (state)
+                digest.merge(tdigest::deserialize(*state));
+        }
+        std::optional<double> result() {
+            if (digest.empty())
+                return std::nullopt;
+            return digest.quantile(fraction);
+        }
+
+        tdigest digest;
+        double fraction = 0.5;
+    };
+
+    struct percentile_merge_state {
+        void step(std::optional<blob_view> state) {
+            if (state)
+                digest.merge(tdigest::deserialize(*state));
+        }
+        owned_value result()
+            { return owned_value(digest.serialize()); }
+
+        tdigest digest;
+    };
+
+    //MARK: - approx_top_k
+
+    inline size_t check_k(int64_t k) {
+        if (k < 1 || k > 10000)
+            throw std::invalid_argument("k must be between 1 and 10000");
+        return size_t(k);
+    }
+
+    inline void append_json(std::string & out, const owned_value & val) {
+        static constexpr char hex[] = "0123456789abcdef";
+        switch(val.type()) {
+            case SQLITE_INTEGER: out += std::to_string(val.get<int64_t>()); break;
+            case SQLITE_FLOAT:   out += std::to_string(val.get<double>()); break;
+            case SQLITE_TEXT: {
+                out += '"';
+                for (char c: val.get<std::string_view>()) {
+                    if (c == '"' || c == '\\') {
+                        out += '\\';
+                        out += c;
+                    } else if ((unsigned char)c < 0x20) {
+                        out += "\\u00";
+                        out += hex[(unsigned char)c >> 4];
+                        out += hex[c & 0xF];
+                    } else {
+                        out += c;
+                    }
+                }
+                out += '"';
+                break;
+            }
+            case SQLITE_BLOB: {
+                out += '"';
+                for (auto b: val.get<blob_view>()) {
+                    out += hex[unsigned(b) >> 4];
+                    out += hex[unsigned(b) & 0xF];
+                }
+                out += '"';
+                break;
+            }
+            default: out += "null";
+        }
+    }
+
+    //JSON array of {"value":..., "count":..., "error":...} with highest counts first
+    inline std::string top_k_json(const space_saving & summary, size_t k) {
+        std::string ret = "[";
+        for (auto & c: summary.top(k)) {
+            if (ret.size() > 1)
+                ret += ',';
+            ret += "{\"value\":";
+            append_json(ret, c.item);
+            ret += ",\"count\":" + std::to_string(c.count) + ",\"error\":" + std::to_string(c.error) + '}';
+        }
+        ret += ']';
+        return ret;
+    }
+
+    //number of counters kept for a given k
+    inline size_t top_k_capacity(size_t k)
+        { return std::max(k * 4, size_t(64)); }
+
+    struct top_k {
+        void step(const value & val, int64_t k) {
+            count = check_k(k);
+            if (summary.capacity() == 0)
+                summary = space_saving(top_k_capacity(count));
+            if (val.type() != SQLITE_NULL)
+                summary.add(val);
+        }
+        std::optional<std::string> result() const {
+            if (count == 0)
+                return std::nullopt;
+            return top_k_json(summary, count);
+        }
+
+        space_saving summary;
+        size_t count = 0;
+    };
+
+    struct top_k_state {
+        void step(const value & val, int64_t k) {
+            if (summary.capacity() == 0)
+                summary = space_saving(top_k_capacity(check_k(k)));
+            if (val.type() != SQLITE_NULL)
+                summary.add(val);
+        }
+        owned_value result() const {
+            if (summary.capacity() == 0)
+                return owned_value();
+            return owned_value(summary.serialize());
+        }
+
+        space_saving summary;
+    };
+
+    struct top_k_merge {
+        void step(std::optional<blob_view> state, int64_t k) {
+            count = check_k(k);
+            if (state)
+                summary.merge(space_saving::deserialize(*state));
+        }
+        std::optional<std::string> result() const {
+            if (count == 0)
+                return std::nullopt;
+            return top_k_json(summary, count);
+        }
+
+        space_saving summary;
+        size_t count = 0;
+    };
+
+    struct top_k_merge_state {
+        void step(std::optional<blob_view> state) {
+            if (state)
+                summary.merge(space_saving::deserialize(*state));
+        }
+        owned_value result() const {
+            if (summary.capacity() == 0)
+                return owned_value();
+            return owned_value(summary.serialize());
+        }
+
+        space_saving summary;
+    };
+
+    //MARK: - Registration
+
+    inline void register_functions(database & db) {
+        constexpr int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC;
+
+        db.create_aggregate_function<count_distinct<false>>("approx_count_distinct", flags);
+        db.create_aggregate_function<count_distinct<true>>("approx_count_distinct_state", flags);
+        db.create_aggregate_function<count_distinct_merge<false>>("approx_count_distinct_merge", flags);
+        db.create_aggregate_function<count_distinct_merge<true>>("approx_count_distinct_merge_state", flags);
+
+        db.create_aggregate_function<percentile>("approx_percentile", flags);
+        db.create_aggregate_function<percentile_state>("approx_percentile_state", flags);
+        db.create_aggregate_function<percentile_merge>("approx_percentile_merge", flags);
+        db.create_aggregate_function<percentile_merge_state>("approx_percentile_merge_state", flags);
+
+        db.create_aggregate_function<top_k>("approx_top_k", flags);
+        db.create_aggregate_function<top_k_state>("approx_top_k_state", flags);
+        db.create_aggregate_function<top_k_merge>("approx_top_k_merge", flags);
+        db.create_aggregate_function<top_k_merge_state>("approx_top_k_merge_state", flags);
+    }
+}
+
+#endif
@@ -0,0 +1,43 @@
+#include <iostream>
+
+#include "functions.hpp"
+
+using namespace thinsqlitepp;
+
+int main() {
+    auto db = database::open(":memory:", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+
+    //Registered directly here. The same functions are available as a loadable extension
+    //built from extension.cpp
+    approx_stats::register_functions(*db);
+
+    db->exec("CREATE TABLE events(shard INTEGER, user INTEGER, latency REAL, page TEXT);"
+             "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 200000) "
+             "INSERT INTO events SELECT i % 4, abs(random()) % 50000, (abs(random()) % 100000) / 100.0, "
+             "  'page' || (CASE WHEN i % 3 = 0 THEN 1 ELSE abs(random()) % 1000 END) FROM n");
+
+    auto print = [](row r) {
+        for (auto col: r)
+            std::cout << col.value<std::string_view>() << '\t';
+        std::cout << '\n';
+        return true;
+    };
+
+    std::cout << "exact vs approximate over the whole table:\n";
+    db->exec("SELECT count(DISTINCT user), approx_count_distinct(user), "
+             "       approx_percentile(latency, 0.5), approx_percentile(latency, 0.99) FROM events", print);
+    db->exec("SELECT approx_top_k(page, 3) FROM events", print);
+
+    //partial states computed per shard (e.g. on different machines) and combined afterwards
+    db->exec("CREATE TABLE partials AS SELECT shard, "
+             "  approx_count_distinct_state(user) AS users, "
+             "  approx_percentile_state(latency) AS latencies, "
+             "  approx_top_k_state(page, 3) AS pages "
+             "FROM events GROUP BY shard");
+
+    std::cout << "merged from per-shard states:\n";
+    db->exec("SELECT approx_count_distinct_merge(users), "
+             "       approx_percentile_merge(latencies, 0.5), approx_percentile_merge(latencies, 0.99) FROM partials", print);
+    db->exec("SELECT approx_top_k_merge(pages, 3) FROM partials", print);
+    db->exec("SELECT length(approx_count_distinct_merge_state(users)) FROM partials", print);
+}
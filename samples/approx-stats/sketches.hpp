@@ -0,0 +1,512 @@
+#ifndef HEADER_APPROX_STATS_SKETCHES_INCLUDED
+#define HEADER_APPROX_STATS_SKETCHES_INCLUDED
+
+#include <thinsqlitepp/value.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+// Mergeable approximate summaries used by the approx-stats extension.
+// Each one can be serialized to a blob and restored so partial aggregates computed
+// on different shards can be combined later.
+
+namespace approx_stats {
+
+    using thinsqlitepp::blob_view;
+    using thinsqlitepp::owned_value;
+    using bytes = std::vector<std::byte>;
+
+    //MARK: - Serialization helpers
+
+    class writer {
+    public:
+        explicit writer(uint8_t tag)
+            { put(tag); }
+
+        template<class T>
+        void put(T val) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            auto start = _data.size();
+            _data.resize(start + sizeof(T));
+            memcpy(_data.data() + start, &val, sizeof(T));
+        }
+        void put_bytes(blob_view val) {
+            put(uint32_t(val.size()));
+            _data.insert(_data.end(), val.begin(), val.end());
+        }
+        void put_value(const owned_value & val) {
+            put(uint8_t(val.type()));
+            switch(val.type()) {
+                case SQLITE_INTEGER: put(val.get<int64_t>()); break;
+                case SQLITE_FLOAT:   put(val.get<double>()); break;
+                case SQLITE_TEXT:
+                case SQLITE_BLOB:    put_bytes(val.get<blob_view>()); break;
+            }
+        }
+
+        bytes release()
+            { return std::move(_data); }
+    private:
+        bytes _data;
+    };
+
+    class reader {
+    public:
+        reader(blob_view data, uint8_t tag): _data(data) {
+            if (get<uint8_t>() != tag)
+                throw std::invalid_argument("invalid sketch state");
+        }
+
+        template<class T>
+        T get() {
+            T ret;
+            memcpy(&ret, take(sizeof(T)).data(), sizeof(T));
+            return ret;
+        }
+        blob_view get_bytes()
+            { return take(get<uint32_t>()); }
+        owned_value get_value() {
+            switch(get<uint8_t>()) {
+                case SQLITE_NULL:    return owned_value();
+                case SQLITE_INTEGER: return owned_value(get<int64_t>());
+                case SQLITE_FLOAT:   return owned_value(get<double>());
+                case SQLITE_TEXT:    { auto b = get_bytes(); return owned_value(std::string_view((const char *)b.data(), b.size())); }
+                case SQLITE_BLOB:    return owned_value(get_bytes());
+            }
+            throw std::invalid_argument("invalid sketch state");
+        }
+        bool done() const noexcept
+            { return _pos == _data.size(); }
+    private:
+        blob_view take(size_t size) {
+            if (_data.size() - _pos < size)
+                throw std::invalid_argument("truncated sketch state");
+            auto ret = _data.subspan(_pos, size);
+            _pos += size;
+            return ret;
+        }
+    private:
+        blob_view _data;
+        size_t _pos = 0;
+    };
+
+    //MARK: - Hashing
+
+    inline uint64_t mix(uint64_t x) noexcept {
+        //splitmix64 finalizer
+        x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    inline uint64_t hash_bytes(blob_view data, uint64_t seed) noexcept {
+        uint64_t h = 0xcbf29ce484222325ULL ^ seed;
+        for (auto b: data) {
+            h ^= uint64_t(b);
+            h *= 0x100000001b3ULL;
+        }
+        return mix(h);
+    }
+
+    //Values that compare equal in SQL (e.g. 2 and 2.0) hash the same
+    inline uint64_t hash_value(const thinsqlitepp::value & val) noexcept {
+        switch(val.type()) {
+            case SQLITE_INTEGER:
+                return mix(uint64_t(val.get<int64_t>()));
+            case SQLITE_FLOAT: {
+                double d = val.get<double>();
+                if (d == std::floor(d) && std::abs(d) < 9.2e18)
+                    return mix(uint64_t(int64_t(d)));
+                uint64_t bits;
+                memcpy(&bits, &d, sizeof(bits));
+                return mix(bits ^ 0x9e3779b97f4a7c15ULL);
+            }
+            case SQLITE_TEXT:
+                return hash_bytes(val.get<blob_view>(), 1);
+            case SQLITE_BLOB:
+                return hash_bytes(val.get<blob_view>(), 2);
+        }
+        return 0;
+    }
+
+    //MARK: - HyperLogLog
+
+    // Distinct count estimator with 2^12 one-byte registers: about 1.6% standard error
+    class hyperloglog {
+    public:
+        static constexpr unsigned precision = 12;
+        static constexpr size_t register_count = size_t(1) << precision;
+
+        void add(uint64_t hash) noexcept {
+            size_t idx = size_t(hash >> (64 - precision));
+            uint64_t rest = (hash << precision) | (uint64_t(1) << (precision - 1));
+            uint8_t rank = uint8_t(count_leading_zeros(rest) + 1);
+            _registers[idx] = std::max(_registers[idx], rank);
+        }
+
+        void merge(const hyperloglog & other) noexcept {
+            for (size_t i = 0; i < register_count; ++i)
+                _registers[i] = std::max(_registers[i], other._registers[i]);
+        }
+
+        int64_t estimate() const noexcept {
+            constexpr double m = double(register_count);
+            constexpr double alpha = 0.7213 / (1 + 1.079 / m);
+            double sum = 0;
+            size_t zeros = 0;
+            for (auto reg: _registers) {
+                sum += std::ldexp(1.0, -int(reg));
+                zeros += (reg == 0);
+            }
+            double estimate = alpha * m * m / sum;
+            if (estimate <= 2.5 * m && zeros != 0)
+                estimate = m * std::log(m / double(zeros));
+            return int64_t(std::llround(estimate));
+        }
+
+        bytes serialize() const {
+            writer w(tag);
+            w.put_bytes(blob_view((const std::byte *)_registers.data(), _registers.size()));
+            return w.release();
+        }
+        static hyperloglog deserialize(blob_view data) {
+            reader r(data, tag);
+            auto regs = r.get_bytes();
+            if (regs.size() != register_count || !r.done())
+                throw std::invalid_argument("invalid HyperLogLog state");
+            hyperloglog ret;
+            memcpy(ret._registers.data(), regs.data(), register_count);
+            return ret;
+        }
+    private:
+        static unsigned count_leading_zeros(uint64_t val) noexcept {
+            unsigned ret = 0;
+            for (uint64_t mask = uint64_t(1) << 63; mask && !(val & mask); mask >>= 1)
+                ++ret;
+            return ret;
+        }
+    private:
+        static constexpr uint8_t tag = 'H';
+        std::array<uint8_t, register_count> _registers{};
+    };
+
+    //MARK: - t-digest
+
+    // Merging t-digest (Dunning & Ertl) using the k1 (arcsine) scale function
+    class tdigest {
+    public:
+        explicit tdigest(double compression = 100): _compression(compression)
+        {}
+
+        void add(double val, double weight = 1) {
+            if (std::isnan(val))
+                return;
+            _buffer.push_back({val, weight});
+            if (_buffer.size() >= buffer_limit())
+                compress();
+        }
+
+        void merge(const tdigest & other) {
+            for (auto & c: other._centroids)
+                add(c.mean, c.weight);
+            for (auto & c: other._buffer)
+                add(c.mean, c.weight);
+        }
+
+        bool empty() const noexcept
+            { return _centroids.empty() && _buffer.empty(); }
+
+        double quantile(double q) {
+            compress();
+            if (_centroids.size() == 1)
+                return _centroids[0].mean;
+            q = std::clamp(q, 0.0, 1.0);
+            double target = q * _total;
+            double cumulative = 0;
+            for (size_t i = 0; i < _centroids.size(); ++i) {
+                auto & c = _centroids[i];
+                double mid = cumulative + c.weight / 2;
+                if (target < mid) {
+                    if (i == 0)
+                        return c.mean;
+                    auto & prev = _centroids[i - 1];
+                    double prev_mid = cumulative - prev.weight / 2;
+                    return prev.mean + (c.mean - prev.mean) * (target - prev_mid) / (mid - prev_mid);
+                }
+                cumulative += c.weight;
+            }
+            return _centroids.back().mean;
+        }
+
+        bytes serialize() {
+            compress();
+            writer w(tag);
+            w.put(_compression);
+            w.put(uint32_t(_centroids.size()));
+            for (auto & c: _centroids) {
+                w.put(c.mean);
+                w.put(c.weight);
+            }
+            return w.release();
+        }
+        static tdigest deserialize(blob_view data) {
+            reader r(data, tag);
+            tdigest ret(r.get<double>());
+            if (!(ret._compression >= 10 && ret._compression <= 10000))
+                throw std::invalid_argument("invalid t-digest state");
+            auto count = r.get<uint32_t>();
+            for (uint32_t i = 0; i < count; ++i) {
+                double mean = r.get<double>();
+                double weight = r.get<double>();
+                ret.add(mean, weight);
+            }
+            if (!r.done())
+                throw std::invalid_argument("invalid t-digest state");
+            return ret;
+        }
+    private:
+        struct centroid {
+            double mean;
+            double weight;
+        };
+
+        size_t buffer_limit() const noexcept
+            { return size_t(_compression) * 5; }
+
+        double scale(double q) const noexcept
+            { return _compression / (2 * 3.14159265358979323846) * std::asin(2 * q - 1); }
+
+        void compress() {
+            if (_buffer.empty())
+                return;
+            _buffer.insert(_buffer.end(), _centroids.begin(), _centroids.end());
+            std::sort(_buffer.begin(), _buffer.end(), [](const centroid & lhs, const centroid & rhs) {
+                return lhs.mean < rhs.mean;
+            });
+            double total = 0;
+            for (auto & c: _buffer)
+                total += c.weight;
+
+            _centroids.clear();
+            centroid current = _buffer.front();
+            double so_far = 0;
+            double k_limit = scale(0) + 1;
+            for (size_t i = 1; i < _buffer.size(); ++i) {
+                auto & next = _buffer[i];
+                double q = (so_far + current.weight + next.weight) / total;
+                if (scale(q) <= k_limit) {
+                    current.weight += next.weight;
+                    current.mean += (next.mean - current.mean) * next.weight / current.weight;
+                } else {
+                    so_far += current.weight;
+                    _centroids.push_back(current);
+                    k_limit = scale(so_far / total) + 1;
+                    current = next;
+                }
+            }
+            _centroids.push_back(current);
+            _total = total;
+            _buffer.clear();
+        }
+    private:
+        static constexpr uint8_t tag = 'T';
+        double _compression;
+        double _total = 0;
+        std::vector<centroid> _centroids;
+        std::vector<centroid> _buffer;
+    };
+
+    //MARK: - Space-saving top-K
+
+    // Metwally et al. space-saving summary. Keeps `capacity` counters; every item with true
+    // frequency above total/capacity is guaranteed to be present.
+    // Counters are kept in an indexed min-heap by count so both incrementing an item and
+    // replacing the minimal one cost O(log capacity).
+    class space_saving {
+    public:
+        struct counter {
+            owned_value item;
+            int64_t count;
+            int64_t error;
+        };
+
+        explicit space_saving(size_t capacity = 0): _capacity(capacity)
+        {}
+
+        size_t capacity() const noexcept
+            { return _capacity; }
+
+        void add(const thinsqlitepp::value & val, int64_t count = 1) {
+            add(owned_value(val), count, 0);
+        }
+
+        // Mergeable summaries (Agarwal et al.): an item missing from a full summary could have
+        // been counted up to its minimal count there, so that is added to both its count and
+        // error. Then only the `capacity` largest counters are kept.
+        void merge(const space_saving & other) {
+            if (_capacity == 0)
+                _capacity = other._capacity;
+            int64_t min = min_count();
+            int64_t other_min = other.min_count();
+
+            std::vector<counter> merged;
+            merged.reserve(_counters.size() + other._counters.size());
+            for (auto & c: _counters) {
+                if (auto it = other._index.find(c.item); it != other._index.end()) {
+                    auto & oc = other._counters[it->second];
+                    merged.push_back({c.item, c.count + oc.count, c.error + oc.error});
+                } else {
+                    merged.push_back({c.item, c.count + other_min, c.error + other_min});
+                }
+            }
+            for (auto & oc: other._counters) {
+                if (_index.find(oc.item) == _index.end())
+                    merged.push_back({oc.item, oc.count + min, oc.error + min});
+            }
+            if (merged.size() > _capacity) {
+                std::nth_element(merged.begin(), merged.begin() + _capacity, merged.end(), [](const counter & lhs, const counter & rhs) {
+                    return lhs.count > rhs.count;
+                });
+                merged.resize(_capacity);
+            }
+
+            _counters = std::move(merged);
+            _index.clear();
+            for (size_t i = 0; i < _counters.size(); ++i)
+                _index.emplace(_counters[i].item, i);
+            _heap.resize(_counters.size());
+            _positions.resize(_counters.size());
+            for (size_t i = 0; i < _heap.size(); ++i)
+                _heap[i] = _positions[i] = i;
+            for (size_t i = _heap.size() / 2; i-- > 0; )
+                sift_down(i);
+        }
+
+        //highest counts first
+        std::vector<counter> top(size_t k) const {
+            std::vector<counter> ret(_counters);
+            std::sort(ret.begin(), ret.end(), [](const counter & lhs, const counter & rhs) {
+                return lhs.count > rhs.count;
+            });
+            if (ret.size() > k)
+                ret.resize(k);
+            return ret;
+        }
+
+        bytes serialize() const {
+            writer w(tag);
+            w.put(uint32_t(_capacity));
+            w.put(uint32_t(_counters.size()));
+            for (auto & c: _counters) {
+                w.put_value(c.item);
+                w.put(c.count);
+                w.put(c.error);
+            }
+            return w.release();
+        }
+        static space_saving deserialize(blob_view data) {
+            reader r(data, tag);
+            space_saving ret(r.get<uint32_t>());
+            auto count = r.get<uint32_t>();
+            if (ret._capacity == 0 || count > ret._capacity)
+                throw std::invalid_argument("invalid top-k state");
+            for (uint32_t i = 0; i < count; ++i) {
+                auto item = r.get_value();
+                auto cnt = r.get<int64_t>();
+                auto err = r.get<int64_t>();
+                ret.add(std::move(item), cnt, err);
+            }
+            if (!r.done())
+                throw std::invalid_argument("invalid top-k state");
+            return ret;
+        }
+    private:
+        void add(owned_value item, int64_t count, int64_t error) {
+            if (auto it = _index.find(item); it != _index.end()) {
+                auto & c = _counters[it->second];
+                c.count += count;
+                c.error += error;
+                sift_down(_positions[it->second]);
+                return;
+            }
+            if (_counters.size() < _capacity) {
+                size_t slot = _counters.size();
+                _index.emplace(item, slot);
+                _counters.push_back({std::move(item), count, error});
+                _heap.push_back(slot);
+                _positions.push_back(slot);
+                sift_up(slot);
+                return;
+            }
+            if (_heap.empty())
+                return;
+            size_t slot = _heap.front();
+            auto & victim = _counters[slot];
+            //reuse the index node of the evicted item
+            auto node = _index.extract(victim.item);
+            node.key() = item;
+            _index.insert(std::move(node));
+            victim.error = victim.count + error;
+            victim.count += count;
+            victim.item = std::move(item);
+            sift_down(0);
+        }
+
+        //the count an item not present here could have. 0 if nothing was ever evicted
+        int64_t min_count() const noexcept {
+            if (_counters.size() < _capacity || _heap.empty())
+                return 0;
+            return _counters[_heap.front()].count;
+        }
+
+        int64_t count_at(size_t pos) const noexcept
+            { return _counters[_heap[pos]].count; }
+
+        void swap_at(size_t lhs, size_t rhs) noexcept {
+            std::swap(_heap[lhs], _heap[rhs]);
+            _positions[_heap[lhs]] = lhs;
+            _positions[_heap[rhs]] = rhs;
+        }
+
+        void sift_up(size_t pos) noexcept {
+            while (pos > 0) {
+                size_t parent = (pos - 1) / 2;
+                if (count_at(parent) <= count_at(pos))
+                    break;
+                swap_at(parent, pos);
+                pos = parent;
+            }
+        }
+
+        void sift_down(size_t pos) noexcept {
+            for ( ; ; ) {
+                size_t smallest = pos;
+                size_t left = 2 * pos + 1;
+                size_t right = left + 1;
+                if (left < _heap.size() && count_at(left) < count_at(smallest))
+                    smallest = left;
+                if (right < _heap.size() && count_at(right) < count_at(smallest))
+                    smallest = right;
+                if (smallest == pos)
+                    break;
+                swap_at(pos, smallest);
+                pos = smallest;
+            }
+        }
+    private:
+        static constexpr uint8_t tag = 'K';
+        size_t _capacity;
+        std::vector<counter> _counters;             //never move once added, evicted ones are reused
+        std::unordered_map<owned_value, size_t> _index; //item -> index in _counters
+        std::vector<size_t> _heap;                  //indices in _counters ordered as min-heap by count
+        std::vector<size_t> _positions;             //index in _counters -> position in _heap
+    };
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/database.hpp>
+#include <thinsqlitepp/sliding_window.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace thinsqlitepp;
+
+TEST_SUITE_BEGIN("aggregate");
+
+namespace
+{
+    struct joined
+    {
+        static inline int alive = 0;
+
+        joined() { ++alive; }
+        ~joined() noexcept { --alive; }
+
+        void step(std::optional<std::string_view> val)
+        {
+            if (val)
+                items.emplace_back(*val);
+        }
+        std::optional<std::string> result() const
+        {
+            if (items.empty())
+                return std::nullopt;
+            std::string ret;
+            for (auto it = items.rbegin(); it != items.rend(); ++it)
+                ret += *it;
+            return ret;
+        }
+
+        std::vector<std::string> items;
+    };
+
+    struct failing
+    {
+        void step(int val)
+        {
+            if (val > 2)
+                throw std::runtime_error("too big");
+        }
+        int result() const noexcept { return 0; }
+    };
+
+    std::string collect(database & db, const char * sql)
+    {
+        std::string ret;
+        db.exec(sql, [&](row r) noexcept {
+            ret += r[0].type() == SQLITE_NULL ? "null" : std::string(r[0].value<std::string_view>());
+            ret += ',';
+            return true;
+        });
+        return ret;
+    }
+}
+
+TEST_CASE( "typed aggregate" ) {
+
+    static_assert(is_typed_aggregate<joined>);
+    static_assert(!is_typed_aggregate<int>);
+    static_assert(!is_typed_window<joined>);
+    static_assert(is_typed_window<sliding_sum<int64_t>>);
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS foo; CREATE TABLE foo(grp INTEGER, name TEXT);"
+             "INSERT INTO foo VALUES (1, 'a'), (1, 'b'), (2, 'c'), (2, NULL), (3, NULL)");
+
+    db->create_aggregate_function<joined>("rjoin", SQLITE_UTF8);
+    CHECK(collect(*db, "SELECT rjoin(name) FROM foo GROUP BY grp ORDER BY grp") == "ba,c,null,");
+    CHECK(collect(*db, "SELECT rjoin(name) FROM foo WHERE 0") == "null,");
+    CHECK(joined::alive == 0);
+
+    db->create_aggregate_function<failing>("failing");
+    CHECK_THROWS_AS(db->exec("SELECT failing(grp) FROM foo"), thinsqlitepp::exception);
+    CHECK(collect(*db, "SELECT failing(grp) FROM foo WHERE grp < 3") == "0,");
+}
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 25, 0)
+
+TEST_CASE( "sliding window functions" ) {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS foo; CREATE TABLE foo(id INTEGER PRIMARY KEY, val INTEGER, real REAL)");
+    {
+        auto insert = statement::create(*db, "INSERT INTO foo(val, real) VALUES (?, ?)");
+        uint32_t seed = 17;
+        for (int i = 0; i < 500; ++i)
+        {
+            seed = seed * 1664525 + 1013904223;
+            if (seed % 7 == 0)
+                insert->bind(1, nullptr);
+            else
+                insert->bind(1, int64_t(seed % 1000) - 500);
+            insert->bind(2, double(seed % 97) / 4);
+            while(insert->step()) {}
+            insert->reset();
+        }
+    }
+
+    db->create_window_function<sliding_sum<int64_t>>("fast_sum");
+    db->create_window_function<sliding_min<int64_t>>("fast_min");
+    db->create_window_function<sliding_max<int64_t>>("fast_max");
+    db->create_window_function<sliding_max<double>>("fast_max_real");
+
+    for (const char * frame: {"ROWS BETWEEN 7 PRECEDING AND CURRENT ROW",
+                              "ROWS BETWEEN 3 PRECEDING AND 5 FOLLOWING",
+                              "ROWS BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW",
+                              "ROWS BETWEEN 2 FOLLOWING AND 4 FOLLOWING"})
+    {
+        std::string window = std::string(" OVER (ORDER BY id ") + frame + ")";
+        auto sql = [&](const char * func, const char * col) {
+            return std::string("SELECT ") + func + "(" + col + ")" + window + " FROM foo";
+        };
+        CHECK(collect(*db, sql("fast_sum", "val").c_str()) == collect(*db, sql("sum", "val").c_str()));
+        CHECK(collect(*db, sql("fast_min", "val").c_str()) == collect(*db, sql("min", "val").c_str()));
+        CHECK(collect(*db, sql("fast_max", "val").c_str()) == collect(*db, sql("max", "val").c_str()));
+        CHECK(collect(*db, sql("fast_max_real", "real").c_str()) == collect(*db, sql("max", "real").c_str()));
+    }
+    
+    CHECK(collect(*db, "SELECT fast_sum(val) FROM foo WHERE 0") == "null,");
+}
+
+#endif
+
+TEST_SUITE_END();
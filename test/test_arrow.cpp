@@ -0,0 +1,280 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/arrow.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace thinsqlitepp;
+
+TEST_SUITE_BEGIN("arrow");
+
+namespace
+{
+    std::string collect(database & db, const std::string & sql)
+    {
+        std::string ret;
+        db.exec(sql, [&](row r) noexcept {
+            for (int i = 0; i < r.size(); ++i)
+            {
+                ret += r[i].type() == SQLITE_NULL ? "null" : std::string(r[i].value<std::string_view>());
+                ret += i + 1 < r.size() ? '|' : '\n';
+            }
+            return true;
+        });
+        return ret;
+    }
+
+    std::unique_ptr<database> make_db()
+    {
+        auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+        db->exec("CREATE TEMP TABLE items(id INTEGER, price REAL, name TEXT, data BLOB);"
+                 "INSERT INTO items VALUES(1, 1.5, 'apple', x'01'), (2, NULL, 'pear', NULL), (3, 0.5, NULL, x''),"
+                 "(4, 3, 'fig', x'0203'), (NULL, 2.25, 'kiwi', x'04')");
+        return db;
+    }
+
+    bool is_valid(const ArrowArray * array, int64_t idx)
+    {
+        auto validity = static_cast<const uint8_t *>(array->buffers[0]);
+        return !validity || (validity[idx / 8] & (1 << (idx % 8)));
+    }
+
+    std::string_view large_string(const ArrowArray * array, int64_t idx)
+    {
+        auto offsets = static_cast<const int64_t *>(array->buffers[1]);
+        return std::string_view(static_cast<const char *>(array->buffers[2]) + offsets[idx], size_t(offsets[idx + 1] - offsets[idx]));
+    }
+
+    //a hand-made stream with a single batch exercising formats the exporter does not produce
+    struct manual_stream
+    {
+        int32_t numbers[5] = {0, 0, 10, -20, 30};
+        uint8_t numbers_validity = 0b10100;
+        uint8_t flags = 0b0100;
+        int32_t offsets[5] = {0, 1, 3, 3, 6};
+        char text[6] = {'x', 'a', 'b', 'c', 'd', 'e'};
+        const void * number_buffers[2] = {&numbers_validity, numbers};
+        const void * flag_buffers[2] = {nullptr, &flags};
+        const void * text_buffers[3] = {nullptr, offsets, text};
+        const void * parent_buffers[1] = {nullptr};
+        ArrowArray children[3];
+        ArrowArray * child_ptrs[3] = {&children[0], &children[1], &children[2]};
+        ArrowSchema child_schemas[3];
+        ArrowSchema * child_schema_ptrs[3] = {&child_schemas[0], &child_schemas[1], &child_schemas[2]};
+        const char * text_format = "u";
+        bool sent = false;
+        int released = 0;
+
+        static void release_array(ArrowArray * array)
+        {
+            array->release = nullptr;
+        }
+        static void release_schema(ArrowSchema * schema)
+        {
+            schema->release = nullptr;
+        }
+
+        ArrowArrayStream stream()
+        {
+            ArrowArrayStream ret;
+            ret.get_schema = [](ArrowArrayStream * s, ArrowSchema * out) {
+                auto me = static_cast<manual_stream *>(s->private_data);
+                const char * formats[3] = {"i", "b", me->text_format};
+                const char * names[3] = {"num", "flag", "str"};
+                for (int i = 0; i < 3; ++i)
+                    me->child_schemas[i] = {formats[i], names[i], nullptr, ARROW_FLAG_NULLABLE, 0, nullptr, nullptr, release_schema, nullptr};
+                *out = {"+s", "", nullptr, 0, 3, me->child_schema_ptrs, nullptr, release_schema, nullptr};
+                return 0;
+            };
+            ret.get_next = [](ArrowArrayStream * s, ArrowArray * out) {
+                auto me = static_cast<manual_stream *>(s->private_data);
+                if (me->sent)
+                {
+                    out->release = nullptr;
+                    return 0;
+                }
+                me->sent = true;
+                //the batch skips the first element of every column and numbers skip one more
+                me->children[0] = {3, 1, 1, 2, 0, me->number_buffers, nullptr, nullptr, release_array, nullptr};
+                me->children[1] = {3, 0, 0, 2, 0, me->flag_buffers, nullptr, nullptr, release_array, nullptr};
+                me->children[2] = {3, 0, 0, 3, 0, me->text_buffers, nullptr, nullptr, release_array, nullptr};
+                *out = {3, 0, 1, 1, 3, me->parent_buffers, me->child_ptrs, nullptr, release_array, nullptr};
+                return 0;
+            };
+            ret.get_last_error = [](ArrowArrayStream *) -> const char * {
+                return nullptr;
+            };
+            ret.release = [](ArrowArrayStream * s) {
+                ++static_cast<manual_stream *>(s->private_data)->released;
+                s->release = nullptr;
+            };
+            ret.private_data = this;
+            return ret;
+        }
+    };
+}
+
+TEST_CASE( "arrow export" ) {
+
+    auto db = make_db();
+    auto stmt = statement::create(*db, "SELECT id, price, name, data, id * 2 AS twice, NULL AS empty FROM items");
+
+    arrow_exporter exporter(*stmt, 3);
+    ArrowSchema schema;
+    exporter.export_schema(&schema);
+    REQUIRE(schema.release);
+    CHECK(std::string_view(schema.format) == "+s");
+    REQUIRE(schema.n_children == 6);
+    std::string formats, names;
+    for (int i = 0; i < 6; ++i)
+    {
+        formats += schema.children[i]->format;
+        names += schema.children[i]->name + std::string(" ");
+        CHECK(schema.children[i]->flags == ARROW_FLAG_NULLABLE);
+    }
+    CHECK(formats == "lgUZlU");
+    CHECK(names == "id price name data twice empty ");
+
+    //children can be moved out and outlive the parent
+    ArrowSchema moved = *schema.children[2];
+    schema.children[2]->release = nullptr;
+    schema.release(&schema);
+    CHECK(!schema.release);
+    CHECK(std::string_view(moved.name) == "name");
+    moved.release(&moved);
+
+    ArrowArray batch;
+    REQUIRE(exporter.export_batch(&batch));
+    CHECK(batch.length == 3);
+    CHECK(batch.n_children == 6);
+    {
+        auto ids = batch.children[0];
+        CHECK(ids->null_count == 0);
+        CHECK(static_cast<const int64_t *>(ids->buffers[1])[2] == 3);
+
+        auto prices = batch.children[1];
+        CHECK(prices->null_count == 1);
+        CHECK(is_valid(prices, 0));
+        CHECK_FALSE(is_valid(prices, 1));
+        CHECK(static_cast<const double *>(prices->buffers[1])[2] == 0.5);
+
+        auto names_col = batch.children[2];
+        CHECK(large_string(names_col, 0) == "apple");
+        CHECK(large_string(names_col, 1) == "pear");
+        CHECK_FALSE(is_valid(names_col, 2));
+
+        auto data = batch.children[3];
+        CHECK(large_string(data, 0) == "\x01");
+        CHECK_FALSE(is_valid(data, 1));
+        CHECK(is_valid(data, 2));
+        CHECK(large_string(data, 2).empty());
+
+        CHECK(batch.children[5]->null_count == 3);
+    }
+    batch.release(&batch);
+    CHECK(!batch.release);
+
+    REQUIRE(exporter.export_batch(&batch));
+    CHECK(batch.length == 2);
+    CHECK(static_cast<const int64_t *>(batch.children[4]->buffers[1])[0] == 8);
+    CHECK_FALSE(is_valid(batch.children[0], 1));
+    batch.release(&batch);
+
+    CHECK_FALSE(exporter.export_batch(&batch));
+}
+
+TEST_CASE( "arrow export type mismatch" ) {
+
+    auto db = make_db();
+
+    //the column type comes from the first row so the text value in the second one does not fit
+    auto stmt = statement::create(*db, "SELECT CASE id WHEN 2 THEN 'two' ELSE id END AS mixed FROM items");
+    arrow_exporter exporter(*stmt);
+    ArrowArray batch;
+    batch.release = nullptr;
+    try
+    {
+        exporter.export_batch(&batch);
+        CHECK(false);
+    }
+    catch(::thinsqlitepp::exception & ex)
+    {
+        CHECK(ex.primary_error_code() == SQLITE_MISMATCH);
+    }
+    CHECK(!batch.release);
+
+    ArrowArrayStream stream;
+    arrow_exporter::export_stream(statement::create(*db, "SELECT CASE id WHEN 2 THEN 'two' ELSE id END FROM items"), &stream);
+    CHECK(stream.get_next(&stream, &batch) == EIO);
+    CHECK(std::string_view(stream.get_last_error(&stream)).find("TEXT value") != std::string_view::npos);
+    stream.release(&stream);
+}
+
+TEST_CASE( "arrow stream round trip" ) {
+
+    auto db = make_db();
+    ArrowArrayStream stream;
+    arrow_exporter::export_stream(statement::create(*db, "SELECT rowid AS n, * FROM items ORDER BY rowid"), &stream, 2);
+
+    {
+        arrow_source source(&stream);
+        CHECK(!stream.release);
+        CHECK(source.columns() == 5);
+        CHECK(source.declaration() == "CREATE TABLE x(\"n\" INTEGER, \"id\" INTEGER, \"price\" REAL, \"name\" TEXT, \"data\" BLOB)");
+
+        arrow_table::create_module(*db, "imported", &source);
+    #if SQLITE_VERSION_NUMBER < SQLITEPP_SQLITE_VERSION(3, 9, 0)
+        db->exec("CREATE VIRTUAL TABLE temp.imported USING imported");
+    #endif
+
+        //a lookup only reads as far as needed
+        CHECK(collect(*db, "SELECT name FROM imported WHERE rowid = 2") == "null\n");
+        CHECK_FALSE(source.complete());
+        CHECK(source.rows() == 4);
+
+        CHECK(collect(*db, "SELECT rowid, n, id, price, name, hex(data) FROM imported") ==
+              "0|1|1|1.5|apple|01\n"
+              "1|2|2|null|pear|\n"
+              "2|3|3|0.5|null|\n"
+              "3|4|4|3.0|fig|0203\n"
+              "4|5|null|2.25|kiwi|04\n");
+        CHECK(source.complete());
+        CHECK(collect(*db, "SELECT count(*), sum(id) FROM imported WHERE price > 1") == "3|5\n");
+        CHECK(collect(*db, "SELECT name FROM imported WHERE rowid = 4.0") == "kiwi\n");
+        CHECK(collect(*db, "SELECT name FROM imported WHERE rowid = 5").empty());
+        CHECK(collect(*db, "SELECT a.name FROM imported a JOIN items b ON a.id = b.id WHERE b.price = 3") == "fig\n");
+
+        db.reset();
+    }
+}
+
+TEST_CASE( "arrow import formats" ) {
+
+    manual_stream manual;
+    auto stream = manual.stream();
+    {
+        arrow_source source(&stream);
+        auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+        arrow_table::create_module(*db, "manual", &source);
+    #if SQLITE_VERSION_NUMBER < SQLITEPP_SQLITE_VERSION(3, 9, 0)
+        db->exec("CREATE VIRTUAL TABLE temp.manual USING manual");
+    #endif
+        CHECK(collect(*db, "SELECT num, flag, str, typeof(flag) FROM manual") ==
+              "10|0|ab|integer\n"
+              "null|1||integer\n"
+              "30|0|cde|integer\n");
+    }
+    CHECK(manual.released == 1);
+
+    manual_stream unsupported;
+    unsupported.text_format = "tdD";
+    stream = unsupported.stream();
+    CHECK_THROWS_AS(arrow_source{&stream}, thinsqlitepp::exception);
+    CHECK(unsupported.released == 1);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,250 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/buffered_vtab.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace thinsqlitepp;
+
+TEST_SUITE_BEGIN("buffered_vtab");
+
+namespace
+{
+    struct item
+    {
+        std::string name;
+        int64_t qty;
+    };
+    using item_store = std::map<int64_t, item>;
+
+    struct store_state
+    {
+        item_store items;
+        std::vector<std::string> batches;
+    };
+
+    class store_table : public buffered_vtab<store_table>
+    {
+    public:
+        using constructor_data_type = store_state *;
+
+        store_table(database * db, store_state * state, int /*argc*/, const char * const * /*argv*/):
+            _state(state)
+        {
+            db->declare_vtab("CREATE TABLE _ (name TEXT, qty INTEGER)");
+        }
+
+        int64_t update(int argc, value ** argv)
+        {
+            if (argc > 1 && argv[3]->get<int64_t>() < 0)
+                throw exception(SQLITE_CONSTRAINT, error::message_ptr("negative quantity"));
+            return buffered_vtab::update(argc, argv);
+        }
+
+        void apply_batch(span<const change> changes)
+        {
+            std::string batch;
+            for (auto & ch: changes)
+            {
+                switch(ch.kind)
+                {
+                    case change_kind::insert: batch += "+"; break;
+                    case change_kind::update: batch += "="; break;
+                    case change_kind::remove: batch += "-"; break;
+                }
+                batch += std::to_string(ch.rowid) + " ";
+                if (ch.kind == change_kind::remove)
+                    _state->items.erase(ch.rowid);
+                else
+                    _state->items[ch.rowid] = item{std::string(ch.values[0].get<std::string_view>()), ch.values[1].get<int64_t>()};
+            }
+            _state->batches.push_back(batch);
+        }
+
+        int64_t new_rowid()
+        {
+            int64_t ret = _state->items.empty() ? 1 : _state->items.rbegin()->first + 1;
+            if (!pending().empty())
+                ret = std::max(ret, pending().rbegin()->first + 1);
+            return ret;
+        }
+
+        //overlays pending changes over the store
+        class cursor : public buffered_vtab::cursor
+        {
+        public:
+            using buffered_vtab::cursor::cursor;
+
+            void filter(int /*idx*/, int /*argc*/, value ** /*argv*/)
+            {
+                _in_store = true;
+                _stored = owner()->_state->items.begin();
+                _pending = owner()->pending().begin();
+                settle();
+            }
+            bool eof() const noexcept
+                { return !_in_store && _pending == owner()->pending().end(); }
+            void next()
+            {
+                if (_in_store)
+                    ++_stored;
+                else
+                    ++_pending;
+                settle();
+            }
+            int64_t rowid() const
+                { return _in_store ? _stored->first : _pending->first; }
+            void column(context & ctxt, int idx) const
+            {
+                const pending_row * row = _in_store ? owner()->find_pending(_stored->first) : &_pending->second;
+                if (row)
+                    result(ctxt, (*row->values)[size_t(idx)]);
+                else if (idx == 0)
+                    ctxt.result(_stored->second.name);
+                else
+                    ctxt.result(_stored->second.qty);
+            }
+        private:
+            void settle()
+            {
+                if (_in_store)
+                {
+                    for ( ; _stored != owner()->_state->items.end(); ++_stored)
+                    {
+                        auto row = owner()->find_pending(_stored->first);
+                        if (!row || row->values)
+                            return;
+                    }
+                    _in_store = false;
+                }
+                while (_pending != owner()->pending().end() && _pending->second.in_store)
+                    ++_pending;
+            }
+        private:
+            bool _in_store = true;
+            item_store::const_iterator _stored;
+            pending_map::const_iterator _pending;
+        };
+
+    private:
+        store_state * _state;
+    };
+
+    std::string collect(database & db, const std::string & sql)
+    {
+        std::string ret;
+        db.exec(sql, [&](row r) noexcept {
+            for (int i = 0; i < r.size(); ++i)
+            {
+                ret += r[i].type() == SQLITE_NULL ? "null" : std::string(r[i].value<std::string_view>());
+                ret += i + 1 < r.size() ? '|' : '\n';
+            }
+            return true;
+        });
+        return ret;
+    }
+
+    struct fixture
+    {
+        store_state state;
+        std::unique_ptr<database> db;
+
+        fixture()
+        {
+            state.items[1] = {"apple", 3};
+            state.items[2] = {"pear", 5};
+
+            db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+            store_table::create_module(*db, "store", &state);
+            db->exec("CREATE VIRTUAL TABLE temp.items USING store");
+        }
+
+        std::string items()
+            { return collect(*db, "SELECT rowid, name, qty FROM items ORDER BY rowid"); }
+    };
+}
+
+TEST_CASE( "buffered vtab autocommit" ) {
+
+    fixture f;
+
+    f.db->exec("INSERT INTO items VALUES('plum', 7)");
+    REQUIRE(f.state.batches.size() == 1);
+    CHECK(f.state.batches[0] == "+3 ");
+    CHECK(f.state.items[3].name == "plum");
+    CHECK(f.items() == "1|apple|3\n2|pear|5\n3|plum|7\n");
+}
+
+TEST_CASE( "buffered vtab transaction" ) {
+
+    fixture f;
+
+    f.db->exec("BEGIN");
+    f.db->exec("INSERT INTO items VALUES('plum', 7)");
+    f.db->exec("INSERT INTO items(rowid, name, qty) VALUES(10, 'fig', 1)");
+    f.db->exec("UPDATE items SET qty = qty + 1 WHERE name = 'apple'");
+    f.db->exec("DELETE FROM items WHERE rowid = 2");
+    f.db->exec("UPDATE items SET rowid = 11 WHERE name = 'fig'");
+    CHECK(f.state.batches.empty());
+    CHECK(f.state.items.size() == 2);
+    CHECK(f.items() == "1|apple|4\n3|plum|7\n11|fig|1\n");
+    f.db->exec("COMMIT");
+    REQUIRE(f.state.batches.size() == 1);
+    CHECK(f.state.batches[0] == "=1 -2 +3 +11 ");
+    CHECK(f.items() == "1|apple|4\n3|plum|7\n11|fig|1\n");
+}
+
+TEST_CASE( "buffered vtab rollback" ) {
+
+    fixture f;
+
+    f.db->exec("BEGIN");
+    f.db->exec("INSERT INTO items VALUES('plum', 7)");
+    f.db->exec("DELETE FROM items");
+    CHECK(f.items().empty());
+    f.db->exec("ROLLBACK");
+    CHECK(f.state.batches.empty());
+    CHECK(f.items() == "1|apple|3\n2|pear|5\n");
+}
+
+TEST_CASE( "buffered vtab savepoints" ) {
+
+    fixture f;
+
+    f.db->exec("BEGIN");
+    f.db->exec("INSERT INTO items VALUES('plum', 7)");
+    f.db->exec("SAVEPOINT a");
+    f.db->exec("UPDATE items SET qty = 0 WHERE name = 'plum'");
+    f.db->exec("DELETE FROM items WHERE name = 'apple'");
+    f.db->exec("SAVEPOINT b");
+    f.db->exec("INSERT INTO items VALUES('fig', 1)");
+    CHECK(f.items() == "2|pear|5\n3|plum|0\n4|fig|1\n");
+    f.db->exec("ROLLBACK TO b");
+    CHECK(f.items() == "2|pear|5\n3|plum|0\n");
+    f.db->exec("RELEASE b");
+    f.db->exec("ROLLBACK TO a");
+    CHECK(f.items() == "1|apple|3\n2|pear|5\n3|plum|7\n");
+    f.db->exec("RELEASE a");
+    f.db->exec("COMMIT");
+    REQUIRE(f.state.batches.size() == 1);
+    CHECK(f.state.batches[0] == "+3 ");
+}
+
+TEST_CASE( "buffered vtab failed statement" ) {
+
+    fixture f;
+
+    f.db->exec("BEGIN");
+    f.db->exec("INSERT INTO items VALUES('plum', 7)");
+    CHECK_THROWS_AS(f.db->exec("INSERT INTO items VALUES('fig', 1), ('kiwi', -1)"), thinsqlitepp::exception);
+    CHECK(f.items() == "1|apple|3\n2|pear|5\n3|plum|7\n");
+    f.db->exec("COMMIT");
+    REQUIRE(f.state.batches.size() == 1);
+    CHECK(f.state.batches[0] == "+3 ");
+}
+
+TEST_SUITE_END();
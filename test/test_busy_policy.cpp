@@ -0,0 +1,122 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/busy_policy.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <numeric>
+
+using namespace thinsqlitepp;
+using namespace std::chrono;
+
+TEST_SUITE_BEGIN("busy_policy");
+
+TEST_CASE( "busy_metrics buckets" ) {
+
+    CHECK(busy_metrics::bucket(0) == 0);
+    CHECK(busy_metrics::bucket(1) == 1);
+    CHECK(busy_metrics::bucket(2) == 2);
+    CHECK(busy_metrics::bucket(3) == 2);
+    CHECK(busy_metrics::bucket(4) == 3);
+    CHECK(busy_metrics::bucket(~uint64_t(0)) == busy_metrics::bucket_count - 1);
+
+    busy_metrics metrics;
+    metrics.record(5, microseconds(1000), false);
+    metrics.record(0, microseconds(0), true);
+    auto stats = metrics.snapshot();
+    CHECK(stats.waits == 2);
+    CHECK(stats.timeouts == 1);
+    CHECK(stats.retries == 5);
+    CHECK(stats.wait_us == 1000);
+    CHECK(stats.retry_histogram[3] == 1);
+    CHECK(stats.retry_histogram[0] == 1);
+    CHECK(stats.wait_histogram[10] == 1);
+    CHECK(stats.wait_histogram[0] == 1);
+
+    metrics.reset();
+    CHECK(metrics.snapshot().waits == 0);
+    CHECK(metrics.snapshot().wait_histogram[10] == 0);
+}
+
+TEST_CASE( "busy_policy" ) {
+
+    auto holder = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    holder->exec("DROP TABLE IF EXISTS items; CREATE TABLE items(value INTEGER)");
+    auto waiter = database::open("foo.db", SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+
+    busy_metrics shared;
+
+    SUBCASE("gives up at deadline") {
+        busy_policy::settings settings;
+        settings.spins = 2;
+        settings.initial_backoff = microseconds(100);
+        settings.max_backoff = microseconds(2000);
+        settings.deadline = milliseconds(30);
+        busy_policy policy(settings, &shared);
+        CHECK(&policy.metrics() == &shared);
+        waiter->busy_handler(&policy);
+
+        holder->exec("BEGIN EXCLUSIVE");
+        auto start = steady_clock::now();
+        CHECK_THROWS_AS(waiter->exec("INSERT INTO items VALUES(1)"), thinsqlitepp::exception);
+        auto elapsed = steady_clock::now() - start;
+        holder->exec("COMMIT");
+
+        CHECK(elapsed >= milliseconds(30));
+        CHECK(elapsed < milliseconds(1000));
+        auto stats = shared.snapshot();
+        CHECK(stats.waits == 1);
+        CHECK(stats.timeouts == 1);
+        CHECK(stats.retries > 2);
+        CHECK(stats.wait_us >= 29000);
+        CHECK(std::accumulate(stats.retry_histogram.begin(), stats.retry_histogram.end(), uint64_t(0)) == 1);
+        waiter->busy_handler(nullptr);
+    }
+
+    SUBCASE("waits for the lock") {
+        busy_policy policy;
+
+        //releases the lock from inside the busy handler, once it has waited for a while,
+        //so no other thread is needed
+        struct releasing_handler
+        {
+            busy_policy & policy;
+            database & holder;
+            steady_clock::time_point start{};
+            bool released = false;
+
+            bool operator()(int count_invoked) noexcept
+            {
+                if (count_invoked == 0)
+                {
+                    start = steady_clock::now();
+                }
+                else if (!released && steady_clock::now() - start >= milliseconds(20))
+                {
+                    holder.exec("COMMIT");
+                    released = true;
+                }
+                return policy(count_invoked);
+            }
+        } handler{policy, *holder};
+        waiter->busy_handler(&handler);
+
+        holder->exec("BEGIN EXCLUSIVE");
+        waiter->exec("INSERT INTO items VALUES(1)");
+        CHECK(handler.released);
+
+        //success is only known when asked for
+        CHECK(policy.metrics().snapshot().waits == 0);
+        policy.flush();
+        auto stats = policy.metrics().snapshot();
+        CHECK(stats.waits == 1);
+        CHECK(stats.timeouts == 0);
+        CHECK(stats.retries > 0);
+        CHECK(stats.wait_us >= 10000);
+        policy.flush();
+        CHECK(policy.metrics().snapshot().waits == 1);
+        waiter->busy_handler(nullptr);
+    }
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,89 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/carray.hpp>
+#include <thinsqlitepp/database.hpp>
+#include <thinsqlitepp/statement.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace thinsqlitepp;
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+
+TEST_SUITE_BEGIN("carray");
+
+namespace
+{
+    std::string collect(statement & stmt)
+    {
+        std::string ret;
+        while (stmt.step())
+        {
+            for (int i = 0, count = stmt.column_count(); i < count; ++i)
+            {
+                ret += stmt.column_type(i) == SQLITE_NULL ? "null" : std::string(stmt.column_value<std::string_view>(i));
+                ret += i + 1 < count ? '|' : '\n';
+            }
+        }
+        stmt.reset();
+        return ret;
+    }
+}
+
+TEST_CASE( "carray" ) {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    carray::create_module(*db, "carray");
+    db->exec("CREATE TEMP TABLE items(id INTEGER PRIMARY KEY, name TEXT, price REAL);"
+             "INSERT INTO items VALUES(1, 'apple', 1.5), (2, 'pear', 2.5), (3, 'plum', 0.5), (4, 'fig', 3)");
+
+    auto stmt = statement::create(*db, "SELECT name FROM items WHERE id IN carray(?) ORDER BY id");
+
+    std::vector<int64_t> ids = {4, 2, 7, 2};
+    carray::bind(*stmt, 1, ids);
+    CHECK(collect(*stmt) == "pear\nfig\n");
+
+    //same statement, different list size
+    ids = {1, 2, 3};
+    carray::bind(*stmt, 1, ids);
+    CHECK(collect(*stmt) == "apple\npear\nplum\n");
+
+    ids.clear();
+    carray::bind(*stmt, 1, ids);
+    CHECK(collect(*stmt).empty());
+
+    //NULL and values not bound via carray::bind produce nothing
+    stmt->bind(1, nullptr);
+    CHECK(collect(*stmt).empty());
+    stmt->bind(1, "1");
+    CHECK(collect(*stmt).empty());
+
+    std::string_view names[] = {"plum", "kiwi", "apple"};
+    stmt = statement::create(*db, "SELECT id FROM items WHERE name IN carray(?) ORDER BY id");
+    carray::bind(*stmt, 1, names);
+    CHECK(collect(*stmt) == "1\n3\n");
+
+    double prices[] = {0.5, 3, 4};
+    stmt = statement::create(*db, "SELECT rowid, value FROM carray(?1) WHERE value IN (SELECT price FROM items)");
+    carray::bind(*stmt, 1, prices);
+    CHECK(collect(*stmt) == "1|0.5\n2|3.0\n");
+
+    int64_t numbers[] = {10, 20, 30, 40, 50};
+    stmt = statement::create(*db, "SELECT value FROM carray(?) ORDER BY rowid LIMIT 2 OFFSET 1");
+    carray::bind(*stmt, 1, numbers);
+    CHECK(collect(*stmt) == "20\n30\n");
+    stmt = statement::create(*db, "SELECT value FROM carray(?) LIMIT 10 OFFSET 3");
+    carray::bind(*stmt, 1, numbers);
+    CHECK(collect(*stmt) == "40\n50\n");
+    stmt = statement::create(*db, "SELECT count(*), sum(value) FROM carray(?) WHERE value > 15");
+    carray::bind(*stmt, 1, numbers);
+    CHECK(collect(*stmt) == "4|140\n");
+
+    CHECK_THROWS_AS(statement::create(*db, "SELECT * FROM carray"), thinsqlitepp::exception);
+}
+
+TEST_SUITE_END();
+
+#endif
@@ -0,0 +1,212 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/change_capture.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#ifndef __EMSCRIPTEN__
+    #include <thread>
+#endif
+
+using namespace thinsqlitepp;
+
+TEST_SUITE_BEGIN("change_capture");
+
+TEST_CASE( "spmc ring" ) {
+
+    spmc_ring<int> ring(3);
+    CHECK(ring.capacity() == 4);
+    CHECK(!ring.try_pop());
+    CHECK(ring.can_push(4));
+    CHECK(!ring.can_push(5));
+    for (int i = 0; i < 4; ++i)
+        CHECK(ring.try_push(int(i)));
+    CHECK(!ring.try_push(4));
+    CHECK(!ring.can_push(1));
+
+    CHECK(ring.try_pop() == 0);
+    CHECK(ring.can_push(1));
+    CHECK(ring.try_push(4));
+
+    std::vector<int> batch;
+    CHECK(ring.pop([&](int && val) noexcept { batch.push_back(val); }, 10) == 4);
+    CHECK(batch == std::vector<int>{1, 2, 3, 4});
+    CHECK(!ring.try_pop());
+}
+
+#ifndef __EMSCRIPTEN__
+
+TEST_CASE( "spmc ring concurrent" ) {
+
+    constexpr int count = 100000;
+    spmc_ring<int> ring(64);
+    std::atomic<long long> sum{0};
+    std::atomic<int> received{0};
+
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < 3; ++i)
+    {
+        consumers.emplace_back([&]() {
+            while (received.load() < count)
+            {
+                long long local = 0;
+                auto popped = ring.pop([&](int && val) noexcept { local += val; }, 16);
+                sum += local;
+                received += int(popped);
+                if (!popped)
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (int i = 1; i <= count; )
+    {
+        if (ring.try_push(int(i)))
+            ++i;
+        else
+            std::this_thread::yield();
+    }
+    for (auto & consumer: consumers)
+        consumer.join();
+    CHECK(received.load() == count);
+    CHECK(sum.load() == (long long)count * (count + 1) / 2);
+}
+
+#endif
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 16, 0) && defined(SQLITE_ENABLE_PREUPDATE_HOOK)
+
+TEST_CASE( "change capture" ) {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS foo; CREATE TABLE foo(id INTEGER PRIMARY KEY, name TEXT, score REAL)");
+
+    change_capture capture(*db, 4);
+    std::vector<change_event> events;
+
+    db->exec("INSERT INTO foo VALUES(1, 'haha', 1.5)");
+    CHECK(capture.consume(events, 10) == 1);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].transaction == 1);
+    CHECK(events[0].op == SQLITE_INSERT);
+    CHECK(events[0].db_name == "main");
+    CHECK(events[0].table == "foo");
+    CHECK(events[0].new_rowid == 1);
+    CHECK(events[0].old_values.empty());
+    REQUIRE(events[0].new_values.size() == 3);
+    CHECK(events[0].new_values[0] == owned_value(1));
+    CHECK(events[0].new_values[1].get<std::string_view>() == "haha");
+    CHECK(events[0].new_values[2].get<double>() == 1.5);
+
+    events.clear();
+    db->exec("BEGIN; UPDATE foo SET name = 'hoho' WHERE id = 1; INSERT INTO foo VALUES(2, NULL, NULL);");
+    CHECK(capture.consume(events, 10) == 0);
+    db->exec("COMMIT");
+    CHECK(capture.consume(events, 1) == 1);
+    CHECK(capture.consume(events, 10) == 1);
+    REQUIRE(events.size() == 2);
+    CHECK(events[0].transaction == 2);
+    CHECK(events[0].op == SQLITE_UPDATE);
+    CHECK(events[0].old_values[1].get<std::string_view>() == "haha");
+    CHECK(events[0].new_values[1].get<std::string_view>() == "hoho");
+    CHECK(events[1].transaction == 2);
+    CHECK(events[1].op == SQLITE_INSERT);
+    CHECK(events[1].new_values[1].is_null());
+
+    events.clear();
+    db->exec("BEGIN; DELETE FROM foo; ROLLBACK");
+    CHECK(capture.consume(events, 10) == 0);
+
+    //does not fit: the commit must fail and nothing is published
+    CHECK_THROWS_AS(db->exec("BEGIN; INSERT INTO foo VALUES(3, 'a', 0); INSERT INTO foo VALUES(4, 'b', 0);"
+                             "INSERT INTO foo VALUES(5, 'c', 0); INSERT INTO foo VALUES(6, 'd', 0);"
+                             "INSERT INTO foo VALUES(7, 'e', 0); COMMIT"), exception);
+    CHECK(capture.consume(events, 10) == 0);
+    CHECK(db->get_autocommit());
+
+    db->exec("DELETE FROM foo WHERE id = 2");
+    CHECK(capture.consume(events, 10) == 1);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].transaction == 3);
+    CHECK(events[0].op == SQLITE_DELETE);
+    CHECK(events[0].old_rowid == 2);
+    CHECK(events[0].new_values.empty());
+}
+
+TEST_CASE( "change capture partial rollback" ) {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS foo; CREATE TABLE foo(id INTEGER PRIMARY KEY, name TEXT NOT NULL)");
+
+    change_capture capture(*db, 16);
+    std::vector<change_event> events;
+
+    db->exec("BEGIN; INSERT INTO foo VALUES(1, 'a');"
+             "SAVEPOINT one; INSERT INTO foo VALUES(2, 'b');"
+             "SAVEPOINT \"Two\"; DELETE FROM foo WHERE id = 1;"
+             "ROLLBACK TO two; UPDATE foo SET name = 'c' WHERE id = 2;"
+             "ROLLBACK TRANSACTION TO SAVEPOINT One; INSERT INTO foo VALUES(3, 'd');"
+             "RELEASE one; COMMIT");
+    CHECK(capture.consume(events, 10) == 2);
+    REQUIRE(events.size() == 2);
+    CHECK(events[0].op == SQLITE_INSERT);
+    CHECK(events[0].new_rowid == 1);
+    CHECK(events[1].op == SQLITE_INSERT);
+    CHECK(events[1].new_rowid == 3);
+
+    //a savepoint outside of a transaction starts one
+    events.clear();
+    db->exec("SAVEPOINT outer; INSERT INTO foo VALUES(4, 'e'); ROLLBACK TO outer; INSERT INTO foo VALUES(5, 'f'); RELEASE outer");
+    CHECK(capture.consume(events, 10) == 1);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].new_rowid == 5);
+
+    //the first row is inserted before the second one fails and the statement is rolled back
+    events.clear();
+    db->exec("BEGIN");
+    CHECK_THROWS_AS(db->exec("INSERT INTO foo VALUES(6, 'g'), (7, NULL)"), exception);
+    CHECK_THROWS_AS(db->exec("UPDATE foo SET name = CASE id WHEN 5 THEN NULL ELSE 'h' END"), exception);
+    db->exec("INSERT INTO foo VALUES(8, 'i'); COMMIT");
+    CHECK(capture.consume(events, 10) == 1);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].op == SQLITE_INSERT);
+    CHECK(events[0].new_rowid == 8);
+
+    //OR FAIL keeps the rows changed before the failure
+    events.clear();
+    db->exec("BEGIN");
+    CHECK_THROWS_AS(db->exec("INSERT OR FAIL INTO foo VALUES(9, 'j'), (10, NULL)"), exception);
+    db->exec("COMMIT");
+    CHECK(capture.consume(events, 10) == 1);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].new_rowid == 9);
+
+    //savepoints do not outlive their transaction and failed savepoint statements are ignored
+    events.clear();
+    db->exec("BEGIN; SAVEPOINT a; COMMIT");
+    db->exec("BEGIN; INSERT INTO foo VALUES(11, 'k')");
+    CHECK_THROWS_AS(db->exec("ROLLBACK TO a"), exception);
+    CHECK_THROWS_AS(db->exec("RELEASE b"), exception);
+    CHECK(!db->get_autocommit());
+    db->exec("COMMIT");
+    CHECK(capture.consume(events, 10) == 1);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].new_rowid == 11);
+}
+
+TEST_CASE( "change capture drop" ) {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS foo; CREATE TABLE foo(id INTEGER PRIMARY KEY)");
+
+    change_capture capture(*db, 2, change_capture::overflow_policy::drop);
+    db->exec("INSERT INTO foo VALUES(1),(2),(3)");
+    CHECK(capture.dropped() == 3);
+    std::vector<change_event> events;
+    CHECK(capture.consume(events, 10) == 0);
+    db->exec("INSERT INTO foo VALUES(4)");
+    CHECK(capture.consume(events, 10) == 1);
+}
+
+#endif
+
+TEST_SUITE_END();
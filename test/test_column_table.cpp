@@ -0,0 +1,102 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/column_table.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace thinsqlitepp;
+
+TEST_SUITE_BEGIN("column_table");
+
+namespace
+{
+    std::string collect(database & db, const std::string & sql)
+    {
+        std::string ret;
+        db.exec(sql, [&](row r) noexcept {
+            for (int i = 0; i < r.size(); ++i)
+            {
+                ret += r[i].type() == SQLITE_NULL ? "null" : std::string(r[i].value<std::string_view>());
+                ret += i + 1 < r.size() ? '|' : '\n';
+            }
+            return true;
+        });
+        return ret;
+    }
+}
+
+TEST_CASE( "column table" ) {
+
+    std::vector<int64_t> ids;
+    std::vector<double> prices;
+    std::vector<std::string_view> names;
+    const std::string_view words[] = {"alpha", "beta", "gamma", "delta", "Beta", "epsilon", ""};
+    uint32_t seed = 5;
+    for (int i = 0; i < 2000; ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        ids.push_back(int64_t(seed % 1000) - 100);
+        prices.push_back(i == 7 ? 9007199254740992. : double(seed % 97) / 4);
+        names.push_back(words[(seed >> 8) % std::size(words)]);
+    }
+
+    column_set columns;
+    columns.add("id", ids).add("price", prices).add("name", names);
+    CHECK(columns.size() == 3);
+    CHECK(columns.rows() == 2000);
+    CHECK_THROWS_AS(column_set().add("a", ids).add("b", span<const double>(prices.data(), 5)), thinsqlitepp::exception);
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    column_table::create_module(*db, "cols", &columns);
+    #if SQLITE_VERSION_NUMBER < SQLITEPP_SQLITE_VERSION(3, 9, 0)
+    db->exec("CREATE VIRTUAL TABLE temp.cols USING cols");
+    #endif
+
+    db->exec("DROP TABLE IF EXISTS ref; CREATE TABLE ref(id INTEGER, price REAL, name TEXT)");
+    {
+        auto insert = statement::create(*db, "INSERT INTO ref(rowid, id, price, name) VALUES (?, ?, ?, ?)");
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            insert->bind(1, int64_t(i));
+            insert->bind(2, ids[i]);
+            insert->bind(3, prices[i]);
+            insert->bind(4, names[i]);
+            while(insert->step()) {}
+            insert->reset();
+        }
+    }
+
+    CHECK(collect(*db, "SELECT count(*), sum(id), sum(price) FROM cols") ==
+          collect(*db, "SELECT count(*), sum(id), sum(price) FROM ref"));
+
+    for (const char * where: {
+            "id = 42", "id > 850", "id >= 10 AND id < 20", "id > 10.5", "id <= 10.5", "id = 7.0", "id = 7.5",
+            "id < -1e30", "id > 1e300", "id = '42'", "id = NULL", "id > 'a'",
+            "price <= 3.25", "price = 12", "price > 9007199254740993", "price >= 9007199254740991",
+            "name = 'beta'", "name > 'c'", "name = 'BETA' COLLATE NOCASE", "name = ''", "name < 5",
+            "rowid = 5", "rowid = -1", "rowid > 1990", "rowid BETWEEN 10 AND 200 AND id > 500", "rowid < 2.5",
+            "rowid BETWEEN 1000 AND 1100 AND id < 0", "id = 17 AND name = 'beta'",
+            "id IN (1, 2, 3, 4.0, 5.5)", "id IN (1, 'x')", "name IN ('alpha', 'gamma')", "price IN (1, 2.25)",
+            "id IN (SELECT id FROM ref WHERE rowid < 10)", "rowid IN (3, 7, 5000)",
+            "price > 2 AND name < 'd' AND id % 2 = 0", "id > 100 AND id < 50"})
+    {
+        const std::string condition = where;
+        CHECK(condition + collect(*db, "SELECT rowid, * FROM cols WHERE " + condition + " ORDER BY rowid") ==
+              condition + collect(*db, "SELECT rowid, * FROM ref WHERE " + condition + " ORDER BY rowid"));
+    }
+
+    CHECK(collect(*db, "SELECT r.rowid FROM ref r JOIN cols c ON c.rowid = r.id WHERE r.rowid < 50 ORDER BY r.rowid") ==
+          collect(*db, "SELECT r.rowid FROM ref r JOIN ref c ON c.rowid = r.id WHERE r.rowid < 50 ORDER BY r.rowid"));
+
+    std::string plan = collect(*db, "EXPLAIN QUERY PLAN SELECT * FROM cols WHERE id = 42");
+    CHECK(plan.find("INDEX 1") != std::string::npos);
+
+    #if SQLITE_VERSION_NUMBER < SQLITEPP_SQLITE_VERSION(3, 9, 0)
+    db->exec("DROP TABLE cols");
+    #endif
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,106 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/csv_table.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <fstream>
+#include <string>
+
+using namespace thinsqlitepp;
+
+TEST_SUITE_BEGIN("csv_table");
+
+namespace
+{
+    std::string collect(database & db, const std::string & sql)
+    {
+        std::string ret;
+        db.exec(sql, [&](row r) noexcept {
+            for (int i = 0; i < r.size(); ++i)
+            {
+                ret += r[i].type() == SQLITE_NULL ? "null" : std::string(r[i].value<std::string_view>());
+                ret += i + 1 < r.size() ? '|' : '\n';
+            }
+            return true;
+        });
+        return ret;
+    }
+
+    void write_file(const char * name, std::string_view content)
+    {
+        std::ofstream str(name, std::ios::binary | std::ios::trunc);
+        str.write(content.data(), std::streamsize(content.size()));
+    }
+}
+
+TEST_CASE( "csv table" ) {
+
+    write_file("test.csv",
+               "id,name,note\r\n"
+               "1,apple,plain\r\n"
+               "2,\"pear, green\",\"say \"\"hi\"\"\"\r\n"
+               "3,plum,\"two\nlines\"\r\n"
+               "4,fig\r\n"
+               "5,,last");
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    csv_table::create_module(*db, "csv");
+    db->exec("CREATE VIRTUAL TABLE temp.fruit USING csv(filename='test.csv', header=yes)");
+
+    CHECK(collect(*db, "SELECT rowid, * FROM fruit") ==
+          "1|1|apple|plain\n"
+          "2|2|pear, green|say \"hi\"\n"
+          "3|3|plum|two\nlines\n"
+          "4|4|fig|null\n"
+          "5|5||last\n");
+    CHECK(collect(*db, "SELECT name FROM fruit WHERE rowid = 3") == "plum\n");
+    CHECK(collect(*db, "SELECT name FROM fruit WHERE rowid BETWEEN 2 AND 4 AND rowid <> 3") == "pear, green\nfig\n");
+    CHECK(collect(*db, "SELECT name FROM fruit WHERE rowid > 4.5") == "\n");
+    CHECK(collect(*db, "SELECT name FROM fruit WHERE rowid > 10 OR rowid < 1").empty());
+    CHECK(collect(*db, "SELECT name FROM fruit WHERE rowid = '2'") == "pear, green\n");
+    CHECK(collect(*db, "SELECT count(*) FROM fruit") == "5\n");
+    CHECK(collect(*db, "SELECT id FROM fruit WHERE note LIKE '%i%' ORDER BY rowid") == "1\n2\n3\n");
+
+    //rowid lookups use the table itself and so does ORDER BY rowid
+    CHECK(collect(*db, "EXPLAIN QUERY PLAN SELECT * FROM fruit ORDER BY rowid").find("ORDER BY") == std::string::npos);
+
+    write_file("test.tsv", "a\tb\n\n1\t2\t3\n");
+    db->exec("CREATE VIRTUAL TABLE temp.tsv USING csv(filename=test.tsv, delimiter=tab)");
+    CHECK(collect(*db, "SELECT * FROM tsv") == "a|b\n|null\n1|2\n");
+    db->exec("CREATE VIRTUAL TABLE temp.tsv3 USING csv(filename=test.tsv, delimiter=tab, columns=3)");
+    CHECK(collect(*db, "SELECT c2 FROM tsv3") == "null\nnull\n3\n");
+
+    write_file("test.txt", "AB  12345\n  C  6\nD");
+    db->exec("CREATE VIRTUAL TABLE temp.fixed USING csv(filename='test.txt', widths='4,3,2')");
+    CHECK(collect(*db, "SELECT * FROM fixed") == "AB|123|45\nC|6|null\nD|null|null\n");
+
+    write_file("empty.csv", "");
+    db->exec("CREATE VIRTUAL TABLE temp.empty USING csv(filename='empty.csv', header=true)");
+    CHECK(collect(*db, "SELECT * FROM empty").empty());
+
+    CHECK_THROWS_AS(db->exec("CREATE VIRTUAL TABLE temp.bad USING csv(header=yes)"), thinsqlitepp::exception);
+    CHECK_THROWS_AS(db->exec("CREATE VIRTUAL TABLE temp.bad USING csv(filename='no-such-file.csv')"), thinsqlitepp::exception);
+    CHECK_THROWS_AS(db->exec("CREATE VIRTUAL TABLE temp.bad USING csv(filename='test.csv', header=maybe)"), thinsqlitepp::exception);
+    CHECK_THROWS_AS(db->exec("CREATE VIRTUAL TABLE temp.bad USING csv(filename='test.csv', flavor=1)"), thinsqlitepp::exception);
+}
+
+TEST_CASE( "csv table large" ) {
+
+    std::string content = "n,square\n";
+    for (int i = 1; i <= 20000; ++i)
+        content += std::to_string(i) + ',' + std::to_string(i * i) + '\n';
+    write_file("large.csv", content);
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    csv_table::create_module(*db, "csv");
+    db->exec("CREATE VIRTUAL TABLE temp.large USING csv(filename='large.csv', header=yes)");
+
+    //a lookup in the middle before the whole file has been indexed
+    CHECK(collect(*db, "SELECT square FROM large WHERE rowid = 1500") == "2250000\n");
+    CHECK(collect(*db, "SELECT n FROM large WHERE rowid >= 19999") == "19999\n20000\n");
+    CHECK(collect(*db, "SELECT count(*), sum(n) FROM large") == "20000|200010000\n");
+    CHECK(collect(*db, "SELECT square FROM large WHERE rowid = 12") == "144\n");
+}
+
+TEST_SUITE_END();
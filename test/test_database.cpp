@@ -5,6 +5,7 @@
 
 #include <thinsqlitepp/database.hpp>
 
+#include <thread>
 #include <type_traits>
 
 using namespace thinsqlitepp;
@@ -197,6 +198,100 @@ TEST_CASE_FIXTURE(sqlitepp_test_fixture,  "busy timeout") {
     db->busy_timeout(5);
 }
 
+#if defined(SQLITE_ENABLE_UNLOCK_NOTIFY)
+
+TEST_CASE( "unlock notify" ) {
+
+    const char * uri = "file:unlock_notify?mode=memory&cache=shared";
+    const int flags = SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_URI | SQLITE_OPEN_FULLMUTEX;
+    auto db1 = database::open(uri, flags);
+    auto db2 = database::open(uri, flags);
+
+    db1->exec("CREATE TABLE t1(a); CREATE TABLE t2(a); INSERT INTO t1 VALUES(1);");
+
+    //nothing is blocking: the handler is invoked immediately
+    int count = 0;
+    auto h = [&] () noexcept { ++count; };
+    db2->unlock_notify(&h);
+    CHECK(count == 1);
+    db2->unlock_notify(nullptr);
+
+#ifndef __EMSCRIPTEN__
+    SUBCASE("blocking step") {
+        //the lock is released from another thread
+        if (!sqlite3_threadsafe())
+            return;
+
+        db1->exec("BEGIN; INSERT INTO t1 VALUES(2);");
+
+        auto stmt = statement::create(*db2, "SELECT count(*) FROM t1");
+        auto res = stmt->try_step();
+        REQUIRE(!res);
+        CHECK(res.code().primary() == SQLITE_LOCKED);
+        stmt->reset();
+
+        std::thread committer([&]() {
+            std::this_thread::sleep_for(50ms);
+            db1->exec("COMMIT");
+        });
+        CHECK(stmt->blocking_step());
+        CHECK(stmt->column_value<int>(0) == 2);
+        committer.join();
+    }
+
+    SUBCASE("blocking create") {
+        if (!sqlite3_threadsafe())
+            return;
+
+        db1->exec("BEGIN; DROP TABLE t2;");
+
+        std::thread committer([&]() {
+            std::this_thread::sleep_for(50ms);
+            db1->exec("ROLLBACK");
+        });
+        auto stmt = statement::blocking_create(*db2, "SELECT count(*) FROM t2");
+        REQUIRE(stmt);
+        CHECK(stmt->blocking_step());
+        CHECK(stmt->column_value<int>(0) == 0);
+        committer.join();
+    }
+#endif
+
+    SUBCASE("deadlock") {
+        db1->exec("BEGIN; INSERT INTO t2 VALUES(2);");
+
+        //db2 holds a read lock on t1 until its transaction ends
+        db2->exec("BEGIN; SELECT a FROM t1;");
+
+        //db1 waits for db2
+        auto stmt1 = statement::create(*db1, "INSERT INTO t1 VALUES(3)");
+        REQUIRE(!stmt1->try_step());
+        int notified = 0;
+        auto h1 = [&] () noexcept { ++notified; };
+        db1->unlock_notify(&h1);
+        CHECK(notified == 0);
+
+        //db2 waiting for db1 would never end
+        auto stmt2 = statement::create(*db2, "SELECT count(*) FROM t2");
+        try
+        {
+            stmt2->blocking_step();
+            FAIL("no exception");
+        }
+        catch(thinsqlitepp::exception & ex)
+        {
+            CHECK(ex.primary_error_code() == SQLITE_LOCKED);
+        }
+        
+        db2->exec("ROLLBACK");
+        CHECK(notified == 1);
+        CHECK(stmt1->blocking_step() == false);
+        db1->exec("COMMIT");
+    }
+}
+
+#endif
+
 TEST_CASE_FIXTURE(sqlitepp_test_fixture,  "changes") {
     
     auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
@@ -305,6 +400,40 @@ TEST_CASE_FIXTURE(sqlitepp_test_fixture,  "update hook") {
     db->update_hook(nullptr);
 }
 
+TEST_CASE_FIXTURE(sqlitepp_test_fixture,  "authorizer") {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS foo; CREATE TABLE foo(name TEXT PRIMARY key, secret TEXT)");
+
+    std::vector<std::string> read;
+    auto auth = [&] (int action, const char * table, const char * column, 
+                     const char * db_name, const char * /*trigger_or_view*/) noexcept -> int {
+        if (action != SQLITE_READ)
+            return SQLITE_OK;
+        CHECK(db_name == "main"sv);
+        read.push_back(std::string(table) + '.' + column);
+        return column == "secret"sv ? SQLITE_DENY : SQLITE_OK;
+    };
+    db->authorizer(&auth);
+    statement::create(*db, "SELECT name FROM foo");
+    CHECK(read == std::vector<std::string>{"foo.name"});
+    CHECK_THROWS_AS(statement::create(*db, "SELECT secret FROM foo"), thinsqlitepp::exception);
+
+    db->authorizer(nullptr);
+    read.clear();
+    statement::create(*db, "SELECT secret FROM foo");
+    CHECK(read.empty());
+
+    int count = 0;
+    db->authorizer([] (int * data, int, const char *, const char *, const char *, const char *) noexcept {
+        ++*data;
+        return SQLITE_OK;
+    }, &count);
+    statement::create(*db, "SELECT name FROM foo");
+    CHECK(count > 0);
+    db->authorizer(nullptr, nullptr);
+}
+
 #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 16, 0) && defined(SQLITE_ENABLE_PREUPDATE_HOOK)
 
 TEST_CASE_FIXTURE(sqlitepp_test_fixture,  "preupdate hook") {
@@ -634,6 +763,113 @@ TEST_CASE_FIXTURE(sqlitepp_test_fixture,  "create function") {
 #endif
 }
 
+namespace {
+    int64_t typed_twice(int64_t val) noexcept { return 2 * val; }
+
+    template<class T>
+    std::optional<T> select_one(database & db, const char * sql)
+    {
+        std::optional<T> ret;
+        db.exec(sql, [&](row r) noexcept {
+            if (r[0].type() == SQLITE_NULL)
+                return false;
+            if constexpr (std::is_same_v<T, std::string>)
+                ret.emplace(r[0].value<std::string_view>());
+            else
+                ret = r[0].value<T>();
+            return false;
+        });
+        return ret;
+    }
+}
+
+TEST_CASE_FIXTURE(sqlitepp_test_fixture,  "typed function") {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+
+    static_assert(is_typed_function<decltype(&typed_twice)>);
+    static_assert(!is_typed_function<void (*)(context *, int, value **)>);
+    static_assert(!is_typed_function<int>);
+    {
+        auto generic = [](auto x) { return x; };
+        static_assert(!is_typed_function<decltype(generic)>);
+        auto bad_arg = [](std::string x) { return x; };
+        static_assert(!is_typed_function<decltype(bad_arg)>);
+    }
+
+    db->create_function("scale", [](int64_t a, std::string_view b) noexcept -> double {
+        return double(a) * double(b.size()) / 2;
+    }, SQLITE_UTF8);
+    CHECK(select_one<double>(*db, "SELECT scale(3, 'abcd')") == 6.0);
+    CHECK_THROWS_AS(db->exec("SELECT scale(3)"), thinsqlitepp::exception);
+
+    db->create_function("twice", &typed_twice);
+    CHECK(select_one<int64_t>(*db, "SELECT twice(5000000000)") == 10000000000);
+
+    db->create_function("concat", [](std::optional<std::string_view> a, std::optional<std::string_view> b) {
+        if (!a || !b)
+            return std::optional<std::string>();
+        return std::optional<std::string>(std::string(*a) + std::string(*b));
+    });
+    CHECK(select_one<std::string>(*db, "SELECT concat('ab', 'cd')") == "abcd");
+    CHECK(!select_one<std::string>(*db, "SELECT concat('ab', NULL)"));
+
+    db->create_function("type_of", [](context * ctxt, const value & val) noexcept {
+        ctxt->result(val.type());
+    });
+    CHECK(select_one<int>(*db, "SELECT type_of(x'0102')") == SQLITE_BLOB);
+
+    db->create_function("blob_len", [](blob_view val) noexcept { return val.size(); });
+    CHECK(select_one<int64_t>(*db, "SELECT blob_len(x'010203')") == 3);
+
+    db->create_function("noop", []() noexcept {});
+    CHECK(!select_one<int>(*db, "SELECT noop()"));
+
+    db->create_function("fail", [](int code) -> int {
+        if (code)
+            throw thinsqlitepp::exception(code);
+        throw std::runtime_error("haha");
+    });
+    try
+    {
+        db->exec("SELECT fail(0)");
+        FAIL("no exception");
+    }
+    catch(thinsqlitepp::exception & ex)
+    {
+        CHECK(ex.primary_error_code() == SQLITE_ERROR);
+        CHECK(std::string_view(ex.what()).find("haha") != std::string_view::npos);
+    }
+    try
+    {
+        db->exec("SELECT fail(19)");
+        FAIL("no exception");
+    }
+    catch(thinsqlitepp::exception & ex)
+    {
+        CHECK(ex.primary_error_code() == SQLITE_CONSTRAINT);
+    }
+
+    struct counter
+    {
+        int operator()(int val) noexcept { return val + ++calls; }
+        int calls = 0;
+    } count;
+    db->create_function("count_calls", &count);
+    CHECK(select_one<int>(*db, "SELECT count_calls(10)") == 11);
+    CHECK(select_one<int>(*db, "SELECT count_calls(10)") == 12);
+    CHECK(count.calls == 2);
+    db->create_function("count_calls", (counter *)nullptr);
+    CHECK_THROWS_AS(db->exec("SELECT count_calls(10)"), thinsqlitepp::exception);
+
+    //the owned copy is destroyed when the function is removed or the database closes
+    auto tracker = std::make_shared<int>(0);
+    db->create_function("tracked", [tracker](int val) noexcept { return val; });
+    CHECK(tracker.use_count() == 2);
+    db->create_function("tracked", 1, SQLITE_UTF8, nullptr);
+    CHECK(tracker.use_count() == 1);
+}
+
 #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 30, 0)
 
 TEST_CASE_FIXTURE(sqlitepp_test_fixture,  "drop modules") {
@@ -0,0 +1,87 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/dependencies.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <string>
+
+using namespace thinsqlitepp;
+
+TEST_SUITE_BEGIN("dependencies");
+
+namespace
+{
+    std::unique_ptr<database> open_db()
+    {
+        auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+        db->exec("DROP TABLE IF EXISTS items; DROP TABLE IF EXISTS audit; DROP VIEW IF EXISTS cheap;"
+                 "CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT, price REAL);"
+                 "CREATE TABLE audit(item INTEGER, old_price REAL);"
+                 "CREATE VIEW cheap AS SELECT name FROM items WHERE price < 10;"
+                 "CREATE TRIGGER items_audit AFTER UPDATE OF price ON items BEGIN "
+                 "  INSERT INTO audit VALUES(old.id, old.price); "
+                 "END;");
+        return db;
+    }
+}
+
+TEST_CASE( "dependencies of a query" ) {
+
+    auto db = open_db();
+
+    statement_dependencies deps;
+    auto stmt = create_with_dependencies(*db, "SELECT upper(name) FROM cheap", deps);
+    REQUIRE(stmt);
+    //both the view and the table underneath it are read
+    REQUIRE(deps.reads.size() == 2);
+    auto items = statement_dependencies::find(deps.reads, "main", "items");
+    REQUIRE(items);
+    CHECK(items->columns == std::vector<std::string>{"name", "price"});
+    CHECK(deps.reads_table("cheap"));
+    CHECK(deps.writes.empty());
+    CHECK(deps.functions == std::vector<std::string>{"upper"});
+    CHECK(deps.reads_table("items"));
+    CHECK(!deps.reads_table("items", "temp"));
+    CHECK(!deps.reads_table("audit"));
+
+    //table used without columns
+    create_with_dependencies(*db, "SELECT count(*) FROM audit", deps);
+    REQUIRE(deps.reads.size() == 1);
+    CHECK(deps.reads[0].schema.empty());
+    CHECK(deps.reads_table("audit", "temp"));
+}
+
+TEST_CASE( "dependencies of a write" ) {
+
+    auto db = open_db();
+
+    statement_dependencies deps;
+    auto stmt = create_with_dependencies(*db, "UPDATE items SET price = price * 2 WHERE id = ?", deps);
+    REQUIRE(stmt);
+
+    CHECK(deps.writes_table("items"));
+    //via trigger
+    CHECK(deps.writes_table("audit"));
+    CHECK(!deps.writes_table("cheap"));
+    auto items = statement_dependencies::find(deps.writes, "main", "items");
+    REQUIRE(items);
+    CHECK(items->columns == std::vector<std::string>{"price"});
+    CHECK(deps.reads_table("items"));
+
+    //authorizer is removed afterwards
+    dependency_collector collector;
+    db->authorizer(&collector);
+    db->authorizer(nullptr);
+    statement::create(*db, "DELETE FROM audit");
+    CHECK(collector.dependencies().writes.empty());
+
+    db->authorizer(&collector);
+    statement::create(*db, "DELETE FROM audit");
+    db->authorizer(nullptr);
+    CHECK(collector.dependencies().writes_table("audit"));
+
+    CHECK_THROWS_AS(create_with_dependencies(*db, "SELECT * FROM nonexistent", deps), thinsqlitepp::exception);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,166 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/fts5.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace thinsqlitepp;
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 20, 0)
+
+TEST_SUITE_BEGIN("fts5");
+
+namespace
+{
+    std::string collect(database & db, const std::string & sql)
+    {
+        std::string ret;
+        db.exec(sql, [&](row r) noexcept {
+            for (int i = 0; i < r.size(); ++i)
+            {
+                ret += r[i].type() == SQLITE_NULL ? "null" : std::string(r[i].value<std::string_view>());
+                ret += i + 1 < r.size() ? '|' : '\n';
+            }
+            return true;
+        });
+        return ret;
+    }
+
+    std::unique_ptr<database> open_with_fts5()
+    {
+        auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+        try
+        {
+            get_fts5_api(*db);
+        }
+        catch(exception &)
+        {
+            //native SQLite may be built without FTS5
+            return nullptr;
+        }
+        return db;
+    }
+
+    //splits on a configurable character and records every token
+    class split_tokenizer : public fts5_tokenizer_base<split_tokenizer>
+    {
+    public:
+        using constructor_data_type = std::vector<std::string> *;
+
+        split_tokenizer(std::vector<std::string> * seen, int argc, const char * const * argv):
+            _seen(seen)
+        {
+            if (argc > 1)
+                throw exception(SQLITE_ERROR);
+            if (argc == 1)
+                _separator = argv[0][0];
+        }
+
+        void tokenize(int /*flags*/, std::string_view text, const token_sink & sink)
+        {
+            size_t start = 0;
+            while (start <= text.size())
+            {
+                size_t end = std::min(text.find(_separator, start), text.size());
+                if (end > start)
+                {
+                    auto token = text.substr(start, end - start);
+                    _seen->emplace_back(token);
+                    sink(token, int(start), int(end));
+                }
+                start = end + 1;
+            }
+        }
+    private:
+        std::vector<std::string> * _seen;
+        char _separator = ',';
+    };
+}
+
+TEST_CASE( "fts5 tokenizer" ) {
+
+    auto db = open_with_fts5();
+    if (!db)
+        return;
+
+    std::vector<std::string> seen;
+    split_tokenizer::create_tokenizer(*db, "split", &seen);
+    db->exec("CREATE VIRTUAL TABLE temp.docs USING fts5(body, tokenize = 'split')");
+    db->exec("INSERT INTO docs VALUES('red fox,blue sky'), ('blue sky,green grass')");
+    CHECK(seen == std::vector<std::string>{"red fox", "blue sky", "blue sky", "green grass"});
+    CHECK(collect(*db, "SELECT rowid FROM docs WHERE docs MATCH '\"blue sky\"' ORDER BY rowid") == "1\n2\n");
+    CHECK(collect(*db, "SELECT rowid FROM docs WHERE docs MATCH '\"red fox\"'") == "1\n");
+    CHECK(collect(*db, "SELECT rowid FROM docs WHERE docs MATCH 'red'").empty());
+
+    db->exec("CREATE VIRTUAL TABLE temp.docs2 USING fts5(body, tokenize = \"split ';'\")");
+    db->exec("INSERT INTO docs2 VALUES('a,b;c')");
+    CHECK(collect(*db, "SELECT rowid FROM docs2 WHERE docs2 MATCH '\"a,b\"'") == "1\n");
+
+    CHECK_THROWS_AS(db->exec("CREATE VIRTUAL TABLE temp.bad USING fts5(body, tokenize = 'split a b')"), thinsqlitepp::exception);
+}
+
+TEST_CASE( "fts5 ascii tokenizer" ) {
+
+    auto db = open_with_fts5();
+    if (!db)
+        return;
+
+    fts5_ascii_tokenizer::create_tokenizer(*db, "fastascii");
+    db->exec("CREATE VIRTUAL TABLE temp.logs USING fts5(line, tokenize = 'fastascii')");
+    db->exec("INSERT INTO logs VALUES('ERROR: Disk /dev/sda1 FULL'), ('warning: disk_usage at 91%'), ('Ошибка диска: сбой')");
+
+    CHECK(collect(*db, "SELECT rowid FROM logs WHERE logs MATCH 'error'") == "1\n");
+    CHECK(collect(*db, "SELECT rowid FROM logs WHERE logs MATCH 'disk' ORDER BY rowid") == "1\n2\n");
+    CHECK(collect(*db, "SELECT rowid FROM logs WHERE logs MATCH 'sda1 AND full'") == "1\n");
+    CHECK(collect(*db, "SELECT rowid FROM logs WHERE logs MATCH 'usage'") == "2\n");
+    CHECK(collect(*db, "SELECT rowid FROM logs WHERE logs MATCH 'диска'") == "3\n");
+    //non-ASCII text is not case folded
+    CHECK(collect(*db, "SELECT rowid FROM logs WHERE logs MATCH 'ошибка'").empty());
+    CHECK(collect(*db, "SELECT highlight(logs, 0, '[', ']') FROM logs WHERE logs MATCH 'full'") == "ERROR: Disk /dev/sda1 [FULL]\n");
+
+    db->exec("CREATE VIRTUAL TABLE temp.ids USING fts5(line, tokenize = \"fastascii tokenchars '_' separators '1'\")");
+    db->exec("INSERT INTO ids VALUES('disk_usage sda1x')");
+    CHECK(collect(*db, "SELECT rowid FROM ids WHERE ids MATCH 'disk_usage AND x'") == "1\n");
+    CHECK(collect(*db, "SELECT rowid FROM ids WHERE ids MATCH 'usage'").empty());
+
+    CHECK_THROWS_AS(db->exec("CREATE VIRTUAL TABLE temp.bad USING fts5(line, tokenize = 'fastascii colour red')"), thinsqlitepp::exception);
+}
+
+TEST_CASE( "fts5 functions" ) {
+
+    auto db = open_with_fts5();
+    if (!db)
+        return;
+
+    db->exec("CREATE VIRTUAL TABLE temp.docs USING fts5(title, body);"
+             "INSERT INTO docs VALUES('apple pie', 'apple and more apple'), ('pear', 'no fruit here apple'), ('kiwi', 'none')");
+
+    create_fts5_function(*db, "hits", [](const fts5_context & ctxt) {
+        return ctxt.inst_count();
+    });
+    CHECK(collect(*db, "SELECT rowid, hits(docs) FROM docs WHERE docs MATCH 'apple' ORDER BY rowid") == "1|3\n2|1\n");
+
+    create_fts5_function(*db, "weighted", [](const fts5_context & ctxt, double title_weight, std::optional<std::string_view> label) {
+        double score = 0;
+        for (int i = 0, count = ctxt.inst_count(); i < count; ++i)
+            score += ctxt.inst(i).column == 0 ? title_weight : 1;
+        return std::string(label.value_or("?")) + std::to_string(int(score)) + "/" + std::to_string(ctxt.column_size(-1)) +
+               "/" + std::to_string(ctxt.row_count()) + "/" + std::string(ctxt.column_text(0));
+    });
+    CHECK(collect(*db, "SELECT weighted(docs, 10, 'w') FROM docs WHERE docs MATCH 'apple' ORDER BY rowid") ==
+          "w12/6/3/apple pie\nw1/5/3/pear\n");
+    CHECK(collect(*db, "SELECT weighted(docs, 10, NULL) FROM docs WHERE docs MATCH 'pear'") == "?10/5/3/pear\n");
+    CHECK_THROWS_AS(db->exec("SELECT weighted(docs, 10) FROM docs WHERE docs MATCH 'pear'"), thinsqlitepp::exception);
+
+    create_fts5_function(*db, "failing", [](const fts5_context &) -> int {
+        throw exception(SQLITE_RANGE, error::message_ptr("boom"));
+    });
+    CHECK_THROWS_AS(db->exec("SELECT failing(docs) FROM docs WHERE docs MATCH 'pear'"), thinsqlitepp::exception);
+}
+
+TEST_SUITE_END();
+
+#endif
@@ -0,0 +1,90 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/memoized.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <string>
+
+using namespace thinsqlitepp;
+
+TEST_SUITE_BEGIN("memoized");
+
+namespace
+{
+    template<class T>
+    T select_one(database & db, const char * sql)
+    {
+        T ret{};
+        db.exec(sql, [&](row r) noexcept {
+            if constexpr (std::is_same_v<T, std::string>)
+                ret = r[0].value<std::string_view>();
+            else
+                ret = r[0].value<T>();
+            return false;
+        });
+        return ret;
+    }
+}
+
+TEST_CASE( "memoized function" ) {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+
+    int calls = 0;
+    memoized repeat([&](std::string_view str, int count) {
+        ++calls;
+        std::string ret;
+        for (int i = 0; i < count; ++i)
+            ret += str;
+        return ret;
+    }, 2);
+    static_assert(is_typed_function<decltype(&repeat)>);
+    db->create_function("repeat", &repeat, SQLITE_UTF8);
+
+    CHECK(select_one<std::string>(*db, "SELECT repeat('ab', 2)") == "abab");
+    CHECK(select_one<std::string>(*db, "SELECT repeat('ab', 2)") == "abab");
+    CHECK(select_one<std::string>(*db, "SELECT repeat('ab', '2')") == "abab");
+    CHECK(calls == 1);
+    CHECK(repeat.hits() == 2);
+    CHECK(repeat.misses() == 1);
+
+    CHECK(select_one<std::string>(*db, "SELECT repeat('ab', 3)") == "ababab");
+    CHECK(select_one<std::string>(*db, "SELECT repeat('cd', 1)") == "cd");
+    CHECK(calls == 3);
+    CHECK(repeat.size() == 2);
+
+    //('ab', 2) was the least recently used and got evicted
+    CHECK(select_one<std::string>(*db, "SELECT repeat('ab', 2)") == "abab");
+    CHECK(calls == 4);
+    CHECK(select_one<std::string>(*db, "SELECT repeat('cd', 1)") == "cd");
+    CHECK(calls == 4);
+
+    repeat.clear();
+    repeat.reset_stats();
+    CHECK(repeat.size() == 0);
+    db->exec("WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n WHERE x < 100) "
+             "SELECT repeat('z', x % 2) FROM n");
+    CHECK(repeat.misses() == 2);
+    CHECK(repeat.hits() == 98);
+
+    memoized nullable([](std::optional<int64_t> val) noexcept {
+        return val ? std::optional<double>(double(*val) / 2) : std::nullopt;
+    }, 10);
+    db->create_function("half", &nullable);
+    CHECK(select_one<double>(*db, "SELECT half(3)") == 1.5);
+    CHECK(select_one<int>(*db, "SELECT half(NULL) IS NULL") == 1);
+    CHECK(select_one<int>(*db, "SELECT half(NULL) IS NULL") == 1);
+    CHECK(nullable.hits() == 1);
+
+    memoized raw([](const value & val) { return val.type(); }, 10);
+    db->create_function("type_of", &raw);
+    CHECK(select_one<int>(*db, "SELECT type_of(1)") == SQLITE_INTEGER);
+    CHECK(select_one<int>(*db, "SELECT type_of('1')") == SQLITE_TEXT);
+    CHECK(select_one<int>(*db, "SELECT type_of(x'01')") == SQLITE_BLOB);
+    CHECK(select_one<int>(*db, "SELECT type_of('1')") == SQLITE_TEXT);
+    CHECK(raw.hits() == 1);
+    CHECK(raw.misses() == 3);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,201 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/query_cache.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <string>
+
+using namespace thinsqlitepp;
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 16, 0)
+
+TEST_SUITE_BEGIN("query_cache");
+
+namespace
+{
+    std::unique_ptr<database> open_db()
+    {
+        auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+        db->busy_timeout(5000);
+        return db;
+    }
+}
+
+TEST_CASE( "query_cache hits and invalidation" ) {
+
+    auto db = open_db();
+    db->exec("DROP TABLE IF EXISTS items; DROP TABLE IF EXISTS other; DROP VIEW IF EXISTS expensive;"
+             "CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT, price REAL);"
+             "CREATE TABLE other(a);"
+             "CREATE VIEW expensive AS SELECT name FROM items WHERE price > 10;"
+             "INSERT INTO items(name, price) VALUES('apple', 1.5), ('melon', 12), ('truffle', 900);");
+
+    query_cache cache(*db, 1024 * 1024);
+
+    auto res = cache.query("SELECT name, price FROM items WHERE price > ? ORDER BY id", 5);
+    REQUIRE(res->column_count() == 2);
+    CHECK(res->column_name(0) == "name");
+    REQUIRE(res->row_count() == 2);
+    CHECK(res->at(0, 0).get<std::string_view>() == "melon");
+    CHECK(res->at(1, 1).get<double>() == 900);
+    CHECK(cache.misses() == 1);
+
+    CHECK(cache.query("SELECT name, price FROM items WHERE price > ? ORDER BY id", 5) == res);
+    CHECK(cache.hits() == 1);
+    //different parameter value is a different query
+    CHECK(cache.query("SELECT name, price FROM items WHERE price > ? ORDER BY id", 100)->row_count() == 1);
+    CHECK(cache.misses() == 2);
+
+    auto view = cache.query("SELECT count(*) FROM expensive");
+    CHECK(view->at(0, 0).get<int>() == 2);
+    auto count_other = cache.query("SELECT count(*) FROM other");
+    CHECK(count_other->at(0, 0).get<int>() == 0);
+    CHECK(cache.size() == 4);
+
+    //writes to items forget everything that reads it, including via the view
+    db->exec("UPDATE items SET price = 20 WHERE name = 'apple'");
+    CHECK(cache.query("SELECT count(*) FROM other") == count_other);
+    CHECK(cache.size() == 1);
+    auto updated = cache.query("SELECT name, price FROM items WHERE price > ? ORDER BY id", 5);
+    CHECK(updated != res);
+    CHECK(updated->row_count() == 3);
+    CHECK(cache.query("SELECT count(*) FROM expensive")->at(0, 0).get<int>() == 3);
+
+    //queries touching tables modified by an open transaction are not remembered
+    db->exec("BEGIN; INSERT INTO other VALUES(1);");
+    auto in_transaction = cache.query("SELECT count(*) FROM other");
+    CHECK(in_transaction->at(0, 0).get<int>() == 1);
+    CHECK(cache.query("SELECT count(*) FROM other") != in_transaction);
+    db->exec("ROLLBACK");
+    CHECK(cache.query("SELECT count(*) FROM other")->at(0, 0).get<int>() == 0);
+    CHECK(cache.query("SELECT count(*) FROM other")->at(0, 0).get<int>() == 0);
+    CHECK(cache.size() == 3);
+
+    cache.invalidate("other");
+    CHECK(cache.size() == 2);
+
+    CHECK_THROWS_AS(cache.query("DELETE FROM items"), thinsqlitepp::exception);
+    CHECK(cache.query("SELECT count(*) FROM items")->at(0, 0).get<int>() == 3);
+}
+
+TEST_CASE( "query_cache with sql_text" ) {
+
+    auto db = open_db();
+    db->exec("DROP TABLE IF EXISTS items; CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT);"
+             "INSERT INTO items(name) VALUES('a'), ('b')");
+
+    query_cache cache(*db, 1024 * 1024);
+
+    auto res = cache.query("SELECT name FROM items WHERE id = ?"_sql, 2);
+    REQUIRE(res->row_count() == 1);
+    CHECK(res->at(0, 0).get<std::string_view>() == "b");
+    CHECK(cache.query("SELECT name FROM items WHERE id = ?"_sql, 2) == res);
+    //literals and runtime text of the same query are the same
+    std::string text = "SELECT name FROM items WHERE id = ?";
+    CHECK(cache.query(text, 2) == res);
+    CHECK(cache.query(sql_text(text), 2) == res);
+    CHECK(cache.hits() == 3);
+    CHECK(cache.misses() == 1);
+}
+
+TEST_CASE( "query_cache external changes" ) {
+
+    auto db = open_db();
+    db->exec("DROP TABLE IF EXISTS items; CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT);"
+             "INSERT INTO items(name) VALUES('a')");
+
+    query_cache cache(*db, 1024 * 1024);
+    CHECK(cache.query("SELECT count(*) FROM items")->at(0, 0).get<int>() == 1);
+
+    //commits by other connections are detected via data_version
+    auto other = open_db();
+    other->exec("INSERT INTO items(name) VALUES('b')");
+    CHECK(cache.query("SELECT count(*) FROM items")->at(0, 0).get<int>() == 2);
+
+    //schema changes recompile statements
+    db->exec("ALTER TABLE items ADD COLUMN price REAL DEFAULT 3");
+    auto res = cache.query("SELECT * FROM items");
+    CHECK(res->column_count() == 3);
+    CHECK(cache.query("SELECT * FROM items") == res);
+
+    //the truncate optimization does not call the update hook
+    auto count = cache.query("SELECT count(*) FROM items");
+    CHECK(count->at(0, 0).get<int>() == 2);
+    db->exec("DELETE FROM items");
+    CHECK(cache.query("SELECT count(*) FROM items")->at(0, 0).get<int>() == 0);
+    CHECK(cache.query("SELECT * FROM items")->row_count() == 0);
+
+    //neither do WITHOUT ROWID tables
+    db->exec("DROP TABLE IF EXISTS keyed; CREATE TABLE keyed(k TEXT PRIMARY KEY) WITHOUT ROWID");
+    CHECK(cache.query("SELECT count(*) FROM keyed")->at(0, 0).get<int>() == 0);
+    db->exec("INSERT INTO keyed VALUES('x')");
+    CHECK(cache.query("SELECT count(*) FROM keyed")->at(0, 0).get<int>() == 1);
+}
+
+TEST_CASE( "query_cache memory limit" ) {
+
+    auto db = open_db();
+    db->exec("DROP TABLE IF EXISTS items; CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT);"
+             "INSERT INTO items(name) VALUES('a')");
+
+    auto first = [&]() {
+        query_cache probe(*db, 1024 * 1024);
+        probe.query("SELECT name FROM items WHERE id = ?", 1);
+        return probe.memory_used();
+    }();
+    REQUIRE(first > 0);
+
+    query_cache cache(*db, 3 * first);
+    for (int i = 0; i < 10; ++i)
+        cache.query("SELECT name FROM items WHERE id = ?", i);
+    CHECK(cache.size() == 3);
+    CHECK(cache.memory_used() <= cache.max_memory());
+
+    //the most recent ones survive
+    cache.reset_stats();
+    cache.query("SELECT name FROM items WHERE id = ?", 9);
+    cache.query("SELECT name FROM items WHERE id = ?", 0);
+    CHECK(cache.hits() == 1);
+    CHECK(cache.misses() == 1);
+}
+
+TEST_CASE( "query_cache statement limit" ) {
+
+    auto db = open_db();
+    db->exec("DROP TABLE IF EXISTS items; CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT);"
+             "INSERT INTO items(name) VALUES('a')");
+
+    query_cache cache(*db, 1024 * 1024, 2);
+    const std::string base = "SELECT name FROM items WHERE id = ";
+    for (int i = 0; i < 5; ++i)
+        cache.query(base + std::to_string(i));
+    //statements with remembered results are kept
+    CHECK(cache.size() == 5);
+    CHECK(cache.statement_count() == 5);
+
+    //once their results are gone only the most recently used ones stay
+    db->exec("INSERT INTO items(name) VALUES('b')");
+    CHECK(cache.size() == 0);
+    CHECK(cache.statement_count() == 2);
+    cache.reset_stats();
+    CHECK(cache.query(base + "4")->empty());
+    CHECK(cache.statement_count() == 2);
+    CHECK(cache.query(base + "0")->empty());
+    CHECK(cache.size() == 2);
+    CHECK(cache.statement_count() == 3);
+
+    //results that are not remembered do not keep statements
+    query_cache tiny(*db, 1, 2);
+    for (int i = 0; i < 5; ++i)
+        CHECK(tiny.query(base + std::to_string(i))->row_count() == (i == 1 || i == 2 ? 1 : 0));
+    CHECK(tiny.size() == 0);
+    CHECK(tiny.statement_count() == 2);
+
+    cache.clear();
+    CHECK(cache.statement_count() == 0);
+}
+
+TEST_SUITE_END();
+
+#endif
@@ -0,0 +1,102 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/rtree.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <string>
+
+using namespace thinsqlitepp;
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 8, 5)
+
+TEST_SUITE_BEGIN("rtree");
+
+namespace
+{
+    std::string collect(database & db, const std::string & sql)
+    {
+        std::string ret;
+        db.exec(sql, [&](row r) noexcept {
+            for (int i = 0; i < r.size(); ++i)
+            {
+                ret += r[i].type() == SQLITE_NULL ? "null" : std::string(r[i].value<std::string_view>());
+                ret += i + 1 < r.size() ? '|' : '\n';
+            }
+            return true;
+        });
+        return ret;
+    }
+
+    //a 40x40 grid of points with id = x * 40 + y + 1
+    std::unique_ptr<database> make_grid()
+    {
+        auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+        db->exec("CREATE VIRTUAL TABLE temp.pts USING rtree(id, x0, x1, y0, y1);"
+                 "WITH RECURSIVE n(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM n WHERE i < 39) "
+                 "INSERT INTO pts SELECT a.i * 40 + b.i + 1, a.i, a.i, b.i, b.i FROM n a, n b");
+        return db;
+    }
+}
+
+TEST_CASE( "rtree circle" ) {
+
+    auto db = make_grid();
+    create_rtree_query_callback(*db, "circle", rtree_circle{});
+
+    CHECK(collect(*db, "SELECT count(*) FROM pts WHERE id MATCH circle(20, 20, 3)") == "29\n");
+    CHECK(collect(*db, "SELECT id FROM pts WHERE id MATCH circle(0, 0, 1) ORDER BY id") == "1\n2\n41\n");
+    CHECK(collect(*db, "SELECT count(*) FROM pts WHERE id MATCH circle(-10, -10, 2)") == "0\n");
+    CHECK(collect(*db, "SELECT count(*) FROM pts WHERE id MATCH circle(20, 20, 100)") == "1600\n");
+    CHECK_THROWS_AS(db->exec("SELECT count(*) FROM pts WHERE id MATCH circle(1, 2)"), thinsqlitepp::exception);
+
+    //pruning: only a fraction of entries reaches the callback
+    int leaves = 0, nodes = 0;
+    create_rtree_query_callback(*db, "counted_circle", [&](rtree_query_info & info) noexcept {
+        ++(info.is_leaf() ? leaves : nodes);
+        return rtree_circle{}(info);
+    });
+    CHECK(collect(*db, "SELECT count(*) FROM pts WHERE id MATCH counted_circle(20, 20, 3)") == "29\n");
+    CHECK(nodes > 0);
+    CHECK(leaves >= 29);
+    CHECK(leaves < 400);
+}
+
+TEST_CASE( "rtree polygon" ) {
+
+    auto db = make_grid();
+    rtree_polygon polygon;
+    create_rtree_query_callback(*db, "polygon", &polygon);
+
+    //boundary points match
+    CHECK(collect(*db, "SELECT count(*) FROM pts WHERE id MATCH polygon(0, 0, 10, 0, 0, 10)") == "66\n");
+    CHECK(collect(*db, "SELECT count(*) FROM pts WHERE id MATCH polygon(-1, -1, 41, -1, 41, 41, -1, 41)") == "1600\n");
+    //a concave "L" shape
+    CHECK(collect(*db, "SELECT count(*) FROM pts WHERE id MATCH polygon(0.5, 0.5, 3.5, 0.5, 3.5, 1.5, 1.5, 1.5, 1.5, 3.5, 0.5, 3.5)") == "5\n");
+    CHECK(collect(*db, "SELECT count(*) FROM pts WHERE id MATCH polygon(100, 100, 110, 100, 100, 110)") == "0\n");
+    CHECK_THROWS_AS(db->exec("SELECT count(*) FROM pts WHERE id MATCH polygon(0, 0, 10, 0)"), thinsqlitepp::exception);
+}
+
+TEST_CASE( "rtree callbacks" ) {
+
+    auto db = make_grid();
+
+    create_rtree_query_callback(*db, "near_leaf", +[](rtree_query_info & info) noexcept {
+        auto params = info.parameters();
+        if (info.is_leaf())
+            info.set_within(info.rowid() == int64_t(params[0]) ? FULLY_WITHIN : NOT_WITHIN);
+    });
+    CHECK(collect(*db, "SELECT x0, y0 FROM pts WHERE id MATCH near_leaf(42)") == "1.0|1.0\n");
+
+    auto box = [](const rtree_geometry & geom, span<const sqlite3_rtree_dbl> coords) noexcept {
+        auto params = geom.parameters();
+        return params.size() == 4 && coords[0] <= params[1] && coords[1] >= params[0] &&
+                                     coords[2] <= params[3] && coords[3] >= params[2];
+    };
+    create_rtree_geometry_callback(*db, "box", &box);
+    CHECK(collect(*db, "SELECT id FROM pts WHERE id MATCH box(2, 3, 2, 3) ORDER BY id") == "83\n84\n123\n124\n");
+}
+
+TEST_SUITE_END();
+
+#endif
@@ -0,0 +1,187 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/session.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+
+using namespace thinsqlitepp;
+
+#if defined(SQLITE_ENABLE_SESSION) && defined(SQLITE_ENABLE_PREUPDATE_HOOK) && \
+    SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 13, 0)
+
+TEST_SUITE_BEGIN("session");
+
+namespace
+{
+    std::string select_all(database & db, const char * table)
+    {
+        std::string ret;
+        db.exec(std::string("SELECT * FROM ") + table + " ORDER BY 1", [&] (row r) noexcept {
+            for (auto c: r)
+            {
+                ret += c.value<std::string_view>();
+                ret += ',';
+            }
+            ret += ';';
+            return true;
+        });
+        return ret;
+    }
+
+    bool same_bytes(const blob_view & lhs, const blob_view & rhs)
+        { return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+}
+
+TEST_CASE( "session basics" ) {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS src; CREATE TABLE src(id INTEGER PRIMARY KEY, name TEXT);"
+             "DROP TABLE IF EXISTS other; CREATE TABLE other(id INTEGER PRIMARY KEY);"
+             "INSERT INTO src VALUES(1, 'a'), (2, 'b')");
+
+    auto sess = session::create(*db);
+    CHECK(sess->enabled());
+    CHECK(!sess->is_indirect());
+    sess->attach(nullptr);
+    auto filter = [](const char * table) noexcept { return strcmp(table, "src") == 0; };
+    sess->table_filter(&filter);
+    CHECK(sess->empty());
+
+    db->exec("INSERT INTO src VALUES(3, 'c'); UPDATE src SET name = 'x' WHERE id = 1; DELETE FROM src WHERE id = 2;"
+             "INSERT INTO other VALUES(1)");
+    CHECK(!sess->empty());
+
+    auto changes = sess->changeset();
+    REQUIRE(!changes.empty());
+
+    int inserts = 0, updates = 0, deletes = 0;
+    auto it = changeset_iterator::start(changes);
+    while (it->next())
+    {
+        auto op = it->op();
+        CHECK(op.table == std::string_view("src"));
+        CHECK(op.column_count == 2);
+        CHECK(!op.indirect);
+        auto pk = it->primary_key();
+        REQUIRE(pk.size() == 2);
+        CHECK(pk[0]);
+        CHECK(!pk[1]);
+        switch(op.code)
+        {
+        case SQLITE_INSERT:
+            ++inserts;
+            CHECK(it->new_value(1)->get<std::string_view>() == "c");
+            break;
+        case SQLITE_UPDATE:
+            ++updates;
+            CHECK(it->old_value(1)->get<std::string_view>() == "a");
+            CHECK(it->new_value(1)->get<std::string_view>() == "x");
+            break;
+        case SQLITE_DELETE:
+            ++deletes;
+            CHECK(it->old_value(0)->get<int64_t>() == 2);
+            break;
+        }
+    }
+    CHECK(inserts == 1);
+    CHECK(updates == 1);
+    CHECK(deletes == 1);
+
+    //apply to a replica
+    auto replica = database::open("replica.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    replica->exec("DROP TABLE IF EXISTS src; CREATE TABLE src(id INTEGER PRIMARY KEY, name TEXT);"
+                  "INSERT INTO src VALUES(1, 'a'), (2, 'b')");
+    int conflicts = 0;
+    auto on_conflict = [&](int, changeset_iterator *) noexcept { ++conflicts; return SQLITE_CHANGESET_OMIT; };
+    changeset::apply(*replica, changes, &on_conflict);
+    CHECK(conflicts == 0);
+    CHECK(select_all(*replica, "src") == "1,x,;3,c,;");
+
+    //reapplying conflicts on every change
+    changeset::apply(*replica, changes, &on_conflict);
+    CHECK(conflicts == 3);
+
+    //invert undoes
+    auto inverted = changeset::invert(changes);
+    changeset::apply(*replica, inverted, &on_conflict);
+    CHECK(select_all(*replica, "src") == "1,a,;2,b,;");
+
+    //filter skips
+    auto skip_all = [](const char *) noexcept { return false; };
+    changeset::apply(*replica, changes, &on_conflict, &skip_all);
+    CHECK(select_all(*replica, "src") == "1,a,;2,b,;");
+
+    auto patch = sess->patchset();
+    CHECK(!patch.empty());
+
+    auto group = changegroup::create();
+    group->add(changes);
+    group->add(inverted);
+    auto combined = group->output();
+    auto it2 = changeset_iterator::start(combined);
+    CHECK(!it2->next());
+
+    CHECK(same_bytes(changeset::concat(changes, inverted), combined));
+}
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 14, 0)
+
+TEST_CASE( "session streaming" ) {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS src; CREATE TABLE src(id INTEGER PRIMARY KEY, name TEXT)");
+
+    auto sess = session::create(*db);
+    sess->attach("src");
+    db->exec("INSERT INTO src VALUES(1, 'a'), (2, 'b'), (3, 'c')");
+
+    std::vector<std::byte> buffer;
+    auto writer = [&](span<const std::byte> data) { buffer.insert(buffer.end(), data.begin(), data.end()); };
+    sess->changeset(&writer);
+    CHECK(same_bytes(blob_view(buffer.data(), buffer.size()), sess->changeset()));
+
+    size_t read_pos = 0;
+    auto reader = [&](span<std::byte> dest) -> size_t {
+        size_t count = std::min(dest.size(), std::min(size_t(5), buffer.size() - read_pos));
+        memcpy(dest.data(), buffer.data() + read_pos, count);
+        read_pos += count;
+        return count;
+    };
+
+    int count = 0;
+    auto it = changeset_iterator::start(&reader);
+    while (it->next())
+        ++count;
+    CHECK(count == 3);
+    it.reset();
+
+    auto replica = database::open("replica.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    replica->exec("DROP TABLE IF EXISTS src; CREATE TABLE src(id INTEGER PRIMARY KEY, name TEXT)");
+    auto on_conflict = [](int, changeset_iterator *) noexcept { return SQLITE_CHANGESET_ABORT; };
+    read_pos = 0;
+    changeset::apply(*replica, &reader, &on_conflict);
+    CHECK(select_all(*replica, "src") == "1,a,;2,b,;3,c,;");
+
+    std::vector<std::byte> inverted;
+    auto inverted_writer = [&](span<const std::byte> data) { inverted.insert(inverted.end(), data.begin(), data.end()); };
+    read_pos = 0;
+    changeset::invert(&reader, &inverted_writer);
+    CHECK(same_bytes(blob_view(inverted.data(), inverted.size()), changeset::invert(sess->changeset())));
+
+    //exceptions propagate
+    auto failing_writer = [](span<const std::byte>) { throw std::runtime_error("haha"); };
+    CHECK_THROWS_AS(sess->patchset(&failing_writer), std::runtime_error);
+
+    auto failing_reader = [](span<std::byte>) -> size_t { throw exception(SQLITE_IOERR); };
+    CHECK_THROWS_AS(changeset::apply(*replica, &failing_reader, &on_conflict), exception);
+}
+
+#endif
+
+TEST_SUITE_END();
+
+#endif
@@ -93,4 +93,180 @@ TEST_CASE( "statement looping" ) {
     
 }
 
+TEST_CASE( "statement non-throwing" ) {
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS foo; CREATE TABLE foo(name TEXT, num INTEGER)");
+
+    auto bad = statement::try_create(*db, "SELEKT 1");
+    CHECK(!bad);
+    CHECK(bad.code().primary() == SQLITE_ERROR);
+    CHECK(bad.error().message() == "near \"SELEKT\": syntax error"s);
+    CHECK_THROWS_AS(bad.value(), thinsqlitepp::exception);
+
+    std::string_view sql = "INSERT INTO foo VALUES(?, ?); SELECT 1";
+    auto created = statement::try_create(*db, sql);
+    REQUIRE(created);
+    CHECK(sql == " SELECT 1");
+    auto stmt = std::move(created).value();
+    REQUIRE(stmt);
+
+    CHECK(stmt->try_bind(1, "abc"sv));
+    CHECK(stmt->try_bind(2, 5));
+    CHECK(stmt->try_bind(3, 1.5).code() == SQLITE_RANGE);
+    CHECK(stmt->try_bind(3, nullptr).error().primary() == SQLITE_RANGE);
+    auto stepped = stmt->try_step();
+    REQUIRE(stepped);
+    CHECK(*stepped == false);
+    stmt->reset();
+
+    //contention is reported without exceptions
+    auto other = database::open("foo.db", SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    other->exec("BEGIN EXCLUSIVE");
+    stepped = stmt->try_step();
+    CHECK(!stepped);
+    CHECK(stepped.code().primary() == SQLITE_BUSY);
+    CHECK(stepped.error().primary() == SQLITE_BUSY);
+    CHECK_THROWS_AS(stepped.value(), thinsqlitepp::exception);
+    stmt->reset();
+    other->exec("COMMIT");
+    CHECK(stmt->try_step().value() == false);
+
+    auto select = statement::create(*db, "SELECT count(*) FROM foo");
+    CHECK(select->try_step().value());
+    CHECK(select->column_value<int>(0) == 2);
+}
+
+TEST_CASE( "statement from sql_text" ) {
+    
+    constexpr auto select = "SELECT name FROM foo WHERE num = ?"_sql;
+    static_assert(select.size() == 34);
+    static_assert(select.hash() == sql_text::hash_of("SELECT name FROM foo WHERE num = ?"));
+    static_assert(select.is_literal());
+    static_assert(select == sql_text("SELECT name FROM foo WHERE num = ?"sv));
+    static_assert(select != "SELECT name FROM foo WHERE num = ?;"_sql);
+    CHECK(!sql_text("SELECT 1"sv).is_literal());
+    CHECK(std::hash<sql_text>()(select) == select.hash());
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS foo; CREATE TABLE foo(name TEXT, num INTEGER)"_sql);
+    db->exec("INSERT INTO foo VALUES('a', 1), ('b', 2)"_sql);
+
+    auto stmt = statement::create(*db, select);
+    REQUIRE(stmt);
+    CHECK(stmt->sql() == "SELECT name FROM foo WHERE num = ?"s);
+    stmt->bind(1, 2);
+    REQUIRE(stmt->step());
+    CHECK(stmt->column_value<std::string_view>(0) == "b");
+
+    //not null terminated
+    std::string_view text = "SELECT num FROM foo WHERE name = 'a' garbage";
+    stmt = statement::create(*db, sql_text(text.substr(0, 36)));
+    REQUIRE(stmt);
+    REQUIRE(stmt->step());
+    CHECK(stmt->column_value<int>(0) == 1);
+
+    CHECK(!statement::create(*db, ""_sql));
+    CHECK(!statement::try_create(*db, "SELEKT 1"_sql));
+    CHECK_THROWS_AS(statement::create(*db, "SELEKT 1"_sql), thinsqlitepp::exception);
+}
+
+TEST_CASE( "statement named parameters" ) {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS foo; CREATE TABLE foo(id INTEGER, name TEXT, price REAL)");
+
+    auto stmt = statement::create(*db, "INSERT INTO foo VALUES(:id, @name, $price + ?4 + :id)");
+    named_parameters params(stmt);
+    CHECK(params.owner() == stmt.get());
+    CHECK(params.index_of(":id") == 1);
+    CHECK(params.index_of("@name") == 2);
+    CHECK(params.index_of("$price"_param) == 3);
+    CHECK(params.index_of(":name") == 0);
+    CHECK(params.index_of("?4") == 4);
+    CHECK(params.index_of("") == 0);
+    for (auto name: {":id", "@name", "$price", "?4", ":nope"})
+        CHECK(params.index_of(name) == stmt->bind_parameter_index(name));
+
+    constexpr auto id = ":id"_param;
+    static_assert(id.name() == ":id");
+    static_assert(id.hash() == sql_text::hash_of(":id"));
+
+    params.bind(id, 7);
+    params.bind("@name", "abc"s);
+    params.bind_reference("$price"_param, "1.5"sv);
+    params.bind("?4", 0.5);
+    CHECK_THROWS_AS(params.bind(":nope", 1), thinsqlitepp::exception);
+    CHECK(params.try_bind(":nope"_param, 1).primary() == SQLITE_RANGE);
+    CHECK(params.try_bind(":id", 7).ok());
+    stmt->step();
+
+    auto select = statement::create(*db, "SELECT id, name, price FROM foo");
+    REQUIRE(select->step());
+    CHECK(select->column_value<int>(0) == 7);
+    CHECK(select->column_value<std::string_view>(1) == "abc");
+    CHECK(select->column_value<double>(2) == 9);
+
+    //many parameters
+    std::string sql = "SELECT ";
+    for (int i = 1; i <= 100; ++i)
+        sql += (i > 1 ? ", :p" : ":p") + std::to_string(i);
+    stmt = statement::create(*db, sql);
+    params.reset(stmt.get());
+    for (int i = 1; i <= 100; ++i)
+        CHECK(params.index_of(":p" + std::to_string(i)) == i);
+    CHECK(params.index_of(":p101") == 0);
+}
+
+TEST_CASE( "row access by name" ) {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    db->exec("DROP TABLE IF EXISTS foo; CREATE TABLE foo(name TEXT, num INTEGER)");
+    db->exec("INSERT INTO foo VALUES('a', 1), ('b', 2)");
+
+    auto stmt = statement::create(*db, "SELECT *, num * 10 AS big, name FROM foo ORDER BY num");
+    int count = 0;
+    for (auto row: row_range(stmt))
+    {
+        ++count;
+        CHECK(row.index_of("name") == 0);
+        CHECK(row.index_of("num") == 1);
+        CHECK(row.index_of("big") == 2);
+        CHECK(row.index_of("NUM") == -1);
+        CHECK(row.index_of("missing") == -1);
+        CHECK(row["num"].value<int>() == count);
+        CHECK(row["big"].value<int>() == count * 10);
+        CHECK(row["name"].name() == "name"s);
+        CHECK(row["missing"].type() == SQLITE_NULL);
+    }
+    CHECK(count == 2);
+    static_assert(std::is_trivially_copyable_v<row>);
+
+    //an assigned iterator does not reuse the names of the previous statement
+    auto first = statement::create(*db, "SELECT 1 AS a, 2 AS b");
+    auto second = statement::create(*db, "SELECT 10 AS b, 20 AS a");
+    row_iterator it(first);
+    CHECK((*it)["a"].value<int>() == 1);
+    it = row_iterator(second);
+    CHECK((*it)["a"].value<int>() == 20);
+
+    stmt->reset();
+    REQUIRE(stmt->step());
+    row standalone(stmt);
+    CHECK(standalone["name"].value<std::string_view>() == "a");
+    CHECK(standalone.index_of("big") == 2);
+
+    //names are recomputed when the statement is re-prepared
+    stmt = statement::create(*db, "SELECT * FROM foo ORDER BY num");
+    row current(stmt);
+    REQUIRE(stmt->step());
+    CHECK(current.index_of("num") == 1);
+    CHECK(current.index_of("extra") == -1);
+    stmt->reset();
+    db->exec("ALTER TABLE foo ADD COLUMN extra TEXT DEFAULT 'x'");
+    REQUIRE(stmt->step());
+    CHECK(current.index_of("extra") == 2);
+    CHECK(current["extra"].value<std::string_view>() == "x");
+    CHECK(current["num"].value<int>() == 1);
+}
+
 TEST_SUITE_END();
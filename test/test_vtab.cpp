@@ -2,8 +2,13 @@
 #include "mock_sqlite.hpp"
 
 #include <thinsqlitepp/vtab.hpp>
+#include <thinsqlitepp/ordered_vtab.hpp>
 #include <thinsqlitepp/memory.hpp>
 #include <thinsqlitepp/database.hpp>
+#include <thinsqlitepp/statement.hpp>
+
+#include <algorithm>
+#include <optional>
 
 using namespace thinsqlitepp;
 
@@ -74,11 +79,223 @@ namespace
         std::vector<entry> * _entries;
     };
 
+    //Numbers from 0 to 9 with pooled cursors
+    class pooled_table : public vtab<pooled_table>
+    {
+    public:
+        static constexpr size_t cursor_pool_size = 2;
+
+        static inline int cursors_created = 0;
+        static inline int cursors_destroyed = 0;
+
+        pooled_table(
+        #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 9, 0)
+            connect_t,
+        #endif
+            database * db, int /*argc*/, const char * const * /*argv*/)
+        {
+            db->declare_vtab("CREATE TABLE _ (x INTEGER)");
+        }
+
+        class cursor : public vtab::cursor
+        {
+        public:
+            cursor(pooled_table * owner): vtab::cursor(owner)
+                { ++cursors_created; }
+            ~cursor()
+                { ++cursors_destroyed; }
+
+            void filter(int /*idx*/, int /*argc*/, value ** /*argv*/)
+                { _current = 0; }
+            bool eof() const noexcept
+                { return _current == 10; }
+            void next()
+                { ++_current; }
+            int64_t rowid() const noexcept
+                { return _current; }
+            void column(context & ctxt, int /*idx*/) const noexcept
+                { ctxt.result(_current); }
+        private:
+            int64_t _current = 0;
+        };
+    };
+
     template<class LHS, class RHS>
     bool equalRanges(const LHS & lhs, const RHS & rhs)
     {
         return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
+
+    template<class Container>
+    class container_table : public ordered_vtab<container_table<Container>, Container>
+    {
+        using base = ordered_vtab<container_table<Container>, Container>;
+    public:
+        using constructor_data_type = Container *;
+
+        container_table(
+        #if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 9, 0)
+            typename base::connect_t,
+        #endif
+            database * db, Container * data, int /*argc*/, const char * const * /*argv*/):
+            base(*data)
+        {
+            if constexpr (std::is_integral_v<typename base::key_type>)
+                db->declare_vtab("CREATE TABLE _ (key INTEGER, value TEXT)");
+            else
+                db->declare_vtab("CREATE TABLE _ (key TEXT, value INTEGER)");
+        }
+
+        class cursor : public base::cursor
+        {
+        public:
+            using base::cursor::cursor;
+
+            void column(context & ctxt, int idx) const
+            {
+                if (idx == 0)
+                    ctxt.result(this->key());
+                else
+                    ctxt.result(this->current().second);
+            }
+        };
+    };
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+
+    //Numbers from 0 to size - 1 that handle equality and LIMIT/OFFSET themselves
+    class sequence_table : public vtab<sequence_table>
+    {
+    public:
+        struct state
+        {
+            int64_t size = 0;
+            int64_t produced = 0;
+            std::optional<int64_t> planned_value;
+        };
+        using constructor_data_type = state *;
+
+        sequence_table(connect_t, database * db, state * st, int /*argc*/, const char * const * /*argv*/):
+            _state(st)
+        {
+            db->declare_vtab("CREATE TABLE _ (x INTEGER, y INTEGER)");
+        }
+
+        bool best_index(index_info<> & info) const
+        {
+            const auto constraints = info.constraints();
+            auto usages = info.constraints_usage();
+            int flags = 0;
+            for (size_t i = 0; i < constraints.size(); ++i)
+            {
+                if (constraints[i].usable && constraints[i].iColumn == 0 && constraints[i].op == SQLITE_INDEX_CONSTRAINT_EQ)
+                {
+                    usages[i].argvIndex = 1;
+                    usages[i].omit = true;
+                    flags = 4;
+                    value * rhs = info.rhs_value(int(i));
+                    _state->planned_value = rhs ? std::optional<int64_t>(rhs->get<int64_t>()) : std::nullopt;
+                    break;
+                }
+            }
+            auto orderbys = info.orderbys();
+            if (orderbys.size() == 1 && orderbys[0].iColumn == 0 && !orderbys[0].desc)
+                info.set_order_by_consumed(true);
+            flags |= info.forward_limit_offset();
+            info.set_index_number(flags);
+            info.set_estimated_cost(flags & 4 ? 1 : double(_state->size));
+            return true;
+        }
+
+        class cursor : public vtab::cursor
+        {
+        public:
+            using vtab::cursor::cursor;
+
+            void filter(int idx, int argc, value ** argv)
+            {
+                auto limits = limit_offset::extract(idx, argc, argv);
+                _current = 0;
+                _end = owner()->_state->size;
+                if (idx & 4)
+                {
+                    REQUIRE(argc == 1);
+                    _current = std::clamp(argv[0]->get<int64_t>(), int64_t(0), _end);
+                    _end = std::min(_current + 1, _end);
+                }
+                _current = std::min(_current + limits.offset, _end);
+                if (limits.limit >= 0)
+                    _end = std::min(_current + limits.limit, _end);
+            }
+            bool eof() const noexcept
+                { return _current == _end; }
+            void next()
+                { ++_current; }
+            int64_t rowid() const noexcept
+                { return _current; }
+            void column(context & ctxt, int idx) const noexcept
+            {
+                if (_counted != _current)
+                {
+                    _counted = _current;
+                    ++owner()->_state->produced;
+                }
+                ctxt.result(idx == 0 ? _current : _current % 3);
+            }
+        private:
+            int64_t _current = 0;
+            int64_t _end = 0;
+            mutable int64_t _counted = -1;
+        };
+
+    private:
+        state * _state;
+    };
+
+#endif
+
+    //Throws exceptions with non-owned messages from constructor and filter
+    class failing_table : public vtab<failing_table>
+    {
+    public:
+        failing_table(database * db, int argc, const char * const * argv)
+        {
+            if (argc > 3 && std::string_view(argv[3]) == "ctor")
+                throw exception(SQLITE_ERROR, error::message_ptr("constructor failed"));
+            db->declare_vtab("CREATE TABLE _ (x INTEGER)");
+        }
+
+        class cursor : public vtab::cursor
+        {
+        public:
+            using vtab::cursor::cursor;
+
+            void filter(int /*idx*/, int /*argc*/, value ** /*argv*/)
+                { throw exception(SQLITE_ERROR, error::message_ptr("filter failed")); }
+            bool eof() const noexcept
+                { return true; }
+            void next()
+                {}
+            int64_t rowid() const noexcept
+                { return 0; }
+            void column(context & /*ctxt*/, int /*idx*/) const noexcept
+                {}
+        };
+    };
+
+    std::string collect(database & db, const std::string & sql)
+    {
+        std::string ret;
+        db.exec(sql, [&](row r) noexcept {
+            for (int i = 0; i < r.size(); ++i)
+            {
+                ret += r[i].type() == SQLITE_NULL ? "null" : std::string(r[i].value<std::string_view>());
+                ret += i + 1 < r.size() ? '|' : '\n';
+            }
+            return true;
+        });
+        return ret;
+    }
 }
 
 TEST_SUITE_BEGIN("vtab");
@@ -124,4 +341,184 @@ TEST_CASE( "basics" ) {
 }
 
 
+TEST_CASE( "ordered vtab" ) {
+
+    using map_type = std::map<int64_t, std::string>;
+    using multimap_type = std::multimap<int, std::string>;
+    using vector_type = std::vector<std::pair<std::string, int64_t>>;
+
+    static_assert(container_table<map_type>::key_is_rowid);
+    static_assert(!container_table<multimap_type>::key_is_rowid);
+    static_assert(!container_table<vector_type>::key_is_rowid);
+
+    map_type map;
+    multimap_type multimap;
+    vector_type vector;
+    for (int i = 0; i < 300; ++i)
+    {
+        map.emplace(i * 3 - 150, std::to_string(i));
+        multimap.emplace(i % 40, std::to_string(i));
+        vector.emplace_back(std::to_string(i * 7 % 300), i);
+    }
+    std::sort(vector.begin(), vector.end());
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    container_table<map_type>::create_module(*db, "map", &map);
+    container_table<multimap_type>::create_module(*db, "multimap", &multimap);
+    container_table<vector_type>::create_module(*db, "vector", &vector);
+    #if SQLITE_VERSION_NUMBER < SQLITEPP_SQLITE_VERSION(3, 9, 0)
+    db->exec("CREATE VIRTUAL TABLE temp.map USING map;"
+             "CREATE VIRTUAL TABLE temp.multimap USING multimap;"
+             "CREATE VIRTUAL TABLE temp.vector USING vector");
+    #endif
+
+    db->exec("DROP TABLE IF EXISTS ref_map; CREATE TABLE ref_map(key INTEGER, value TEXT);"
+             "DROP TABLE IF EXISTS ref_multimap; CREATE TABLE ref_multimap(key INTEGER, value TEXT);"
+             "DROP TABLE IF EXISTS ref_vector; CREATE TABLE ref_vector(key TEXT, value INTEGER);"
+             "INSERT INTO ref_map SELECT * FROM map;"
+             "INSERT INTO ref_multimap SELECT * FROM multimap;"
+             "INSERT INTO ref_vector SELECT * FROM vector");
+
+    CHECK(collect(*db, "SELECT count(*) FROM ref_multimap") == "300\n");
+
+    const char * numeric_conditions[] = {
+        "key = 42", "key = 7.0", "key = 7.5", "key > 30", "key >= 30 AND key < 33.5", "key <= -140",
+        "key > 10 AND key < 5", "key >= 12 AND key <= 12", "key > 12 AND key <= 12", "key < 1e100", "key > -1e100",
+        "key > 9223372036854775807", "key = '42'", "key = NULL", "key > 12 AND key > 20 AND key < 100 AND key < 60"
+    };
+    const char * text_conditions[] = {
+        "key = '42'", "key > '5'", "key >= '1' AND key < '2'", "key = 42", "key < 'a' COLLATE NOCASE", "key = ''"
+    };
+    const char * orders[] = {"", " ORDER BY key", " ORDER BY key DESC", " ORDER BY key DESC, value"};
+
+    for (const char * order: orders)
+    {
+        for (const char * table: {"map", "multimap"})
+        {
+            for (const char * where: numeric_conditions)
+            {
+                const std::string condition = std::string(" WHERE ") + where + order;
+                CHECK(condition + collect(*db, "SELECT key, value FROM " + std::string(table) + condition + (*order ? ", value" : " ORDER BY key, value")) ==
+                      condition + collect(*db, "SELECT key, value FROM ref_" + std::string(table) + condition + (*order ? ", value" : " ORDER BY key, value")));
+            }
+        }
+        for (const char * where: text_conditions)
+        {
+            const std::string condition = std::string(" WHERE ") + where + order;
+            CHECK(condition + collect(*db, "SELECT key, value FROM vector" + condition + (*order ? ", value" : " ORDER BY key, value")) ==
+                  condition + collect(*db, "SELECT key, value FROM ref_vector" + condition + (*order ? ", value" : " ORDER BY key, value")));
+        }
+    }
+
+    CHECK(collect(*db, "SELECT key FROM multimap WHERE key > 30 ORDER BY key DESC") ==
+          collect(*db, "SELECT key FROM ref_multimap WHERE key > 30 ORDER BY key DESC"));
+    CHECK(collect(*db, "SELECT rowid FROM map WHERE rowid BETWEEN 0 AND 10 ORDER BY rowid DESC") == "9\n6\n3\n0\n");
+
+    //ordering by key is done by the table itself
+    CHECK(collect(*db, "EXPLAIN QUERY PLAN SELECT * FROM map WHERE key > 5 ORDER BY key DESC").find("ORDER BY") == std::string::npos);
+    CHECK(collect(*db, "EXPLAIN QUERY PLAN SELECT * FROM multimap ORDER BY key").find("ORDER BY") == std::string::npos);
+    CHECK(collect(*db, "EXPLAIN QUERY PLAN SELECT * FROM multimap ORDER BY key, value").find("ORDER BY") != std::string::npos);
+
+    #if SQLITE_VERSION_NUMBER < SQLITEPP_SQLITE_VERSION(3, 9, 0)
+    db->exec("DROP TABLE map; DROP TABLE multimap; DROP TABLE vector");
+    #endif
+}
+
+TEST_CASE( "cursor pool" ) {
+
+    {
+        auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+        pooled_table::create_module(*db, "pooled");
+    #if SQLITE_VERSION_NUMBER < SQLITEPP_SQLITE_VERSION(3, 9, 0)
+        db->exec("CREATE VIRTUAL TABLE temp.pooled USING pooled");
+    #endif
+
+        for (int i = 0; i < 5; ++i)
+            CHECK(collect(*db, "SELECT sum(x) FROM pooled") == "45\n");
+        CHECK(pooled_table::cursors_created == 1);
+        CHECK(pooled_table::cursors_destroyed == 0);
+
+        //more cursors open at once than the pool keeps
+        const char * join = "SELECT count(*) FROM pooled a, pooled b, pooled c WHERE a.x = b.x AND b.x = c.x";
+        CHECK(collect(*db, join) == "10\n");
+        CHECK(pooled_table::cursors_created == 3);
+        CHECK(pooled_table::cursors_destroyed == 1);
+        CHECK(collect(*db, join) == "10\n");
+        CHECK(pooled_table::cursors_created == 4);
+        CHECK(pooled_table::cursors_destroyed == 2);
+    }
+    CHECK(pooled_table::cursors_destroyed == pooled_table::cursors_created);
+}
+
+#if SQLITE_VERSION_NUMBER >= SQLITEPP_SQLITE_VERSION(3, 38, 0)
+
+TEST_CASE( "limit offset" ) {
+
+    sequence_table::state state;
+    state.size = 100;
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    sequence_table::create_module(*db, "seq", &state);
+
+    auto run = [&](const std::string & sql) {
+        state.produced = 0;
+        return collect(*db, sql);
+    };
+
+    CHECK(run("SELECT x FROM seq LIMIT 3 OFFSET 2") == "2\n3\n4\n");
+    CHECK(state.produced == 3);
+    CHECK(run("SELECT x FROM seq LIMIT 2, 3") == "2\n3\n4\n");
+    CHECK(state.produced == 3);
+    CHECK(run("SELECT x FROM seq ORDER BY x LIMIT 2") == "0\n1\n");
+    CHECK(state.produced == 2);
+    CHECK(run("SELECT x FROM seq LIMIT -1 OFFSET 98") == "98\n99\n");
+    CHECK(run("SELECT x FROM seq WHERE x = 5 LIMIT 1 OFFSET 1").empty());
+
+    //not forwarded: SQLite needs to see all the rows
+    CHECK(run("SELECT x FROM seq WHERE y = 1 LIMIT 2 OFFSET 1") == "4\n7\n");
+    CHECK(state.produced > 3);
+    CHECK(run("SELECT x FROM seq ORDER BY x DESC LIMIT 2") == "99\n98\n");
+    CHECK(state.produced == 100);
+
+    CHECK(run("SELECT x FROM seq WHERE x = 42") == "42\n");
+    REQUIRE(state.planned_value);
+    CHECK(*state.planned_value == 42);
+    auto stmt = statement::create(*db, "SELECT x FROM seq WHERE x = ?");
+    CHECK(!state.planned_value);
+    stmt->bind(1, 17);
+    REQUIRE(stmt->step());
+    CHECK(stmt->column_value<int64_t>(0) == 17);
+}
+
+#endif
+
+TEST_CASE( "error messages" ) {
+
+    auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+    failing_table::create_module(*db, "failing");
+    db->exec("DROP TABLE IF EXISTS bad; DROP TABLE IF EXISTS good");
+
+    try
+    {
+        db->exec("CREATE VIRTUAL TABLE bad USING failing(ctor)");
+        FAIL("no exception");
+    }
+    catch(thinsqlitepp::exception & ex)
+    {
+        CHECK(std::string_view(ex.what()).find("constructor failed") != std::string_view::npos);
+    }
+
+    db->exec("CREATE VIRTUAL TABLE good USING failing");
+    try
+    {
+        db->exec("SELECT * FROM good");
+        FAIL("no exception");
+    }
+    catch(thinsqlitepp::exception & ex)
+    {
+        CHECK(std::string_view(ex.what()).find("filter failed") != std::string_view::npos);
+    }
+    db->exec("DROP TABLE good");
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,138 @@
+#include <doctest.h>
+#include "mock_sqlite.hpp"
+
+#include <thinsqlitepp/write_queue.hpp>
+#include <thinsqlitepp/database.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace thinsqlitepp;
+
+TEST_SUITE_BEGIN("write_queue");
+
+namespace
+{
+    std::unique_ptr<database> open_db()
+    {
+        auto db = database::open("foo.db", SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX);
+        db->busy_timeout(5000);
+        return db;
+    }
+
+    int64_t count_rows(database & db)
+    {
+        auto stmt = statement::create(db, "SELECT count(*) FROM items");
+        stmt->step();
+        return stmt->column_value<int64_t>(0);
+    }
+
+    int64_t insert(database & db, int value)
+    {
+        auto stmt = statement::create(db, "INSERT INTO items(value) VALUES(?)");
+        stmt->bind(1, value);
+        stmt->step();
+        return db.last_insert_rowid();
+    }
+}
+
+TEST_CASE( "write_queue groups and isolates operations" ) {
+
+    auto reader = open_db();
+    reader->exec("DROP TABLE IF EXISTS items; CREATE TABLE items(id INTEGER PRIMARY KEY, value INTEGER)");
+
+    auto writer = open_db();
+    int commits = 0;
+    auto on_commit = [&]() noexcept {
+        ++commits;
+        return false;
+    };
+    writer->commit_hook(&on_commit);
+
+    write_queue queue(std::move(writer));
+
+    //hold the writer thread so that the following operations queue up
+    std::promise<void> gate;
+    auto first = queue.submit([opened = gate.get_future().share()](database & db) {
+        opened.wait();
+        return insert(db, 0);
+    });
+
+    std::vector<std::future<int64_t>> inserted;
+    for (int i = 1; i <= 20; ++i)
+        inserted.push_back(queue.submit([i](database & db) { return insert(db, i); }));
+    auto failed = queue.submit([](database & db) -> int {
+        insert(db, -1);
+        throw std::runtime_error("failed on purpose");
+    });
+    auto nothing_returned = queue.submit([](database & db) { insert(db, 100); });
+
+    gate.set_value();
+
+    CHECK(first.get() > 0);
+    for (auto & f: inserted)
+        CHECK(f.get() > 0);
+    CHECK_THROWS_AS(failed.get(), std::runtime_error);
+    nothing_returned.get();
+
+    CHECK(commits <= 2);
+    CHECK(count_rows(*reader) == 22);
+    auto stmt = statement::create(*reader, "SELECT count(*) FROM items WHERE value < 0");
+    stmt->step();
+    CHECK(stmt->column_value<int>(0) == 0);
+
+    queue.close();
+    CHECK_THROWS_AS(queue.submit([](database &) {}), thinsqlitepp::exception);
+}
+
+TEST_CASE( "write_queue from many threads" ) {
+
+    auto reader = open_db();
+    reader->exec("DROP TABLE IF EXISTS items; CREATE TABLE items(id INTEGER PRIMARY KEY, value INTEGER)");
+
+    {
+        write_queue queue(open_db(), 16);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t)
+        {
+            threads.emplace_back([&queue, t]() {
+                std::vector<std::future<int64_t>> results;
+                for (int i = 0; i < 50; ++i)
+                    results.push_back(queue.submit([value = t * 100 + i](database & db) { return insert(db, value); }));
+                for (auto & f: results)
+                    f.get();
+            });
+        }
+        for (auto & thread: threads)
+            thread.join();
+
+        //operations queued when the queue is destroyed are still completed
+        queue.submit([](database & db) { insert(db, 1000); });
+    }
+
+    CHECK(count_rows(*reader) == 401);
+}
+
+TEST_CASE( "write_queue commit failure" ) {
+
+    auto reader = open_db();
+    reader->exec("DROP TABLE IF EXISTS items; CREATE TABLE items(id INTEGER PRIMARY KEY, value INTEGER)");
+
+    auto writer = open_db();
+    writer->busy_timeout(0);
+    write_queue queue(std::move(writer));
+
+    //the writer cannot start its transaction while another connection holds the write lock
+    reader->exec("BEGIN IMMEDIATE");
+    auto blocked = queue.submit([](database & db) { return insert(db, 1); });
+    CHECK_THROWS_AS(blocked.get(), thinsqlitepp::exception);
+    reader->exec("COMMIT");
+
+    CHECK(queue.submit([](database & db) { return insert(db, 2); }).get() > 0);
+    CHECK(count_rows(*reader) == 1);
+}
+
+TEST_SUITE_END();